@@ -19,12 +19,17 @@ namespace demo_game {
     using pbr_vertex    = vertex_types::material_vertex_3d;
 
 
-    void game::pre_init(void)  {}
     void game::pre_loop(void)  {}
     void game::pre_exit(void)  {}
     void game::post_exit(void) {}
 
 
+    void game::pre_init(void) {
+        // A dedicated server has nothing to render, so it doesn't need a display or GPU.
+        if (engine::get_arguments().has("server") && !engine::get_arguments().has("client")) engine::set_headless(true);
+    }
+
+
     const game_info* game::get_info(void) {
         const static game_info info {
             .display_name = "Demo Game",
@@ -0,0 +1,275 @@
+#include <VoxelEngine/engine.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+#include <thread>
+
+
+// Headless multiplayer load test. Hosts a server and connects a number of simulated clients to it over loopback sockets,
+// then drives player movement and voxel edits on the server and reports how the server and the network hold up.
+// Usage: VELoadTest [--clients=N] [--duration=seconds] [--tick_rate=Hz] [--edits_per_tick=N] [--port=N]
+//                   [--latency=ms] [--jitter=ms] [--loss=fraction] [--bandwidth=bytes/s]
+namespace load_test {
+    using namespace ve::defs;
+
+
+    struct options {
+        std::size_t clients, edits_per_tick, edit_entities;
+        seconds duration;
+        nanoseconds tick_length;
+        u16 port;
+        ve::connection::network_conditions conditions;
+    };
+
+
+    // Stand-in for a tile being changed in the world. The timestamp is used to measure how long it takes for the edit to reach each client.
+    struct voxel_edit_component {
+        vec3i position;
+        u32 tile;
+        i64 timestamp;
+
+        ve_make_decomposable(voxel_edit_component, position, tile, timestamp);
+    };
+
+
+    // Arguments may be passed as either integers or floats.
+    double get_number(std::string_view name, double default_value) {
+        const auto& args = ve::engine::get_arguments();
+
+        if (auto i = args.get<i64>(name); i) return double(*i);
+        return args.value_or<double>(name, std::move(default_value));
+    }
+
+
+    options parse_options(void) {
+        auto ms = [] (double value) { return duration_cast<nanoseconds>(duration<double, std::milli> { value }); };
+
+        return options {
+            .clients        = (std::size_t) get_number("clients", 16),
+            .edits_per_tick = (std::size_t) get_number("edits_per_tick", 32),
+            .edit_entities  = 1024,
+            .duration       = seconds { (i64) get_number("duration", 10) },
+            .tick_length    = duration_cast<nanoseconds>(seconds { 1 }) / (i64) get_number("tick_rate", 20),
+            .port           = (u16) get_number("port", 12007),
+            .conditions     = ve::connection::network_conditions {
+                .latency   = ms(get_number("latency", 0)),
+                .jitter    = ms(get_number("jitter", 0)),
+                .loss      = (f32) get_number("loss", 0),
+                .bandwidth = (u64) get_number("bandwidth", 0)
+            }
+        };
+    }
+
+
+    template <typename T> T percentile(std::vector<T>& values, double p) {
+        if (values.empty()) return T { };
+
+        std::ranges::sort(values);
+        return values[std::min(values.size() - 1, (std::size_t) (p * double(values.size())))];
+    }
+
+
+    i64 timestamp_now(void) {
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+
+    void run(const options& opts) {
+        VE_LOG_INFO(ve::cat(
+            "Starting load test with ", opts.clients, " clients for ", opts.duration.count(), "s ",
+            "(latency ", duration_cast<milliseconds>(opts.conditions.latency).count(), "ms, ",
+            "jitter ", duration_cast<milliseconds>(opts.conditions.jitter).count(), "ms, ",
+            "loss ", opts.conditions.loss * 100.0f, "%, ",
+            "bandwidth ", opts.conditions.bandwidth, "B/s)."
+        ));
+
+
+        ve::server server;
+        ve::host_server(server, opts.port);
+
+        auto socket_server = server.get_object<ve::shared<ve::connection::socket_server>>("ve.connection");
+
+        auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+        server.add_system(ve::system_synchronizer<ve::meta::pack<ve::transform_component, voxel_edit_component>> { visibility_system });
+
+
+        std::vector<ve::unique<ve::client>> clients;
+        clients.reserve(opts.clients);
+
+        for (std::size_t i = 0; i < opts.clients; ++i) {
+            auto& client = clients.emplace_back(ve::make_unique<ve::client>());
+            ve::connect_remote(*client, "127.0.0.1", opts.port);
+        }
+
+
+        auto update_all = [&] (nanoseconds dt) {
+            server.update(dt);
+            for (auto& client : clients) client->update(dt);
+        };
+
+        auto connect_start = steady_clock::now();
+        while (socket_server->get_sessions().size() < opts.clients && ve::time_since(connect_start) < seconds { 30 }) {
+            update_all(opts.tick_length);
+        }
+
+        if (socket_server->get_sessions().size() < opts.clients) {
+            VE_LOG_ERROR(ve::cat("Only ", socket_server->get_sessions().size(), " of ", opts.clients, " clients connected."));
+            return;
+        }
+
+
+        // Conditions are applied in both directions, so round trips are affected twice.
+        for (const auto& [id, session] : socket_server->get_sessions()) session->set_network_conditions(opts.conditions);
+
+        for (auto& client : clients) {
+            client->get_object<ve::shared<ve::connection::socket_client>>("ve.connection")->get_session()->set_network_conditions(opts.conditions);
+        }
+
+
+        // Every client has a player entity that wanders around the world, and the world contains a set of tiles that are edited randomly.
+        std::vector<entt::entity> players, edits;
+
+        for (std::size_t i = 0; i < opts.clients; ++i) {
+            players.push_back(server.create_entity(ve::transform_component { }));
+        }
+
+        for (std::size_t i = 0; i < opts.edit_entities; ++i) {
+            edits.push_back(server.create_entity(voxel_edit_component { vec3i { 0 }, 0, timestamp_now() }));
+        }
+
+
+        // Timestamp of the last edit seen by each client for each edit entity, to detect when a new edit arrives.
+        std::vector<ve::hash_map<entt::entity, i64>> last_seen(opts.clients);
+
+        std::vector<nanoseconds> server_tick_times, sync_latencies;
+        u64 bytes_sent_start = 0, bytes_received_start = 0;
+
+        auto bytes_sent = [&] {
+            u64 result = 0;
+            for (const auto& [id, session] : socket_server->get_sessions()) result += session->get_num_bytes_written();
+            return result;
+        };
+
+        auto bytes_received = [&] {
+            u64 result = 0;
+            for (const auto& [id, session] : socket_server->get_sessions()) result += session->get_num_bytes_read();
+            return result;
+        };
+
+
+        // The first second is used as a warmup, so the initial synchronization of all entities is not included in the results.
+        const auto warmup_length = seconds { 1 };
+        const auto start         = steady_clock::now();
+        auto next_tick           = start;
+        bool measuring           = false;
+
+        while (ve::time_since(start) < opts.duration + warmup_length) {
+            if (!measuring && ve::time_since(start) >= warmup_length) {
+                measuring            = true;
+                bytes_sent_start     = bytes_sent();
+                bytes_received_start = bytes_received();
+            }
+
+
+            for (auto player : players) {
+                auto& transform = server.get_component<ve::transform_component>(player);
+                transform.position += vec3f { ve::cheaprand::random_real(-1.0f, 1.0f), 0.0f, ve::cheaprand::random_real(-1.0f, 1.0f) };
+            }
+
+            for (std::size_t i = 0; i < opts.edits_per_tick; ++i) {
+                auto entity = edits[ve::cheaprand::random_int<std::size_t>(0, edits.size() - 1)];
+
+                server.set_component(entity, voxel_edit_component {
+                    .position  = vec3i { ve::cheaprand::random_int(-256, 256), ve::cheaprand::random_int(0, 128), ve::cheaprand::random_int(-256, 256) },
+                    .tile      = ve::cheaprand::random_int<u32>(0, 255),
+                    .timestamp = timestamp_now()
+                });
+            }
+
+
+            const auto server_tick_start = steady_clock::now();
+            server.update(opts.tick_length);
+            const auto server_tick_time = ve::time_since(server_tick_start);
+
+            if (measuring) server_tick_times.push_back(server_tick_time);
+
+
+            for (auto [client, seen] : views::zip(clients, last_seen)) {
+                client->update(opts.tick_length);
+
+                for (auto [entity, edit] : client->view<voxel_edit_component>().each()) {
+                    auto& last = seen[entity];
+                    if (last == edit.timestamp) continue;
+
+                    last = edit.timestamp;
+                    if (measuring) sync_latencies.push_back(nanoseconds { timestamp_now() - edit.timestamp });
+                }
+            }
+
+
+            next_tick += opts.tick_length;
+            std::this_thread::sleep_until(next_tick);
+        }
+
+
+        const auto seconds_measured = duration<double> { opts.duration }.count();
+        const auto per_client = [&] (u64 bytes) { return double(bytes) / double(opts.clients) / seconds_measured; };
+        const auto as_us      = [] (nanoseconds ns) { return duration_cast<microseconds>(ns).count(); };
+        const auto as_ms      = [] (nanoseconds ns) { return duration<double, std::milli> { ns }.count(); };
+
+        VE_LOG_INFO(ve::cat(
+            "Load test results (", opts.clients, " clients, ", server_tick_times.size(), " ticks):\n",
+            "Server tick time: p50 ", as_us(percentile(server_tick_times, 0.50)), "us, ",
+            "p90 ", as_us(percentile(server_tick_times, 0.90)), "us, ",
+            "p99 ", as_us(percentile(server_tick_times, 0.99)), "us, ",
+            "max ", as_us(percentile(server_tick_times, 1.00)), "us.\n",
+            "Bytes per client per second: ", per_client(bytes_sent() - bytes_sent_start), " down, ",
+            per_client(bytes_received() - bytes_received_start), " up.\n",
+            "Sync latency (", sync_latencies.size(), " edits): p50 ", as_ms(percentile(sync_latencies, 0.50)), "ms, ",
+            "p90 ", as_ms(percentile(sync_latencies, 0.90)), "ms, ",
+            "p99 ", as_ms(percentile(sync_latencies, 0.99)), "ms, ",
+            "max ", as_ms(percentile(sync_latencies, 1.00)), "ms."
+        ));
+
+
+        for (auto& client : clients) ve::disconnect_remote(*client);
+        ve::stop_hosting_server(server);
+    }
+}
+
+
+namespace ve::game_callbacks {
+    void pre_init(void)  { engine::set_headless(true); }
+    void post_init(void) { }
+    void post_loop(void) { }
+    void pre_exit(void)  { }
+    void post_exit(void) { }
+
+
+    void pre_loop(void) {
+        load_test::run(load_test::parse_options());
+        engine::exit();
+    }
+
+
+    const game_info* get_info(void) {
+        const static game_info info {
+            .display_name = "VE Load Test",
+            .description  = { "Headless multiplayer load test." },
+            .authors      = { },
+            .version      = { 0, 0, 0 }
+        };
+
+        return &info;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    ve::engine::main(argc, argv);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/dependent/dependent_info.hpp>
+#include <VoxelEngine/utility/logger.hpp>
+#include <VoxelEngine/utility/string.hpp>
+#include <VoxelEngine/engine.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// Google Benchmark parses its own arguments, so they are stored here until the engine has finished initializing.
+static int    benchmark_argc = 0;
+static char** benchmark_argv = nullptr;
+
+
+namespace ve::game_callbacks {
+    void pre_init(void)  { }
+    void post_init(void) { }
+    void post_loop(void) { }
+    void pre_exit(void)  { }
+    void post_exit(void) { }
+
+
+    // Benchmarks are run after the engine has been initialized, so they have access to the tile registry, thread pool, etc.
+    void pre_loop(void) {
+        ::benchmark::Initialize(&benchmark_argc, benchmark_argv);
+        ::benchmark::RunSpecifiedBenchmarks();
+        ::benchmark::Shutdown();
+
+        engine::exit(EXIT_SUCCESS);
+    }
+
+
+    const game_info* get_info(void) {
+        const static game_info info {
+            .display_name = "VE Benchmark",
+            .description  = { },
+            .authors      = { },
+            .version      = { 0, 0, 0 }
+        };
+
+        return &info;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    benchmark_argc = argc;
+    benchmark_argv = argv;
+
+    ve::engine::main(argc, argv);
+}
\ No newline at end of file
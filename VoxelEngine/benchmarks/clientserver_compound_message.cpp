@@ -0,0 +1,61 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_compound.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t messages_per_compound = 5000;
+
+
+// Similar to set_component_message, which makes up the bulk of compound messages sent by the synchronizer.
+struct update_message {
+    std::vector<u8> data;
+    u64 type;
+    u32 entity;
+};
+
+
+// Encodes update messages into a compound message and sends it to a locally connected client, which decodes it.
+// Message is either compound_message or compound_message_v2.
+template <typename Message> static void BM_compound_message(benchmark::State& state, std::string_view msg_name) {
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    std::size_t received = 0;
+
+    client.get_server_connection()->add_handler(
+        "ve.benchmark.update_message",
+        [&] (const update_message& msg) { ++received; }
+    );
+
+
+    auto connection = server.get_connections().front();
+    Message msg;
+
+    for (auto _ : state) {
+        msg.clear();
+
+        for (u32 i = 0; i < messages_per_compound; ++i) {
+            msg.push_message("ve.benchmark.update_message", update_message { std::vector<u8>(40, u8(i)), 0xDEADBEEF, i }, connection.get());
+        }
+
+        connection->send_message(msg_name, msg);
+    }
+
+
+    benchmark::DoNotOptimize(received);
+
+    state.SetItemsProcessed(i64(state.iterations() * messages_per_compound));
+    state.counters["bytes_per_message"] = f64(msg.data.size()) / f64(messages_per_compound);
+}
+
+
+BENCHMARK_CAPTURE(BM_compound_message<ve::compound_message>, v1, ve::core_message_types::MSG_COMPOUND);
+BENCHMARK_CAPTURE(BM_compound_message<ve::compound_message_v2>, v2, ve::core_message_types::MSG_COMPOUND_V2);
\ No newline at end of file
@@ -0,0 +1,397 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/clientserver/socket/socket_client.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/utility/buffer_pool.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+namespace asio = ve::connection::asio;
+
+
+// Different from the ports used by the tests, so benchmarks can be run while the tests are running.
+constexpr u16 port = 12100;
+
+
+// Creates a message that compresses about as well as a typical serialized component update.
+static std::vector<u8> make_message(std::size_t size) {
+    std::vector<u8> result(size, 0x00);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result[i] = (i % 16 < 12) ? u8(i % 7) : (u8) ve::cheaprand::random_int(0, 255);
+    }
+
+    return result;
+}
+
+
+// Returns the compression threshold for the given benchmark argument: 0 never compresses, 1 is adaptive and 2 always compresses.
+static std::size_t get_compression_threshold(i64 mode) {
+    switch (mode) {
+        case 0:  return ve::max_value<std::size_t>;
+        case 1:  return ve::connection::default_compression_threshold;
+        default: return 0;
+    }
+}
+
+
+// Constructs a single-frame message in the wire format of socket_session, so remotes can be simulated with plain sockets.
+static std::vector<u8> make_frame(u64 value) {
+    auto message = ve::serialize::to_bytes(value);
+    message.push_back((u8) ve::connection::message_codec::RAW);
+
+    std::vector<u8> frame;
+    ve::serialize::encode_variable_length((u64(message.size()) << 3) | 1, frame);
+    std::reverse(frame.begin(), frame.end());
+
+    frame.insert(frame.end(), message.begin(), message.end());
+    return frame;
+}
+
+
+// Updates the given servers and clients until the condition is met. Returns false if the condition was not met within 30 seconds.
+static bool update_until(auto condition, auto&... instances) {
+    auto start = steady_clock::now();
+    while (!condition() && ve::time_since(start) < seconds(30)) (instances->update(), ...);
+
+    return condition();
+}
+
+
+// Sends small messages from the client to the server and waits for the server to echo them back.
+// range(0) selects the compression threshold (See get_compression_threshold).
+static void BM_socket_round_trip(benchmark::State& state) {
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    if (!update_until([&] { return !server->get_sessions().empty(); }, server, client)) {
+        state.SkipWithError("Client failed to connect to server.");
+        return;
+    }
+
+
+    auto server_session = server->get_sessions().begin()->second;
+    auto client_session = client->get_session();
+
+    server_session->set_compression_threshold(get_compression_threshold(state.range(0)));
+    client_session->set_compression_threshold(get_compression_threshold(state.range(0)));
+
+
+    const auto message = make_message(32);
+    std::size_t received = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) { server_session->write(e.message.get()); });
+    client->add_raw_handler([&] (const ve::connection::message_received_event& e) { ++received; });
+
+
+    for (auto _ : state) {
+        const auto expected = received + 1;
+        client_session->write(message);
+
+        if (!update_until([&] { return received == expected; }, server, client)) {
+            state.SkipWithError("Message was not echoed by the server.");
+            break;
+        }
+    }
+
+
+    client->stop();
+    server->stop();
+
+    state.SetItemsProcessed(i64(state.iterations()));
+}
+
+
+// Sends large messages from the client to the server.
+// range(0) selects the compression threshold (See get_compression_threshold).
+static void BM_socket_bulk_transfer(benchmark::State& state) {
+    constexpr std::size_t messages_per_iteration = 64;
+
+
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    if (!update_until([&] { return !server->get_sessions().empty(); }, server, client)) {
+        state.SkipWithError("Client failed to connect to server.");
+        return;
+    }
+
+
+    auto server_session = server->get_sessions().begin()->second;
+    auto client_session = client->get_session();
+
+    server_session->set_compression_threshold(get_compression_threshold(state.range(0)));
+    client_session->set_compression_threshold(get_compression_threshold(state.range(0)));
+
+
+    const auto message = make_message(16 * 1024);
+    std::size_t received = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) { ++received; });
+
+
+    for (auto _ : state) {
+        const auto expected = received + messages_per_iteration;
+        for (std::size_t i = 0; i < messages_per_iteration; ++i) client_session->write(message);
+
+        if (!update_until([&] { return received == expected; }, server, client)) {
+            state.SkipWithError("Not all messages were received by the server.");
+            break;
+        }
+    }
+
+
+    client->stop();
+    server->stop();
+
+    state.SetItemsProcessed(i64(state.iterations() * messages_per_iteration));
+    state.SetBytesProcessed(i64(state.iterations() * messages_per_iteration * message.size()));
+}
+
+
+// Sends a small input message from the client to the server while a bulk transfer is running on the same connection,
+// and measures the time until the input arrives. range(0) is whether the input is sent with a higher priority than the bulk data.
+static void BM_socket_input_latency(benchmark::State& state) {
+    constexpr std::size_t bulk_message_size  = 128 * 1024;
+    constexpr std::size_t max_bulk_in_flight = 16;
+
+    const bool prioritized    = (bool) state.range(0);
+    const auto input_priority = prioritized ? ve::message_priority::HIGH : ve::message_priority::NORMAL;
+    const auto bulk_priority  = prioritized ? ve::message_priority::BULK : ve::message_priority::NORMAL;
+
+
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    auto session = client->get_session();
+    // Chunk data is usually quite compressible, but measure the cost of sending it rather than that of compressing it.
+    session->set_compression_threshold(ve::max_value<std::size_t>);
+
+
+    std::vector<u8> bulk_message(bulk_message_size);
+    for (auto& byte : bulk_message) byte = (u8) ve::cheaprand::random_int(0, 255);
+
+    std::size_t inputs_received = 0, bulk_sent = 0, bulk_received = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.size() == bulk_message_size) ++bulk_received;
+        else ++inputs_received;
+    });
+
+
+    for (auto _ : state) {
+        const auto expected = inputs_received + 1;
+        const auto sent     = steady_clock::now();
+
+        session->write(std::vector<u8>(16, 0x00), input_priority);
+
+        // Keep the connection saturated with bulk data until the input arrives.
+        while (inputs_received < expected && ve::time_since(sent) < seconds(30)) {
+            while (bulk_sent - bulk_received < max_bulk_in_flight) {
+                session->write(bulk_message, bulk_priority);
+                ++bulk_sent;
+            }
+
+            client->update();
+            server->update();
+        }
+
+        if (inputs_received != expected) {
+            state.SkipWithError("Input message was not received by the server.");
+            break;
+        }
+
+        state.SetIterationTime(duration<f64> { steady_clock::now() - sent }.count());
+    }
+
+
+    client->stop();
+    server->stop();
+}
+
+
+// Sends messages of varying sizes from the client to the server after the buffer pool has been warmed up.
+// Received messages should reuse existing buffers, so there should be few allocations per message.
+static void BM_socket_receive(benchmark::State& state) {
+    constexpr std::size_t messages_per_iteration = 1024;
+
+
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    auto session = client->get_session();
+    // Only receive allocations are measured, so don't compress the messages.
+    session->set_compression_threshold(ve::max_value<std::size_t>);
+
+
+    std::size_t received = 0;
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) { ++received; });
+
+    auto send_and_wait = [&] {
+        const std::size_t expected = received + messages_per_iteration;
+        for (std::size_t i = 0; i < messages_per_iteration; ++i) session->write(std::vector<u8>(32 + (i % 64) * 16, u8(i)));
+
+        return update_until([&] { return received == expected; }, client, server);
+    };
+
+
+    if (!send_and_wait()) {
+        state.SkipWithError("Not all warmup messages were received by the server.");
+        return;
+    }
+
+    const u64 allocations_before = ve::buffer_pool::instance().get_num_allocations();
+
+    for (auto _ : state) {
+        if (!send_and_wait()) {
+            state.SkipWithError("Not all messages were received by the server.");
+            break;
+        }
+    }
+
+    const u64 allocations = ve::buffer_pool::instance().get_num_allocations() - allocations_before;
+
+
+    client->stop();
+    server->stop();
+
+    state.SetItemsProcessed(i64(state.iterations() * messages_per_iteration));
+    state.counters["allocations_per_message"] = f64(allocations) / f64(state.iterations() * messages_per_iteration);
+}
+
+
+// Sends many small messages per tick from the client to the server. Every iteration is a single tick.
+// range(0) is whether the session is flushed manually at the end of the tick rather than on every write.
+static void BM_socket_batched_writes(benchmark::State& state) {
+    constexpr std::size_t messages_per_tick = 200;
+
+
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+
+    auto session = client->get_session();
+    session->set_manual_flush((bool) state.range(0));
+
+    std::size_t received = 0;
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) { ++received; });
+
+
+    const u64 writes_before = session->get_num_writes();
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < messages_per_tick; ++i) session->write(std::vector<u8>(64, u8(i)));
+
+        client->update();
+        server->update();
+    }
+
+    const u64 writes = session->get_num_writes() - writes_before;
+
+
+    // Wait for the remaining messages, so they don't interfere with the next benchmark.
+    const auto expected = std::size_t(state.iterations()) * messages_per_tick;
+
+    if (!update_until([&] { return received == expected; }, server, client)) {
+        state.SkipWithError("Not all messages were received by the server.");
+    }
+
+    client->stop();
+    server->stop();
+
+
+    state.SetItemsProcessed(i64(state.iterations() * messages_per_tick));
+    state.counters["writes_per_tick"] = f64(writes) / f64(state.iterations());
+}
+
+
+// Measures the main thread cost of socket_server::update with a large number of sessions. Every iteration is a single tick.
+// range(0) is the number of messages received per session per tick.
+static void BM_socket_server_update(benchmark::State& state) {
+    constexpr std::size_t num_sessions = 500;
+    const auto messages_per_tick = (std::size_t) state.range(0);
+
+
+    auto server = ve::connection::socket_server::create(4);
+
+    // Messages are deserialized on the I/O threads, so the main thread only has to take the payload.
+    server->set_receive_hook([] (ve::connection::message_received_event& e) {
+        auto span = e.message.span();
+        e.payload = ve::serialize::from_bytes<u64>(span);
+    });
+
+    server->start(port);
+
+
+    asio::io_context ctx;
+    std::vector<asio::ip::tcp::socket> sockets;
+    sockets.reserve(num_sessions);
+
+    const auto endpoint = asio::ip::tcp::endpoint { asio::ip::make_address("127.0.0.1"), port };
+
+    for (std::size_t i = 0; i < num_sessions; ++i) {
+        sockets.emplace_back(ctx).connect(endpoint);
+    }
+
+    if (!update_until([&] { return server->get_sessions().size() == num_sessions; }, server)) {
+        state.SkipWithError("Not all sessions connected.");
+        return;
+    }
+
+
+    std::size_t received = 0;
+    u64 checksum = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        ++received;
+        checksum += std::any_cast<u64>(e.payload);
+    });
+
+
+    const auto frame = make_frame(1);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+
+        for (auto& socket : sockets) {
+            for (std::size_t i = 0; i < messages_per_tick; ++i) asio::write(socket, asio::buffer(frame));
+        }
+
+        state.ResumeTiming();
+
+        server->update();
+    }
+
+
+    benchmark::DoNotOptimize(checksum);
+
+    for (auto& socket : sockets) socket.close();
+    server->stop();
+
+    state.counters["messages_per_tick"] = f64(received) / f64(state.iterations());
+}
+
+
+BENCHMARK(BM_socket_round_trip)->DenseRange(0, 2)->UseRealTime();
+BENCHMARK(BM_socket_bulk_transfer)->DenseRange(0, 2)->UseRealTime();
+BENCHMARK(BM_socket_input_latency)->DenseRange(0, 1)->UseManualTime();
+BENCHMARK(BM_socket_receive)->UseRealTime();
+BENCHMARK(BM_socket_batched_writes)->DenseRange(0, 1)->UseRealTime();
+BENCHMARK(BM_socket_server_update)->Arg(0)->Arg(4)->UseRealTime();
\ No newline at end of file
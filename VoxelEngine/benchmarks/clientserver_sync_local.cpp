@@ -0,0 +1,78 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Same layout as transform_component, but with quantization hints for delta encoding.
+struct quantized_transform {
+    constexpr static f32 delta_vec3_precision = 1.0f / 1024.0f;
+    using delta_quantize_quaternions_tag = void;
+
+    vec3f position = vec3f { 0 };
+    vec3f scale    = vec3f { 1 };
+    quatf rotation = glm::identity<quatf>();
+};
+
+
+// Synchronizes moving entities to a locally connected client every tick.
+// range(0) is the number of entities and range(1) is whether delta encoding is used.
+template <typename Transform> static void BM_system_synchronizer_local(benchmark::State& state) {
+    const auto num_entities = (std::size_t) state.range(0);
+    const bool use_delta    = (bool) state.range(1);
+
+
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<Transform>> { visibility_system });
+
+    sync_system.template set_sync_rate<Transform>(0ns);
+    sync_system.template set_delta_encoding<Transform>(use_delta);
+
+
+    std::vector<entt::entity> entities;
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        entt::entity e = server.create_entity();
+        server.set_component(e, Transform { .position = vec3f { (f32) i, 0, 0 } });
+
+        entities.push_back(e);
+    }
+
+    // The first update sends every entity in full, which is not what we want to measure.
+    server.update(1ns);
+    client.update(1ns);
+
+
+    std::size_t bytes = 0;
+    client.get_server_connection()->add_handler(
+        ve::core_message_types::MSG_COMPOUND_V2,
+        [&] (const ve::compound_message_v2& msg) { bytes += msg.data.size(); }
+    );
+
+
+    for (auto _ : state) {
+        for (auto e : entities) server.template get_component<Transform>(e).position.y += 0.25f;
+
+        server.update(1ns);
+        client.update(1ns);
+    }
+
+
+    state.SetItemsProcessed(i64(state.iterations() * num_entities));
+    state.SetBytesProcessed(i64(bytes));
+    state.counters["bytes_per_entity"] = f64(bytes) / f64(state.iterations() * num_entities);
+}
+
+
+BENCHMARK_TEMPLATE(BM_system_synchronizer_local, ve::transform_component)->ArgsProduct({ { 16, 256, 4096 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_system_synchronizer_local, quantized_transform)->ArgsProduct({ { 16, 256, 4096 }, { 1 } });
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/ecs/ecs.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Entity with the same layout as the Howlees from the demo game.
+struct benchmark_howlee : public ve::static_entity {
+    struct benchmark_howlee_tag {
+        enum { NORMAL, BUILDER, EMISSIVE } type;
+    };
+
+
+    explicit benchmark_howlee(ve::registry& registry, f32 speed) : ve::static_entity(registry), speed(speed) {}
+    ve_rt_move_only(benchmark_howlee);
+
+
+    ve::transform_component VE_COMPONENT(transform) = ve::transform_component { };
+    ve::motion_component VE_COMPONENT(motion) = ve::motion_component { };
+    benchmark_howlee_tag VE_COMPONENT(tag) = benchmark_howlee_tag { .type = benchmark_howlee_tag::NORMAL };
+
+    f32 speed;
+    f32 distance_walked = 0.0f;
+    void* world = nullptr;
+};
+
+
+struct benchmark_component {
+    u64 value;
+};
+
+
+// Not trivially copyable, so it is stored element-by-element rather than as raw bytes.
+struct named_value_component {
+    std::string name;
+    i32 value;
+};
+
+
+// Creates entities with a transform, a third of which also have a named_value_component.
+static void fill_snapshot_registry(ve::registry& registry, std::size_t num_entities) {
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        auto entity = registry.create_entity();
+        registry.set_component(entity, ve::transform_component { .position = vec3f { (f32) i, 0, 0 } });
+
+        if (i % 3 == 0) registry.set_component(entity, named_value_component { ve::cat("entity ", i), (i32) i });
+    }
+}
+
+
+// Iterates over static entities stored in the registry's per-type pools. range(0) is the number of entities.
+static void BM_static_entity_iteration_pooled(benchmark::State& state) {
+    const auto num_entities = (std::size_t) state.range(0);
+
+    ve::registry registry;
+    for (std::size_t i = 0; i < num_entities; ++i) registry.store_static_entity(benchmark_howlee { registry, f32(i % 10) });
+
+
+    for (auto _ : state) {
+        registry.for_each_static_entity<benchmark_howlee>([&] (benchmark_howlee& e) { e.distance_walked += e.speed * 0.01f; });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_entities));
+}
+
+
+// Iterates over individually heap-allocated entities, as they were stored before static entities were pooled.
+// range(0) is the number of entities.
+static void BM_static_entity_iteration_heap(benchmark::State& state) {
+    const auto num_entities = (std::size_t) state.range(0);
+
+    ve::registry registry;
+    hash_map<entt::entity, unique<benchmark_howlee>> entities;
+
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        auto e = make_unique<benchmark_howlee>(registry, f32(i % 10));
+        entities.emplace(e->get_id(), std::move(e));
+    }
+
+
+    for (auto _ : state) {
+        for (auto& [id, e] : entities) e->distance_walked += e->speed * 0.01f;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_entities));
+}
+
+
+// Sets and removes a component on every entity, which dispatches component_created_event and component_destroyed_event.
+// range(0) is the number of handlers for component_created_event.
+static void BM_set_component(benchmark::State& state) {
+    constexpr std::size_t num_entities = 4096;
+
+
+    ve::registry registry;
+
+    std::vector<entt::entity> entities;
+    for (std::size_t i = 0; i < num_entities; ++i) entities.push_back(registry.create_entity());
+
+
+    u64 checksum = 0;
+    std::vector<ve::registry::handler_token> handlers;
+
+    for (i64 i = 0; i < state.range(0); ++i) {
+        handlers.push_back(registry.add_handler([&] (const ve::component_created_event<benchmark_component>& e) { checksum += e.component->value; }));
+    }
+
+
+    for (auto _ : state) {
+        for (auto entity : entities) registry.set_component(entity, benchmark_component { u64(entity) });
+        for (auto entity : entities) registry.remove_component<benchmark_component>(entity);
+    }
+
+
+    benchmark::DoNotOptimize(checksum);
+    state.SetItemsProcessed(i64(state.iterations() * num_entities));
+}
+
+
+// Takes a snapshot of the registry and serializes it. range(0) is the number of entities.
+static void BM_registry_take_snapshot(benchmark::State& state) {
+    ve::registry registry;
+    fill_snapshot_registry(registry, (std::size_t) state.range(0));
+
+    std::size_t bytes = 0;
+
+    for (auto _ : state) {
+        auto serialized = ve::serialize::to_bytes(registry.take_snapshot());
+
+        bytes = serialized.size();
+        benchmark::DoNotOptimize(serialized.data());
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * state.range(0)));
+    state.SetBytesProcessed(i64(state.iterations() * bytes));
+}
+
+
+// Deserializes a snapshot and restores it into an empty registry. range(0) is the number of entities.
+static void BM_registry_restore_snapshot(benchmark::State& state) {
+    ve::registry source;
+    fill_snapshot_registry(source, (std::size_t) state.range(0));
+
+    const auto bytes = ve::serialize::to_bytes(source.take_snapshot());
+
+    for (auto _ : state) {
+        ve::registry target;
+        target.restore_snapshot(ve::serialize::from_bytes<ve::registry_snapshot>(bytes));
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * state.range(0)));
+    state.SetBytesProcessed(i64(state.iterations() * bytes.size()));
+}
+
+
+BENCHMARK(BM_static_entity_iteration_pooled)->Range(1 << 10, 1 << 17);
+BENCHMARK(BM_static_entity_iteration_heap)->Range(1 << 10, 1 << 17);
+BENCHMARK(BM_set_component)->Arg(0)->Arg(1);
+
+BENCHMARK(BM_registry_take_snapshot)->Range(1 << 10, 1 << 14);
+BENCHMARK(BM_registry_restore_snapshot)->Range(1 << 10, 1 << 14);
\ No newline at end of file
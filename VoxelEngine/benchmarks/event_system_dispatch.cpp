@@ -0,0 +1,212 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/event/event_system.hpp>
+#include <VoxelEngine/voxel/space/events.hpp>
+
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_events = 1024;
+
+
+struct benchmark_event {
+    u64 value;
+};
+
+
+struct sequenced_event {
+    u32 producer;
+    u32 sequence;
+};
+
+
+// Voxel edits of a large bulk edit, e.g. an explosion.
+static std::vector<ve::voxel::voxel_changed_event> make_voxel_edits(std::size_t count) {
+    std::vector<ve::voxel::voxel_changed_event> events;
+    events.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        events.push_back(ve::voxel::voxel_changed_event {
+            .space     = nullptr,
+            .where     = ve::voxel::tilepos(i % 64, (i / 64) % 64, i / (64 * 64)),
+            .old_value = ve::voxel::tile_data { .tile_id = 0 },
+            .new_value = ve::voxel::tile_data { .tile_id = ve::voxel::tile_id_t(i) }
+        });
+    }
+
+    return events;
+}
+
+
+template <typename Dispatcher> static void add_benchmark_handlers(Dispatcher& d, std::size_t count, u64& sum) {
+    for (std::size_t i = 0; i < count; ++i) {
+        d.template add_raw_handler<benchmark_event>([&sum] (const benchmark_event& e) {
+            sum += e.value;
+            if constexpr (Dispatcher::is_cancellable) return false;
+        });
+    }
+}
+
+
+// Dispatches events one at a time. range(0) is the number of handlers.
+template <typename Dispatcher> static void BM_dispatch_event(benchmark::State& state) {
+    Dispatcher d;
+    u64 sum = 0;
+
+    add_benchmark_handlers(d, (std::size_t) state.range(0), sum);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < num_events; ++i) d.dispatch_event(benchmark_event { i });
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(i64(state.iterations() * num_events));
+}
+
+
+// Dispatches all events in a single call.
+template <typename Dispatcher> static void BM_dispatch_events(benchmark::State& state) {
+    Dispatcher d;
+    u64 sum = 0;
+
+    add_benchmark_handlers(d, (std::size_t) state.range(0), sum);
+
+    std::vector<benchmark_event> events;
+    for (std::size_t i = 0; i < num_events; ++i) events.push_back(benchmark_event { i });
+
+    for (auto _ : state) {
+        d.dispatch_events(std::span<const benchmark_event> { events });
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(i64(state.iterations() * num_events));
+}
+
+
+// Queues events with add_event and then dispatches them.
+template <typename Dispatcher> static void BM_delayed_dispatch(benchmark::State& state) {
+    Dispatcher d;
+    u64 sum = 0;
+
+    add_benchmark_handlers(d, (std::size_t) state.range(0), sum);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < num_events; ++i) d.add_event(benchmark_event { i });
+        d.dispatch_events();
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(i64(state.iterations() * num_events));
+}
+
+
+// Queues events with post_event and then dispatches them.
+template <typename Dispatcher> static void BM_delayed_post_dispatch(benchmark::State& state) {
+    Dispatcher d;
+    u64 sum = 0;
+
+    add_benchmark_handlers(d, (std::size_t) state.range(0), sum);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < num_events; ++i) d.post_event(benchmark_event { i });
+        d.dispatch_events();
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(i64(state.iterations() * num_events));
+}
+
+
+// Handles a bulk voxel edit with a handler that is invoked once per edit. range(0) is the number of edits.
+static void BM_voxel_edits_per_event(benchmark::State& state) {
+    const auto events = make_voxel_edits((std::size_t) state.range(0));
+
+    ve::simple_event_dispatcher<> d;
+    u64 checksum = 0;
+
+    auto handler = d.add_handler<ve::voxel::voxel_changed_event>([&] (const ve::voxel::voxel_changed_event& e) {
+        checksum += e.new_value.tile_id;
+    });
+
+    for (auto _ : state) {
+        for (const auto& e : events) d.dispatch_event(e);
+    }
+
+    benchmark::DoNotOptimize(checksum);
+    state.SetItemsProcessed(i64(state.iterations() * events.size()));
+}
+
+
+// Handles a bulk voxel edit with a batch handler that receives all edits at once. range(0) is the number of edits.
+static void BM_voxel_edits_batched(benchmark::State& state) {
+    const auto events = make_voxel_edits((std::size_t) state.range(0));
+
+    ve::simple_event_dispatcher<> d;
+    u64 checksum = 0;
+
+    auto handler = d.add_batch_handler<ve::voxel::voxel_changed_event>([&] (std::span<const ve::voxel::voxel_changed_event> batch) {
+        for (const auto& e : batch) checksum += e.new_value.tile_id;
+    });
+
+    for (auto _ : state) {
+        d.dispatch_events<ve::voxel::voxel_changed_event>(events);
+    }
+
+    benchmark::DoNotOptimize(checksum);
+    state.SetItemsProcessed(i64(state.iterations() * events.size()));
+}
+
+
+// Producers add events from their own threads while the main thread keeps dispatching them, similar to socket I/O threads.
+// If Post is true, events are added with post_event rather than add_event. range(0) is the number of producers.
+template <bool Post> static void BM_delayed_dispatch_producers(benchmark::State& state) {
+    constexpr u32 events_per_producer = 10'000;
+    const auto num_producers = (u32) state.range(0);
+
+
+    ve::delayed_event_dispatcher<true> d;
+    std::size_t received = 0;
+
+    auto handler = d.add_handler<sequenced_event>([&] (const sequenced_event& e) { ++received; });
+
+
+    for (auto _ : state) {
+        received = 0;
+
+        std::vector<std::thread> producers;
+        for (u32 i = 0; i < num_producers; ++i) {
+            producers.emplace_back([&, i] {
+                for (u32 j = 1; j <= events_per_producer; ++j) {
+                    if constexpr (Post) d.post_event(sequenced_event { i, j });
+                    else d.add_event(sequenced_event { i, j });
+                }
+            });
+        }
+
+        while (received < num_producers * events_per_producer) d.dispatch_events();
+        for (auto& producer : producers) producer.join();
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_producers * events_per_producer));
+}
+
+
+BENCHMARK_TEMPLATE(BM_dispatch_event, ve::simple_event_dispatcher<false, false, u16>)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_dispatch_event, ve::simple_event_dispatcher<true,  false, u16>)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_dispatch_event, ve::simple_event_dispatcher<false, true,  u16>)->Range(1, 64);
+
+BENCHMARK_TEMPLATE(BM_dispatch_events, ve::simple_event_dispatcher<false, false, u16>)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_dispatch_events, ve::simple_event_dispatcher<true,  false, u16>)->Range(1, 64);
+
+BENCHMARK_TEMPLATE(BM_delayed_dispatch, ve::delayed_event_dispatcher<false, false, u16>)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_delayed_dispatch, ve::delayed_event_dispatcher<true,  false, u16>)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_delayed_post_dispatch, ve::delayed_event_dispatcher<true, false, u16>)->Range(1, 64);
+
+BENCHMARK(BM_voxel_edits_per_event)->Range(1 << 10, 1 << 17);
+BENCHMARK(BM_voxel_edits_batched)->Range(1 << 10, 1 << 17);
+
+BENCHMARK_TEMPLATE(BM_delayed_dispatch_producers, false)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_delayed_dispatch_producers, true)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
\ No newline at end of file
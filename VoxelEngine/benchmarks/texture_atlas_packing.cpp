@@ -0,0 +1,55 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/graphics/presentation/window.hpp>
+#include <VoxelEngine/graphics/texture/aligned_texture_atlas.hpp>
+#include <VoxelEngine/utility/math.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Packing itself does not touch the GPU, but the atlas creates its texture on construction, which requires a graphics context.
+static void ensure_graphics_context(void) {
+    static auto window = ve::gfx::window::create(ve::gfx::window::arguments { .title = "Benchmark Window" });
+}
+
+
+// Fills an atlas with textures of mixed sizes and then removes them again.
+// range(0) is the size of the atlas. The atlas is filled to around 3/4 of its capacity, since packing slows down as the atlas fills up.
+static void BM_aligned_texture_atlas_packing(benchmark::State& state) {
+    ensure_graphics_context();
+
+    constexpr u32 alignment = 16;
+    const auto atlas_size   = (u32) state.range(0);
+
+    ve::gfx::aligned_texture_atlas atlas { "Benchmark Atlas", vec2ui { atlas_size }, alignment };
+
+
+    // Mostly single-block textures, with a few larger ones, similar to a typical set of tile textures.
+    std::vector<vec2ui> sizes;
+    u32 blocks_used = 0, blocks_total = ve::square(atlas_size / alignment);
+
+    for (u32 i = 0; blocks_used < (blocks_total * 3) / 4; ++i) {
+        const auto size = (i % 8 == 0) ? vec2ui { 2 * alignment } : vec2ui { alignment };
+
+        sizes.push_back(size);
+        blocks_used += (size.x / alignment) * (size.y / alignment);
+    }
+
+
+    std::vector<ve::gfx::subtexture> subtextures;
+    subtextures.reserve(sizes.size());
+
+    for (auto _ : state) {
+        for (const auto& size : sizes) subtextures.push_back(atlas.prepare_storage(size));
+        for (const auto& st : subtextures) atlas.remove(st);
+
+        subtextures.clear();
+    }
+
+
+    state.SetItemsProcessed(i64(state.iterations() * sizes.size()));
+}
+
+
+BENCHMARK(BM_aligned_texture_atlas_packing)->RangeMultiplier(2)->Range(256, 1024);
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/compression.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Random text from a small alphabet, which compresses reasonably well, similar to typical network messages.
+static std::vector<u8> make_input(std::size_t size) {
+    std::vector<u8> result;
+    result.reserve(size);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result.push_back((u8) ve::cheaprand::random_element("ABCDEFGHIJKLMNOPQRSTUVWXYZ "s));
+    }
+
+    return result;
+}
+
+
+static void BM_compress(benchmark::State& state) {
+    const auto mode  = (ve::compression_mode) state.range(1);
+    const auto input = make_input((std::size_t) state.range(0));
+
+    std::size_t compressed_size = 0;
+
+    for (auto _ : state) {
+        auto compressed = ve::compress(input, mode);
+        compressed_size = compressed.size();
+
+        benchmark::DoNotOptimize(compressed.data());
+    }
+
+    state.SetBytesProcessed(i64(state.iterations() * input.size()));
+    state.counters["ratio"] = f64(compressed_size) / f64(input.size());
+}
+
+
+static void BM_decompress(benchmark::State& state) {
+    const auto mode       = (ve::compression_mode) state.range(1);
+    const auto input      = make_input((std::size_t) state.range(0));
+    const auto compressed = ve::compress(input, mode);
+
+    for (auto _ : state) {
+        auto decompressed = ve::decompress(compressed);
+        benchmark::DoNotOptimize(decompressed.data());
+    }
+
+    state.SetBytesProcessed(i64(state.iterations() * input.size()));
+}
+
+
+static void compression_arguments(benchmark::internal::Benchmark* benchmark) {
+    for (auto mode : { ve::compression_mode::BEST_PERFORMANCE, ve::compression_mode::DEFAULT, ve::compression_mode::BEST_COMPRESSION }) {
+        for (i64 size : { 1 << 10, 1 << 16, 1 << 20 }) {
+            benchmark->Args({ size, (i64) mode });
+        }
+    }
+}
+
+
+BENCHMARK(BM_compress)->Apply(compression_arguments);
+BENCHMARK(BM_decompress)->Apply(compression_arguments);
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/voxel/chunk/chunk.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Members are all trivial, so this is serialized as a single block.
+struct fixed_layout_object {
+    i32 x, y, z;
+    float a, b, c;
+    std::array<u16, 8> data;
+};
+
+
+// Contains containers, so every member is serialized separately.
+struct dynamic_object {
+    i32 id;
+    std::string name;
+    std::vector<fixed_layout_object> children;
+    hash_map<std::string, i64> properties;
+};
+
+
+// Same layout as voxel_component::chunk_load_message.
+struct chunk_load_message {
+    ve::voxel::tilepos where;
+    typename ve::voxel::chunk::data_t data;
+};
+
+
+template <typename T> T make_object(std::size_t size);
+
+template <> fixed_layout_object make_object(std::size_t size) {
+    return fixed_layout_object { 1, 2, 3, 1.0f, 2.0f, 3.0f, { 1, 2, 3, 4, 5, 6, 7, 8 } };
+}
+
+template <> std::vector<fixed_layout_object> make_object(std::size_t size) {
+    return std::vector<fixed_layout_object>(size, make_object<fixed_layout_object>(0));
+}
+
+template <> ve::transform_component make_object(std::size_t size) {
+    return ve::transform_component { .position = vec3f { 1, 2, 3 } };
+}
+
+template <> chunk_load_message make_object(std::size_t size) {
+    return chunk_load_message { .where = ve::voxel::tilepos { 1, 2, 3 } };
+}
+
+template <> dynamic_object make_object(std::size_t size) {
+    dynamic_object result { .id = 1, .name = "Benchmark Object" };
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result.children.push_back(make_object<fixed_layout_object>(0));
+        result.properties.emplace(ve::cat("property_", i), i64(i));
+    }
+
+    return result;
+}
+
+
+template <typename T> static void BM_to_bytes(benchmark::State& state) {
+    const auto object = make_object<T>((std::size_t) state.range(0));
+    std::vector<u8> bytes;
+
+    for (auto _ : state) {
+        bytes.clear();
+        ve::serialize::to_bytes(object, bytes);
+
+        benchmark::DoNotOptimize(bytes.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(i64(state.iterations() * bytes.size()));
+}
+
+
+template <typename T> static void BM_from_bytes(benchmark::State& state) {
+    const auto bytes = ve::serialize::to_bytes(make_object<T>((std::size_t) state.range(0)));
+
+    for (auto _ : state) {
+        auto object = ve::serialize::from_bytes<T>(bytes);
+        benchmark::DoNotOptimize(object);
+    }
+
+    state.SetBytesProcessed(i64(state.iterations() * bytes.size()));
+}
+
+
+// Serializes and deserializes a fixed layout object, either as a single block or member by member, as it would be without the fixed layout fast path.
+template <typename T, bool Fixed> static void BM_fixed_layout_round_trip(benchmark::State& state) {
+    const auto object = make_object<T>(0);
+    std::vector<u8> bytes;
+
+    for (auto _ : state) {
+        bytes.clear();
+
+        if constexpr (Fixed) ve::serialize::fixed_layout_to_bytes(object, bytes);
+        else ve::serialize::decomposable_to_bytes(object, bytes);
+
+        std::span<const u8> span { bytes.begin(), bytes.end() };
+
+        if constexpr (Fixed) benchmark::DoNotOptimize(ve::serialize::fixed_layout_from_bytes<T>(span));
+        else benchmark::DoNotOptimize(ve::serialize::decomposable_from_bytes<T>(span));
+    }
+
+    state.SetBytesProcessed(i64(state.iterations() * bytes.size()));
+}
+
+
+BENCHMARK_TEMPLATE(BM_to_bytes, fixed_layout_object)->Arg(1);
+BENCHMARK_TEMPLATE(BM_to_bytes, std::vector<fixed_layout_object>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(BM_to_bytes, dynamic_object)->Range(8, 8 << 10);
+
+BENCHMARK_TEMPLATE(BM_from_bytes, fixed_layout_object)->Arg(1);
+BENCHMARK_TEMPLATE(BM_from_bytes, std::vector<fixed_layout_object>)->Range(8, 8 << 10);
+BENCHMARK_TEMPLATE(BM_from_bytes, dynamic_object)->Range(8, 8 << 10);
+
+BENCHMARK_TEMPLATE(BM_fixed_layout_round_trip, ve::transform_component, true);
+BENCHMARK_TEMPLATE(BM_fixed_layout_round_trip, ve::transform_component, false);
+BENCHMARK_TEMPLATE(BM_fixed_layout_round_trip, chunk_load_message, true);
+BENCHMARK_TEMPLATE(BM_fixed_layout_round_trip, chunk_load_message, false);
\ No newline at end of file
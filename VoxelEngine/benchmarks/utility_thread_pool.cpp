@@ -0,0 +1,88 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/thread/thread_pool.hpp>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+#include <VoxelEngine/core/windows_header_cleanup.hpp>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t jobs_per_iteration = 1024;
+
+
+// The job system is compared against a boost::asio::thread_pool configured the way the engine's thread pool used to be.
+static boost::asio::thread_pool& get_asio_pool(void) {
+    static boost::asio::thread_pool pool { std::max(32u, std::thread::hardware_concurrency()) };
+    return pool;
+}
+
+
+// Submits many tiny jobs from outside the pool and waits for all of them to complete.
+static void BM_thread_pool_throughput(benchmark::State& state) {
+    auto& pool = ve::thread_pool::instance();
+    std::atomic<std::size_t> counter = 0;
+
+    for (auto _ : state) {
+        counter = 0;
+
+        for (std::size_t i = 0; i < jobs_per_iteration; ++i) {
+            pool.invoke_on_thread([&] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        pool.help_until([&] { return counter.load() == jobs_per_iteration; });
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * jobs_per_iteration));
+}
+
+
+static void BM_asio_thread_pool_throughput(benchmark::State& state) {
+    auto& pool = get_asio_pool();
+    std::atomic<std::size_t> counter = 0;
+
+    for (auto _ : state) {
+        counter = 0;
+
+        for (std::size_t i = 0; i < jobs_per_iteration; ++i) {
+            boost::asio::post(pool, [&] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        while (counter.load() != jobs_per_iteration) std::this_thread::yield();
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * jobs_per_iteration));
+}
+
+
+// Measures the time from submitting a job until it starts executing, while the pool is otherwise idle.
+// The submitting thread waits without helping, so the job is executed by a worker.
+template <typename Submit> static void measure_latency(benchmark::State& state, Submit submit) {
+    for (auto _ : state) {
+        std::atomic<steady_clock::time_point> started;
+        std::atomic_bool done = false;
+
+        const auto submitted = steady_clock::now();
+        submit([&] { started = steady_clock::now(); done = true; });
+
+        while (!done) std::this_thread::yield();
+        state.SetIterationTime(duration<f64> { started.load() - submitted }.count());
+    }
+}
+
+
+static void BM_thread_pool_latency(benchmark::State& state) {
+    measure_latency(state, [] (auto job) { ve::thread_pool::instance().invoke_on_thread(std::move(job)); });
+}
+
+
+static void BM_asio_thread_pool_latency(benchmark::State& state) {
+    measure_latency(state, [] (auto job) { boost::asio::post(get_asio_pool(), std::move(job)); });
+}
+
+
+BENCHMARK(BM_thread_pool_throughput)->UseRealTime();
+BENCHMARK(BM_asio_thread_pool_throughput)->UseRealTime();
+
+BENCHMARK(BM_thread_pool_latency)->UseManualTime();
+BENCHMARK(BM_asio_thread_pool_latency)->UseManualTime();
\ No newline at end of file
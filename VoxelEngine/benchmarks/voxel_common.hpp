@@ -0,0 +1,88 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/voxel/chunk/generator/world_layers.hpp>
+#include <VoxelEngine/voxel/tile/tiles.hpp>
+#include <VoxelEngine/voxel/tile/tile.hpp>
+#include <VoxelEngine/voxel/tile/tile_registry.hpp>
+#include <VoxelEngine/utility/cube.hpp>
+
+using namespace ve::defs;
+
+
+// Tile with the same geometry as a normal tile, but without any textures,
+// so meshing does not depend on the texture manager or a graphics context.
+class benchmark_tile : public ve::voxel::tile {
+public:
+    using tile::tile;
+
+
+    void append_mesh(ve::voxel::tile_mesh& dest, u8 visible_sides, ve::voxel::tile_metadata_t meta) const override {
+        static const ve::gfx::subtexture no_texture { };
+
+        u32 rendered_directions = 0;
+        for (ve::direction_t direction = 0; direction < (ve::direction_t) ve::directions.size(); ++direction) {
+            if (!(visible_sides & (1 << direction))) continue;
+
+            const auto& face_data = ve::cube_face_data[direction];
+
+            auto vertices = ve::create_filled_array<4>([&] (std::size_t i) {
+                return ve::voxel::voxel_settings::assemble_vertex(ve::voxel::vertex_assembler_arguments {
+                    .tile             = this,
+                    .color_texture    = no_texture,
+                    .normal_texture   = no_texture,
+                    .material_texture = no_texture,
+                    .position         = face_data.positions[i],
+                    .normal           = face_data.normal,
+                    .tangent          = face_data.tangent,
+                    .uv               = face_data.uvs[i]
+                });
+            });
+
+
+            if constexpr (ve::voxel::tile_mesh::indexed) {
+                dest.vertices.insert(dest.vertices.end(), vertices.begin(), vertices.end());
+
+                auto indices = ve::cube_index_pattern;
+                for (auto& index : indices) index += (4 * rendered_directions);
+
+                dest.indices.insert(dest.indices.end(), indices.begin(), indices.end());
+            } else {
+                for (u32 i : ve::cube_index_pattern) dest.vertices.push_back(vertices[i]);
+            }
+
+
+            ++rendered_directions;
+        }
+    }
+};
+
+
+// Tiles are registered in the global tile registry, since that is what the generators and the mesher use.
+inline const std::array<ve::unique<benchmark_tile>, 3>& get_benchmark_tiles(void) {
+    static const auto tiles = [] {
+        std::array<ve::unique<benchmark_tile>, 3> result {
+            ve::make_unique<benchmark_tile>(ve::voxel::tile::arguments { .name = "benchmark_stone" }),
+            ve::make_unique<benchmark_tile>(ve::voxel::tile::arguments { .name = "benchmark_dirt" }),
+            ve::make_unique<benchmark_tile>(ve::voxel::tile::arguments { .name = "benchmark_grass" })
+        };
+
+        for (const auto& tile : result) ve::voxel::voxel_settings::get_tile_registry().register_tile(tile.get());
+        return result;
+    }();
+
+    return tiles;
+}
+
+
+inline ve::voxel::world_layers get_benchmark_layers(void) {
+    const auto& tiles = get_benchmark_tiles();
+    ve::voxel::world_layers result;
+
+    result.set_sky(ve::voxel::tiles::TILE_AIR);
+    result.add_layer(-4, tiles[0].get());
+    result.add_layer(-1, tiles[1].get());
+    result.add_layer(0,  tiles[2].get());
+
+    return result;
+}
\ No newline at end of file
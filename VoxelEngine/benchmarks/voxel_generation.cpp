@@ -0,0 +1,48 @@
+#include <VoxelEngine/benchmarks/voxel_common.hpp>
+#include <VoxelEngine/voxel/chunk/generator/generator.hpp>
+#include <VoxelEngine/voxel/chunk/generator/noise_generator.hpp>
+#include <VoxelEngine/utility/noise.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// Generates chunks from a column around the surface, so both the layers and the sky are generated.
+template <typename Generator> static void run_generator(benchmark::State& state, Generator& generator) {
+    i32 x = 0;
+
+    for (auto _ : state) {
+        for (i32 y = -1; y <= 1; ++y) {
+            auto chunk = generator.generate(nullptr, ve::voxel::tilepos { x, y, 0 });
+            benchmark::DoNotOptimize(chunk.get());
+        }
+
+        ++x;
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * 3));
+}
+
+
+static void BM_flatland_generator(benchmark::State& state) {
+    ve::voxel::flatland_generator generator { get_benchmark_layers() };
+    run_generator(state, generator);
+}
+
+
+static void BM_simple_noise_generator(benchmark::State& state) {
+    ve::voxel::simple_noise_generator generator {
+        ve::voxel::simple_noise_generator::arguments {
+            .heightmap = ve::noise::create<FastNoise::Simplex>(),
+            .layers    = get_benchmark_layers(),
+            .seed      = 12345
+        }
+    };
+
+    run_generator(state, generator);
+}
+
+
+BENCHMARK(BM_flatland_generator);
+BENCHMARK(BM_simple_noise_generator);
\ No newline at end of file
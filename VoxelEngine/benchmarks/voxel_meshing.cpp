@@ -0,0 +1,95 @@
+#include <VoxelEngine/benchmarks/voxel_common.hpp>
+#include <VoxelEngine/voxel/chunk/chunk_mesher.hpp>
+#include <VoxelEngine/voxel/chunk/generator/noise_generator.hpp>
+#include <VoxelEngine/utility/noise.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+// A chunk and its neighbours, which are kept alive for the duration of the benchmark.
+struct neighbourhood_fixture {
+    ve::unique<ve::voxel::chunk> chunk;
+    std::array<ve::unique<ve::voxel::chunk>, ve::directions.size()> neighbours;
+
+
+    ve::voxel::chunk_neighbourhood get(void) const {
+        ve::voxel::chunk_neighbourhood result { .chunk = chunk.get() };
+        for (std::size_t i = 0; i < neighbours.size(); ++i) result.neighbours[i] = neighbours[i].get();
+
+        return result;
+    }
+};
+
+
+// Surface terrain, which is the most common case when meshing chunks.
+static neighbourhood_fixture make_terrain_neighbourhood(void) {
+    ve::voxel::simple_noise_generator generator {
+        ve::voxel::simple_noise_generator::arguments {
+            .heightmap    = ve::noise::create<FastNoise::Simplex>(),
+            .layers       = get_benchmark_layers(),
+            .seed         = 12345,
+            .height_scale = 16.0f
+        }
+    };
+
+    neighbourhood_fixture result;
+    result.chunk = generator.generate(nullptr, ve::voxel::tilepos { 0 });
+
+    for (std::size_t i = 0; i < ve::directions.size(); ++i) {
+        result.neighbours[i] = generator.generate(nullptr, ve::directions[i]);
+    }
+
+    return result;
+}
+
+
+// Alternating solid and empty tiles, which is the worst case, since every face of every solid tile is visible.
+static neighbourhood_fixture make_checkerboard_neighbourhood(void) {
+    const auto solid = ve::voxel::voxel_settings::get_tile_registry().get_default_state(get_benchmark_tiles()[0].get());
+    const auto empty = ve::voxel::voxel_settings::get_tile_registry().get_default_state(ve::voxel::tiles::TILE_AIR);
+
+    auto make_chunk = [&] {
+        auto chunk = ve::make_unique<ve::voxel::chunk>();
+
+        for (i32 x = 0; x < (i32) ve::voxel::voxel_settings::chunk_size; ++x) {
+            for (i32 y = 0; y < (i32) ve::voxel::voxel_settings::chunk_size; ++y) {
+                for (i32 z = 0; z < (i32) ve::voxel::voxel_settings::chunk_size; ++z) {
+                    chunk->set_data(ve::voxel::tilepos { x, y, z }, (x + y + z) % 2 == 0 ? solid : empty);
+                }
+            }
+        }
+
+        return chunk;
+    };
+
+
+    neighbourhood_fixture result;
+    result.chunk = make_chunk();
+    for (auto& neighbour : result.neighbours) neighbour = make_chunk();
+
+    return result;
+}
+
+
+template <auto MakeNeighbourhood> static void BM_mesh_chunk(benchmark::State& state) {
+    const auto fixture = MakeNeighbourhood();
+    const auto neighbourhood = fixture.get();
+
+    std::size_t num_vertices = 0;
+
+    for (auto _ : state) {
+        auto mesh = ve::voxel::mesh_chunk(neighbourhood, ve::voxel::tilepos { 0 });
+        num_vertices = mesh.vertices.size();
+
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+
+    state.SetItemsProcessed(i64(state.iterations()));
+    state.counters["vertices"] = f64(num_vertices);
+}
+
+
+BENCHMARK_TEMPLATE(BM_mesh_chunk, make_terrain_neighbourhood);
+BENCHMARK_TEMPLATE(BM_mesh_chunk, make_checkerboard_neighbourhood);
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/voxel/tile/tile_registry.hpp>
+#include <VoxelEngine/voxel/tile/tile.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_lookups = 1 << 12;
+
+
+// Registry filled with a mix of stateless tiles, which share tile IDs, and tiles with multiple states.
+struct registry_fixture {
+    ve::voxel::tile_registry registry;
+    std::vector<ve::unique<ve::voxel::tile>> tiles;
+
+    std::vector<ve::voxel::tile_data> states;
+    std::vector<std::pair<const ve::voxel::tile*, ve::voxel::tile_metadata_t>> tiles_and_meta;
+
+
+    explicit registry_fixture(std::size_t num_tiles) {
+        for (std::size_t i = 0; i < num_tiles; ++i) {
+            tiles.emplace_back(ve::make_unique<ve::voxel::tile>(ve::voxel::tile::arguments {
+                .name       = ve::cat("tile_", i),
+                .num_states = ve::voxel::tile_metadata_t(i % 4 == 0 ? 16 : 1)
+            }));
+
+            registry.register_tile(tiles.back().get());
+        }
+
+
+        // Look up tiles in a random order, so the benchmark isn't just measuring a predictable access pattern.
+        for (std::size_t i = 0; i < num_lookups; ++i) {
+            const auto* tile = ve::cheaprand::random_element(tiles).get();
+            auto meta = ve::voxel::tile_metadata_t(ve::cheaprand::random_int(0, tile->get_num_states() - 1));
+
+            tiles_and_meta.emplace_back(tile, meta);
+            states.push_back(registry.get_state(tile, meta));
+        }
+    }
+};
+
+
+static void BM_tile_registry_get_tile_for_state(benchmark::State& state) {
+    registry_fixture fixture { (std::size_t) state.range(0) };
+
+    for (auto _ : state) {
+        for (const auto& td : fixture.states) benchmark::DoNotOptimize(fixture.registry.get_tile_for_state(td));
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_lookups));
+}
+
+
+static void BM_tile_registry_get_effective_metastate(benchmark::State& state) {
+    registry_fixture fixture { (std::size_t) state.range(0) };
+
+    for (auto _ : state) {
+        for (const auto& td : fixture.states) benchmark::DoNotOptimize(fixture.registry.get_effective_metastate(td));
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_lookups));
+}
+
+
+static void BM_tile_registry_get_state(benchmark::State& state) {
+    registry_fixture fixture { (std::size_t) state.range(0) };
+
+    for (auto _ : state) {
+        for (const auto& [tile, meta] : fixture.tiles_and_meta) benchmark::DoNotOptimize(fixture.registry.get_state(tile, meta));
+    }
+
+    state.SetItemsProcessed(i64(state.iterations() * num_lookups));
+}
+
+
+BENCHMARK(BM_tile_registry_get_tile_for_state)->Range(16, 4096);
+BENCHMARK(BM_tile_registry_get_effective_metastate)->Range(16, 4096);
+BENCHMARK(BM_tile_registry_get_state)->Range(16, 4096);
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <VoxelEngine/clientserver/core_messages/msg_ignore_this.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_partial_sync.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_set_component.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_set_component_delta.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_sync_mtr.hpp>
 #include <VoxelEngine/clientserver/instance.hpp>
 #include <VoxelEngine/clientserver/instance_events.hpp>
@@ -27,3 +28,4 @@
 #include <VoxelEngine/clientserver/socket/socket_client.hpp>
 #include <VoxelEngine/clientserver/socket/socket_server.hpp>
 #include <VoxelEngine/clientserver/socket/socket_session.hpp>
+#include <VoxelEngine/clientserver/socket/udp_channel.hpp>
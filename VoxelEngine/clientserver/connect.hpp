@@ -9,6 +9,7 @@
 #include <VoxelEngine/clientserver/socket/socket_client.hpp>
 #include <VoxelEngine/clientserver/socket/socket_server.hpp>
 #include <VoxelEngine/clientserver/socket/socket_session.hpp>
+#include <VoxelEngine/clientserver/socket/udp_channel.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_ignore_this.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
 
@@ -48,28 +49,37 @@ namespace ve {
 
 
     // Connect a local client to a remote server.
+    // Besides the TCP connection, a UDP channel is bound to the server for messages sent with message_channel::UNRELIABLE_LATEST.
     inline void connect_remote(client& c, std::string_view address, u16 port) {
         auto& connection = c.store_object(
             "ve.connection",
             connection::socket_client::create()
         );
 
+        auto& channel = c.store_object(
+            "ve.connection.udp",
+            connection::udp_channel::create(c.get_id())
+        );
+
         // Connection will dispatch events after every tick of the client.
         c.store_object(
             "ve.connection.connection_update_handler",
-            c.add_raw_handler([connection] (const instance_post_tick_event& e) {
+            c.add_raw_handler([connection, channel] (const instance_post_tick_event& e) {
                 connection->update();
+                channel->update();
             })
         );
 
 
-        // Once we receive the remote's ID, create the connection.
+        // Once we receive the remote's ID and the secret for binding to its UDP channel, create the connection and bind the channel.
         // This will occur after this method has exited, but the client is immovable, so taking its address shouldn't be an issue.
-        connection->add_one_time_raw_handler([connection, &c] (const connection::message_received_event& e) {
-            auto span      = make_message_unignored(e.message);
-            auto remote_id = serialize::from_bytes<instance_id>(span);
+        connection->add_one_time_raw_handler([connection, channel, &c, address = std::string { address }, port] (const connection::message_received_event& e) {
+            auto span        = make_message_unignored(e.message);
+            auto bind_secret = serialize::from_bytes<u64>(span);
+            auto remote_id   = serialize::from_bytes<instance_id>(span);
 
-            c.set_server_connection(make_shared<remote_message_handler>(c, remote_id, connection->get_session()));
+            channel->start(remote_id, address, port, bind_secret);
+            c.set_server_connection(make_shared<remote_message_handler>(c, remote_id, connection->get_session(), channel));
         });
 
 
@@ -89,38 +99,49 @@ namespace ve {
     inline void disconnect_remote(client& c) {
         auto update_handler = c.take_object<event_handler_id_t>("ve.connection.connection_update_handler");
         auto connection     = c.take_object<shared<connection::socket_client>>("ve.connection");
+        auto channel        = c.take_object<shared<connection::udp_channel>>("ve.connection.udp");
 
         c.remove_handler<instance_post_tick_event>(update_handler);
         c.remove_server_connection();
 
         connection->stop();
+        channel->stop();
     }
 
 
 
 
     // Set up the server to accept connections from remote clients.
+    // Clients can also bind to a UDP channel on the same port, which is used for messages sent with message_channel::UNRELIABLE_LATEST.
     inline void host_server(server& s, u16 port, std::size_t num_threads = 32) {
         auto connection = s.store_object(
             "ve.connection",
             connection::socket_server::create(num_threads)
         );
 
+        auto channel = s.store_object(
+            "ve.connection.udp",
+            connection::udp_channel::create(s.get_id())
+        );
+
         // Connection will dispatch events after every tick of the server.
         s.store_object(
             "ve.connection.connection_update_handler",
-            s.add_raw_handler([connection] (const instance_post_tick_event& e) {
+            s.add_raw_handler([connection, channel] (const instance_post_tick_event& e) {
                 connection->update();
+                channel->update();
             })
         );
 
 
         // When a connection is made, send out our ID and wait for the remote to do the same.
         // After this has been done, the message handler can be created.
-        connection->add_raw_handler([connection, &s] (const connection::session_start_event& e) {
-            auto session = connection->get_session(e.session);
+        // Every session also gets its own secret for binding to the UDP channel, so other hosts can't bind in place of the client.
+        connection->add_raw_handler([connection, channel, &s] (const connection::session_start_event& e) {
+            auto session     = connection->get_session(e.session);
+            auto bind_secret = connection::udp_channel::create_bind_secret();
 
-            session->add_one_time_raw_handler([session, &s] (const connection::message_received_event& e) mutable {
+            session->add_one_time_raw_handler([session, channel, bind_secret, &s] (const connection::message_received_event& e) mutable {
                 auto span      = make_message_unignored(e.message);
                 auto remote_id = serialize::from_bytes<instance_id>(span);
 
@@ -128,11 +149,14 @@ namespace ve {
                     s.remove_client_connection(remote_id);
                 });
 
-                s.add_client_connection(make_shared<remote_message_handler>(s, remote_id, std::move(session)));
+                // Only clients which have identified themselves over TCP may bind to the UDP channel.
+                channel->expect_peer(remote_id, bind_secret);
+                s.add_client_connection(make_shared<remote_message_handler>(s, remote_id, std::move(session), channel));
             });
 
 
             auto id_buffer = serialize::to_bytes(s.get_id());
+            serialize::to_bytes(bind_secret, id_buffer);
             make_message_ignored(id_buffer);
 
             session->write(std::move(id_buffer));
@@ -140,6 +164,7 @@ namespace ve {
 
 
         connection->start(port);
+        channel->start(port);
     }
 
 
@@ -149,10 +174,12 @@ namespace ve {
     inline void stop_hosting_server(server& s) {
         auto update_handler = s.take_object<event_handler_id_t>("ve.connection.connection_update_handler");
         auto connection     = s.take_object<shared<connection::socket_server>>("ve.connection");
+        auto channel        = s.take_object<shared<connection::udp_channel>>("ve.connection.udp");
 
         s.remove_handler<instance_post_tick_event>(update_handler);
         s.clear_client_connections();
 
         connection->stop();
+        channel->stop();
     }
 }
\ No newline at end of file
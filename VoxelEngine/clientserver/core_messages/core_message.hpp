@@ -11,9 +11,12 @@ namespace ve {
         constexpr std::string_view MSG_SYNC_MTR          = "ve.sync_mtr";
         constexpr std::string_view MSG_IGNORE_THIS       = "ve.ignore_this";
         constexpr std::string_view MSG_COMPOUND          = "ve.compound";
+        constexpr std::string_view MSG_COMPOUND_V2       = "ve.compound_v2";
         constexpr std::string_view MSG_ADD_ENTITY        = "ve.ecs.add_entity";
         constexpr std::string_view MSG_DEL_ENTITY        = "ve.ecs.del_entity";
         constexpr std::string_view MSG_SET_COMPONENT     = "ve.ecs.set_component";
+        constexpr std::string_view MSG_DELTA_COMPONENT   = "ve.ecs.delta_set_component";
+        constexpr std::string_view MSG_RESEND_COMPONENT  = "ve.ecs.resend_component";
         constexpr std::string_view MSG_UNDO_COMPONENT    = "ve.ecs.undo_set_component";
         constexpr std::string_view MSG_DEL_COMPONENT     = "ve.ecs.del_component";
         constexpr std::string_view MSG_PARTIAL_SYNC      = "ve.ecs.partial_sync";
@@ -37,5 +40,11 @@ namespace ve {
 
         std::function<void(client&, message_handler&, const type&)> on_received_client = nullptr;
         std::function<void(server&, message_handler&, const type&)> on_received_server = nullptr;
+
+        // Optional alternative to on_received_*, which receives the serialized message, to avoid deserializing messages that can be parsed in place.
+        // If set, it is used instead of the corresponding on_received_* method for serialized messages.
+        // Messages passed directly from a local connection still go to on_received_*, if it is set, so they are not serialized just to be parsed again.
+        std::function<void(client&, message_handler&, std::span<const u8>)> on_view_received_client = nullptr;
+        std::function<void(server&, message_handler&, std::span<const u8>)> on_view_received_server = nullptr;
     };
 }
\ No newline at end of file
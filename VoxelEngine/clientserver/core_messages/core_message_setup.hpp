@@ -16,6 +16,7 @@
 #include <VoxelEngine/clientserver/core_messages/msg_compound.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_add_del_entity.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_set_component.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_set_component_delta.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_del_component.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_partial_sync.hpp>
 
@@ -30,7 +31,10 @@ namespace ve {
         msg_set_component,
         msg_del_component,
         msg_undo_set_component,
-        msg_partial_sync
+        msg_partial_sync,
+        msg_set_component_delta,
+        msg_compound_v2,
+        msg_resend_component
     };
 
 
@@ -95,7 +99,25 @@ namespace ve {
                     info.on_received_server
                 );
 
-                if (fn && (info.direction & direction)) {
+                const auto& view_fn = meta::pick<std::is_same_v<Instance, client>>(
+                    info.on_view_received_client,
+                    info.on_view_received_server
+                );
+
+                if (!(info.direction & direction)) return;
+
+                // Messages passed directly from a local connection are handled without serializing them, even if the message supports views.
+                if (view_fn && fn) {
+                    handler.template add_dual_handler<typename Info::type>(
+                        info.name,
+                        [&] (const typename Info::type& msg) { fn(owner, handler, msg); },
+                        [&] (std::span<const u8> msg) { view_fn(owner, handler, msg); }
+                    );
+                } else if (view_fn) {
+                    handler.template add_view_handler<typename Info::type>(info.name, [&] (std::span<const u8> msg) {
+                        view_fn(owner, handler, msg);
+                    });
+                } else if (fn) {
                     handler.add_handler(info.name, [&] (const typename Info::type& msg) {
                         fn(owner, handler, msg);
                     });
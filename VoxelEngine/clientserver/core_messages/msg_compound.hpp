@@ -3,22 +3,21 @@
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/clientserver/core_messages/core_message.hpp>
 #include <VoxelEngine/clientserver/message_type_registry.hpp>
+#include <VoxelEngine/clientserver/message_priority.hpp>
+#include <VoxelEngine/utility/decompose.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
 
 #include <ctti/nameof.hpp>
 
 
 namespace ve {
-    struct compound_message {
-        std::vector<u8> data;
-
-
-        template <typename T> void push_message(mtr_identifier auto type, const T& msg, message_handler* connection) {
+    namespace detail {
+        // Since the message handler won't directly parse the contents of a compound message,
+        // we need to make sure to register its constituent message types manually.
+        // Returns the local MTR ID of the given message type.
+        template <typename T> inline mtr_id register_compound_message_type(mtr_identifier auto type, message_handler* connection) {
             const auto& mtr = connection->get_local_mtr();
 
-
-            // Since the message handler won't directly parse the contents of this message,
-            // we need to make sure to register its constituent message types manually.
             // If we were passed an MTR ID, we can assume that it is at least registered locally, otherwise where did the ID come from?
             if constexpr (!is_mtr_id<decltype(type)>) connection->register_message_type_local(type, type_hash<T>());
             connection->register_message_type_remote(connection->resolve_local(type), type_hash<T>());
@@ -31,16 +30,33 @@ namespace ve {
             );
 
 
+            if constexpr (is_mtr_id<decltype(type)>) return type;
+            else return mtr.get_type(type).id;
+        }
+    }
+
+
+    struct compound_message {
+        std::vector<u8> data;
+        // Most urgent priority of any message added to this message. This is not sent to the remote,
+        // but should be passed to message_handler::send_message when sending the compound message.
+        message_priority priority = message_priority::BULK;
+
+        ve_make_decomposable(compound_message, data);
+
+
+        template <typename T> void push_message(mtr_identifier auto type, const T& msg, message_handler* connection, message_priority msg_priority = message_priority::NORMAL) {
+            const mtr_id id = detail::register_compound_message_type<T>(type, connection);
             serialize::push_serializer ser { data };
 
             std::size_t old_size = data.size();
-            ser.push_bytes(serialize::to_bytes(msg));
+            serialize::to_bytes(msg, data);
             std::size_t new_size = data.size();
 
-            if constexpr (is_mtr_id<decltype(type)>) ser.push(type);
-            else ser.push(connection->get_local_mtr().get_type(type).id);
+            ser.push(id);
 
             serialize::encode_variable_length(new_size - old_size, data);
+            priority = most_urgent(priority, msg_priority);
         }
 
 
@@ -55,35 +71,194 @@ namespace ve {
 
         void clear(void) {
             data.clear();
+            priority = message_priority::BULK;
+        }
+
+
+        bool empty(void) const {
+            return data.empty();
+        }
+    };
+
+
+    // Compact alternative to compound_message. Messages are serialized directly into the message data,
+    // and consecutive messages of the same type share a single header containing their type and count.
+    // Layout: a sequence of runs of the form [type][count] followed by count times [length][message],
+    // where all integers except the messages themselves are forward-readable variable length integers.
+    struct compound_message_v2 {
+        std::vector<u8> data;
+        // Most urgent priority of any message added to this message. This is not sent to the remote,
+        // but should be passed to message_handler::send_message when sending the compound message.
+        message_priority priority = message_priority::BULK;
+
+        ve_make_decomposable(compound_message_v2, data);
+
+
+        template <typename T> void push_message(mtr_identifier auto type, const T& msg, message_handler* connection, message_priority msg_priority = message_priority::NORMAL) {
+            const mtr_id id = detail::register_compound_message_type<T>(type, connection);
+
+            // Start a new run if the previous message was of a different type.
+            if (run_count == 0 || id != run_type) {
+                serialize::encode_variable_length_forward(id, data);
+
+                run_type   = id;
+                run_count  = 0;
+                run_offset = data.size();
+
+                data.push_back(0);
+            }
+
+
+            if constexpr (serialize::has_serialized_size_v<T>) {
+                const std::size_t msg_size = serialize::serialized_size(msg);
+
+                serialize::encode_variable_length_forward(msg_size, data);
+                serialize::to_bytes(msg, data);
+            } else {
+                // The length of the message is not known until it is serialized, so reserve a single byte for it,
+                // and move the message to make room for a longer length in the uncommon case that it does not fit.
+                const std::size_t length_offset = data.size();
+                data.push_back(0);
+
+                serialize::to_bytes(msg, data);
+                write_length(length_offset, data.size() - length_offset - 1, 1);
+            }
+
+            write_length(run_offset, run_count + 1, serialize::variable_length_size(run_count));
+            ++run_count;
+
+            priority = most_urgent(priority, msg_priority);
+        }
+
+
+        void clear(void) {
+            data.clear();
+            priority  = message_priority::BULK;
+            run_count = 0;
         }
 
 
         bool empty(void) const {
             return data.empty();
         }
+    private:
+        // Current run of messages of the same type. Messages of this type are appended to it until a message of another type is added.
+        std::size_t run_offset = 0;
+        u64 run_count = 0;
+        mtr_id run_type = 0;
+
+
+        // Overwrites a variable length integer of old_size bytes at the given offset, growing the data if the new value does not fit.
+        void write_length(std::size_t offset, u64 length, std::size_t old_size) {
+            const std::size_t new_size = serialize::variable_length_size(length);
+            if (new_size > old_size) data.insert(data.begin() + offset, new_size - old_size, 0);
+
+            serialize::write_variable_length_forward(length, data.data() + offset);
+        }
     };
 
 
+    namespace detail {
+        // Dispatches every message in the given compound message data to the handler.
+        inline void dispatch_compound_contents(std::span<const u8> span, message_handler& handler) {
+            while (!span.empty()) {
+                u64    msg_size = serialize::decode_variable_length(span);
+                mtr_id msg_type = serialize::from_bytes<mtr_id>(span);
+                auto   msg_data = take_back_n(span, msg_size);
+
+                handler.on_message_received(msg_type, msg_data);
+            }
+        }
+
+
+        // Invokes visitor with the type and data of every message in the given compound_message_v2 data, in the order they were added.
+        // Returns false if the data is malformed, in which case the visitor may have been invoked for the messages before the malformed part.
+        template <typename Visitor> inline bool visit_compound_v2_contents(std::span<const u8> span, Visitor visitor) {
+            while (!span.empty()) {
+                auto msg_type = serialize::decode_variable_length_forward(span);
+                auto count    = serialize::decode_variable_length_forward(span);
+
+                if (!msg_type || !count || *msg_type > max_value<mtr_id>) [[unlikely]] return false;
+
+                for (u64 i = 0; i < *count; ++i) {
+                    auto msg_size = serialize::decode_variable_length_forward(span);
+                    if (!msg_size || *msg_size > span.size()) [[unlikely]] return false;
+
+                    visitor((mtr_id) *msg_type, take_front_n(span, *msg_size));
+                }
+            }
+
+            return true;
+        }
+
+
+        // Dispatches every message in the given compound_message_v2 data to the handler, in the order they were added.
+        // The data comes from the remote, so it is validated first, and if it is malformed, none of the messages are dispatched.
+        inline void dispatch_compound_v2_contents(std::span<const u8> span, message_handler& handler) {
+            if (!visit_compound_v2_contents(span, [] (mtr_id, std::span<const u8>) {})) [[unlikely]] {
+                VE_LOG_ERROR(cat("Received malformed compound message on ", handler.get_local_id(), " from remote ", handler.get_remote_id(), ". Message will be ignored."));
+                return;
+            }
+
+            visit_compound_v2_contents(span, [&] (mtr_id type, std::span<const u8> data) { handler.on_message_received(type, data); });
+        }
+    }
+
+
     template <typename Instance>
     inline void on_msg_compound_received(Instance& instance, message_handler& handler, const compound_message& msg) {
-        std::span<const u8> span { msg.data.begin(), msg.data.end() };
+        detail::dispatch_compound_contents(std::span<const u8> { msg.data.begin(), msg.data.end() }, handler);
+    }
 
-        while (!span.empty()) {
-            u64    msg_size = serialize::decode_variable_length(span);
-            mtr_id msg_type = serialize::from_bytes<mtr_id>(span);
-            auto   msg_data = take_back_n(span, msg_size);
 
-            handler.on_message_received(msg_type, msg_data);
-        }
+    // Handles a compound message directly from its serialized form, so the contained messages are dispatched as views into the received data.
+    template <typename Instance>
+    inline void on_msg_compound_view_received(Instance& instance, message_handler& handler, std::span<const u8> msg) {
+        // Serialized compound_message is its data followed by the number of bytes in it.
+        u64 size = serialize::decode_variable_length(msg);
+        detail::dispatch_compound_contents(take_back_n(msg, size), handler);
     }
 
 
     // Message can be used to combine multiple other messages into one.
     // Remote will handle messages in the reverse order they were added to the compound message.
     const inline core_message<compound_message> msg_compound {
-        .name               = core_message_types::MSG_COMPOUND,
-        .direction          = message_direction::BIDIRECTIONAL,
-        .on_received_client = on_msg_compound_received<client>,
-        .on_received_server = on_msg_compound_received<server>
+        .name                    = core_message_types::MSG_COMPOUND,
+        .direction               = message_direction::BIDIRECTIONAL,
+        .on_received_client      = on_msg_compound_received<client>,
+        .on_received_server      = on_msg_compound_received<server>,
+        .on_view_received_client = on_msg_compound_view_received<client>,
+        .on_view_received_server = on_msg_compound_view_received<server>
+    };
+
+
+    template <typename Instance>
+    inline void on_msg_compound_v2_received(Instance& instance, message_handler& handler, const compound_message_v2& msg) {
+        detail::dispatch_compound_v2_contents(std::span<const u8> { msg.data.begin(), msg.data.end() }, handler);
+    }
+
+
+    template <typename Instance>
+    inline void on_msg_compound_v2_view_received(Instance& instance, message_handler& handler, std::span<const u8> msg) {
+        auto size = serialize::try_decode_variable_length(msg);
+
+        if (!size || *size > msg.size()) [[unlikely]] {
+            VE_LOG_ERROR(cat("Received malformed compound message on ", handler.get_local_id(), " from remote ", handler.get_remote_id(), ". Message will be ignored."));
+            return;
+        }
+
+        detail::dispatch_compound_v2_contents(take_back_n(msg, *size), handler);
+    }
+
+
+    // Compact version of the above message, see compound_message_v2.
+    // Remote will handle messages in the order they were added to the compound message.
+    const inline core_message<compound_message_v2> msg_compound_v2 {
+        .name                    = core_message_types::MSG_COMPOUND_V2,
+        .direction               = message_direction::BIDIRECTIONAL,
+        .on_received_client      = on_msg_compound_v2_received<client>,
+        .on_received_server      = on_msg_compound_v2_received<server>,
+        .on_view_received_client = on_msg_compound_v2_view_received<client>,
+        .on_view_received_server = on_msg_compound_v2_view_received<server>
     };
 }
\ No newline at end of file
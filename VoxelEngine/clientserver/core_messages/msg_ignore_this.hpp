@@ -10,8 +10,9 @@ namespace ve {
 
 
     struct null_message {
-        void to_bytes(std::vector<u8>&) const {}
-        static null_message from_bytes(std::span<const u8>&) { return null_message {}; }
+        void to_bytes(auto&) const {}
+        static null_message from_bytes(auto&) { return null_message {}; }
+        std::size_t serialized_size(void) const { return 0; }
     };
 
 
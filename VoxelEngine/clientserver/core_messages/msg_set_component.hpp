@@ -21,6 +21,9 @@ namespace ve {
 
     template <typename Instance, bool Rebroadcast>
     inline void on_msg_set_component_received(Instance& instance, message_handler& handler, const set_component_message_tmpl<Rebroadcast>& msg) {
+        // Unreliable updates may overtake the message that creates the entity, or arrive after the one that destroys it.
+        if (handler.is_receiving_unreliable() && !instance.get_storage().valid(msg.entity)) return;
+
         const auto& component_data = component_registry::instance().get(msg.component_type);
 
         auto [allowed, value] = component_data.set_component_checked(
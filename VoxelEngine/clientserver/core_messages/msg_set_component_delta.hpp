@@ -0,0 +1,109 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/ecs/change_validator.hpp>
+#include <VoxelEngine/ecs/component_registry.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/core_messages/core_message.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_set_component.hpp>
+
+
+namespace ve {
+    // Like set_component_message, but contains a delta (see serialize::delta_to_bytes) against the last value of the component
+    // sent to the receiving instance, rather than the full value.
+    // If the receiver does not hold that value (See serialize::baseline_hash), it drops the delta and requests the full value.
+    struct set_component_delta_message {
+        std::vector<u8> component_delta;
+        u64 baseline_hash;
+        u64 component_type;
+        entt::entity entity;
+    };
+
+
+    // Sent back if a delta did not match the value of the component held by the receiver, to request the full value instead.
+    struct resend_component_message {
+        u64 component_type;
+        entt::entity entity;
+    };
+
+
+    // Added to an entity when a remote requests the full value of one of its components.
+    // Requests are handled by the system_synchronizer that synchronizes the component.
+    struct resend_request_component {
+        using non_synchronizable_tag = void;
+        using non_snapshottable_tag  = void;
+
+        // Remote and type hash of the requested component.
+        small_vector<std::pair<instance_id, u64>, 1> requests;
+    };
+
+
+    template <typename Instance>
+    inline void on_msg_set_component_delta_received(Instance& instance, message_handler& handler, const set_component_delta_message& msg) {
+        const auto& component_data = component_registry::instance().get(msg.component_type);
+
+        if (!component_data.apply_delta_checked) [[unlikely]] {
+            VE_LOG_ERROR(cat("Received delta for component ", component_data.name, " which does not support delta encoding. Change will be ignored."));
+            return;
+        }
+
+
+        auto result = component_data.apply_delta_checked(
+            handler.get_remote_id(),
+            instance,
+            msg.entity,
+            msg.baseline_hash,
+            std::span { msg.component_delta.begin(), msg.component_delta.end() }
+        );
+
+        if (!result) {
+            handler.send_message(
+                core_message_types::MSG_RESEND_COMPONENT,
+                resend_component_message { msg.component_type, msg.entity }
+            );
+
+            return;
+        }
+
+
+        auto& [allowed, value] = *result;
+
+        // If the change was not allowed, but we can observe the entity, send back the fact that the component is unchanged.
+        if (allowed == change_result::FORBIDDEN) {
+            handler.send_message(
+                core_message_types::MSG_UNDO_COMPONENT,
+                undo_component_message { std::move(value), msg.component_type, msg.entity }
+            );
+        }
+    }
+
+
+    template <typename Instance>
+    inline void on_msg_resend_component_received(Instance& instance, message_handler& handler, const resend_component_message& msg) {
+        if (!instance.get_storage().valid(msg.entity)) return;
+
+        auto* component = instance.template try_get_component<resend_request_component>(msg.entity);
+        if (!component) component = &instance.set_component(msg.entity, resend_request_component { });
+
+        const auto request = std::pair { handler.get_remote_id(), msg.component_type };
+        if (std::ranges::find(component->requests, request) == component->requests.end()) component->requests.push_back(request);
+    }
+
+
+    // Message to update the value of a component for some entity, relative to its previous value.
+    const inline core_message<set_component_delta_message> msg_set_component_delta {
+        .name               = core_message_types::MSG_DELTA_COMPONENT,
+        .direction          = message_direction::BIDIRECTIONAL,
+        .on_received_client = on_msg_set_component_delta_received<client>,
+        .on_received_server = on_msg_set_component_delta_received<server>
+    };
+
+    // Message sent back if the above message was not applied because the receiver holds a different value than the delta's baseline.
+    const inline core_message<resend_component_message> msg_resend_component {
+        .name               = core_message_types::MSG_RESEND_COMPONENT,
+        .direction          = message_direction::BIDIRECTIONAL,
+        .on_received_client = on_msg_resend_component_received<client>,
+        .on_received_server = on_msg_resend_component_received<server>
+    };
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/clientserver/message_type_registry.hpp>
 #include <VoxelEngine/clientserver/instance_id.hpp>
+#include <VoxelEngine/clientserver/message_priority.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
 #include <VoxelEngine/utility/traits/function_traits.hpp>
 
@@ -12,6 +13,16 @@ namespace ve {
     template <mtr_identifier T> constexpr inline bool is_mtr_id = std::is_same_v<T, mtr_id>;
 
 
+    enum class message_channel : u8 {
+        // Messages are always delivered, in the order they were sent.
+        RELIABLE_ORDERED,
+        // Messages may be lost, and are dropped if a newer message of the same type has already been received.
+        // Use this for state updates that are superseded by the next update, so they are not delayed by other traffic.
+        // Connections that don't support unreliable messages will send them reliably instead.
+        UNRELIABLE_LATEST
+    };
+
+
     class message_handler {
     public:
         template <typename Instance>
@@ -94,7 +105,13 @@ namespace ve {
         }
 
 
-        template <typename T> void send_message(mtr_identifier auto id, const T& value) {
+        // Note: messages sent while the handler is queueing are sent with normal priority once the queue is disabled.
+        template <typename T> void send_message(
+            mtr_identifier auto id,
+            const T& value,
+            message_channel channel   = message_channel::RELIABLE_ORDERED,
+            message_priority priority = message_priority::NORMAL
+        ) {
             // If the ID is an MTR ID, the type must already be registered locally, otherwise where did the ID come from?
             if constexpr (!is_mtr_id<decltype(id)>) register_message_type_local(id, type_hash<T>());
             register_message_type_remote(resolve_local(id), type_hash<T>());
@@ -118,11 +135,24 @@ namespace ve {
             }
 
 
-            send_message(
-                resolve_local(id),
-                &value,
-                [](const void* obj, std::vector<u8>& vec) { serialize::to_bytes(*((const T*) obj), vec); }
-            );
+            auto to_bytes = [](const void* obj, std::vector<u8>& vec) {
+                const T& msg = *((const T*) obj);
+
+                // If the message is written to a new buffer, it can be sized exactly, including the MTR ID appended after it.
+                if constexpr (serialize::has_serialized_size_v<T>) {
+                    if (vec.empty()) vec.reserve(serialize::serialized_size(msg) + sizeof(mtr_id));
+                }
+
+                serialize::to_bytes(msg, vec);
+            };
+
+            if (channel == message_channel::UNRELIABLE_LATEST) send_message_unreliable(resolve_local(id), &value, to_bytes);
+            else send_message(resolve_local(id), &value, to_bytes, priority);
+        }
+
+
+        template <typename T> void send_message(mtr_identifier auto id, const T& value, message_priority priority) {
+            send_message(id, value, message_channel::RELIABLE_ORDERED, priority);
         }
 
 
@@ -131,6 +161,14 @@ namespace ve {
         }
 
 
+        // True while handling a message that was received over an unreliable channel.
+        // Such messages are not ordered with respect to reliable ones, so e.g. a component update may arrive before the message
+        // that creates its entity, or after the one that destroys it. Handlers should ignore messages that are no longer applicable.
+        bool is_receiving_unreliable(void) const {
+            return receiving_unreliable;
+        }
+
+
         void toggle_queue(bool enabled) {
             use_queue = enabled;
 
@@ -163,7 +201,7 @@ namespace ve {
                 for (const auto& msg : read_messages | views::reverse) on_message_received(msg);
                 read_queue.clear();
 
-                for (const auto& msg : write_messages | views::reverse) send_message(msg);
+                for (const auto& msg : write_messages | views::reverse) send_message(msg, message_priority::NORMAL);
                 write_queue.clear();
             }
         }
@@ -173,23 +211,28 @@ namespace ve {
         // The datatype for the message is automatically deduced to be the first parameter of Fn if it is not specified.
         template <typename Fn, typename T = meta::nth_argument_base<Fn, 0>> requires std::is_invocable_v<Fn, const T&>
         void add_handler(mtr_identifier auto id, Fn&& handler) {
-            // If the ID is an MTR ID, the type must already be registered locally, otherwise where did the ID come from?
-            if constexpr (!is_mtr_id<decltype(id)>) register_message_type_local(id, type_hash<T>());
-
-
-            VE_DEBUG_ASSERT(
-                local_mtr->get_type(id).template holds<T>(),
-                "Attempt to register handler for message of type ", local_mtr->get_type(id).name, " with data of type ", ctti::nameof<T>(),
-                " but this is not the data type associated with that MTR type."
-            );
+            get_handler_data<T>(id).handlers.push_back(fwd(handler));
+        }
 
 
-            auto resolved_id = resolve_local(id);
+        // Add a handler for the given message type which receives the serialized message instead of the deserialized value.
+        // For messages received from a remote, the span is a view into the receive buffer, so the message is never copied or deserialized,
+        // unless other handlers for the same type require the deserialized value.
+        // Note: the span is only valid for the duration of the call.
+        template <typename T> void add_view_handler(mtr_identifier auto id, std::function<void(std::span<const u8>)> handler) {
+            get_handler_data<T>(id).view_handlers.push_back(std::move(handler));
+        }
 
-            auto it = handlers.find(resolved_id);
-            if (it == handlers.end()) std::tie(it, std::ignore) = handlers.emplace(resolved_id, make_unique<handler_data<T>>());
 
-            ((handler_data<T>*) it->second.get())->handlers.push_back(fwd(handler));
+        // Add a handler for the given message type which has separate implementations for serialized and deserialized messages.
+        // Values passed directly from a local connection go to value_handler, serialized messages go to view_handler,
+        // so the message is never converted between the two forms on behalf of this handler.
+        template <typename T> void add_dual_handler(
+            mtr_identifier auto id,
+            std::function<void(const T&)> value_handler,
+            std::function<void(std::span<const u8>)> view_handler
+        ) {
+            get_handler_data<T>(id).dual_handlers.emplace_back(std::move(value_handler), std::move(view_handler));
         }
 
 
@@ -216,23 +259,63 @@ namespace ve {
         VE_GET_VAL(remote_id);
     protected:
         // Override this method to perform the actual sending of data to the remote message handler.
-        virtual void send_message(std::span<const u8> data) = 0;
+        // The priority may be ignored if the connection has no use for it.
+        virtual void send_message(std::span<const u8> data, message_priority priority) = 0;
 
         // Optional second method can be overridden to elude message serialization when both handlers are local.
-        virtual void send_message(mtr_id id, const void* msg, fn<void, const void*, std::vector<u8>&> to_bytes) {
+        virtual void send_message(mtr_id id, const void* msg, fn<void, const void*, std::vector<u8>&> to_bytes, message_priority priority) {
             std::vector<u8> data;
             to_bytes(msg, data);
             serialize::to_bytes(id, data);
 
-            send_message(std::span<const u8> { data.begin(), data.end() });
+            send_message(std::span<const u8> { data.begin(), data.end() }, priority);
+        }
+
+        // Override to support sending messages over an unreliable channel. By default, messages are sent reliably.
+        virtual void send_message_unreliable(mtr_id id, const void* msg, fn<void, const void*, std::vector<u8>&> to_bytes) {
+            send_message(id, msg, to_bytes, message_priority::NORMAL);
+        }
+
+        // Should be used instead of on_message_received for messages received over an unreliable channel.
+        void on_unreliable_message_received(std::span<const u8> data) {
+            // Queued messages are handled as if they were reliable, so drop the message instead. It is unreliable anyway.
+            if (use_queue) return;
+
+            receiving_unreliable = true;
+            on_message_received(data);
+            receiving_unreliable = false;
         }
 
     private:
+        template <typename T> struct handler_data;
+
+
         // Implementation of the constructor must be in the CPP file to prevent a circular dependency,
         // but GCC does not handle the syntax for this correctly, so provide a wrapper method.
         template <typename Instance> void init(Instance& instance);
 
 
+        template <typename T> handler_data<T>& get_handler_data(mtr_identifier auto id) {
+            // If the ID is an MTR ID, the type must already be registered locally, otherwise where did the ID come from?
+            if constexpr (!is_mtr_id<decltype(id)>) register_message_type_local(id, type_hash<T>());
+
+
+            VE_DEBUG_ASSERT(
+                local_mtr->get_type(id).template holds<T>(),
+                "Attempt to register handler for message of type ", local_mtr->get_type(id).name, " with data of type ", ctti::nameof<T>(),
+                " but this is not the data type associated with that MTR type."
+            );
+
+
+            auto resolved_id = resolve_local(id);
+
+            auto it = handlers.find(resolved_id);
+            if (it == handlers.end()) std::tie(it, std::ignore) = handlers.emplace(resolved_id, make_unique<handler_data<T>>());
+
+            return *((handler_data<T>*) it->second.get());
+        }
+
+
         // Common functionality for different overloads of on_message_received.
         void on_message_received_common(mtr_identifier auto id, const auto& value) {
             const message_type* type = nullptr;
@@ -261,18 +344,30 @@ namespace ve {
         };
 
 
+        // Messages are only converted between their serialized and deserialized forms if there is a handler which requires it.
         template <typename T> struct handler_data : handler_data_base {
             std::vector<std::function<void(const T&)>> handlers;
+            std::vector<std::function<void(std::span<const u8>)>> view_handlers;
+            std::vector<std::pair<std::function<void(const T&)>, std::function<void(std::span<const u8>)>>> dual_handlers;
 
 
             void handle(std::span<const u8> msg) const override {
+                for (const auto& [value_handler, view_handler] : dual_handlers) view_handler(msg);
+                for (const auto& handler : view_handlers) handler(msg);
+                if (handlers.empty()) return;
+
                 T value = serialize::from_bytes<T>(msg);
-                handle(&value);
+                for (const auto& handler : handlers) handler(value);
             }
 
             void handle(const void* msg) const override {
                 const T* msg_ptr = (const T*) msg;
+                for (const auto& [value_handler, view_handler] : dual_handlers) value_handler(*msg_ptr);
                 for (const auto& handler : handlers) handler(*msg_ptr);
+                if (view_handlers.empty()) return;
+
+                auto bytes = serialize::to_bytes(*msg_ptr);
+                for (const auto& handler : view_handlers) handler(bytes);
             }
         };
 
@@ -291,6 +386,8 @@ namespace ve {
         bool use_queue = false;
         std::vector<u8> read_queue, write_queue;
 
+        bool receiving_unreliable = false;
+
         // Since the local MTR may be shared between multiple message handlers, we can't simply assume every type in there
         // is known to the remote, even if we synchronize every time we modify the MTR. Therefore, keep track of which
         // types are known on the remote manually.
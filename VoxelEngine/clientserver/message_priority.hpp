@@ -0,0 +1,26 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+
+
+namespace ve {
+    // Connections that support it send queued messages of a higher priority before those of a lower priority.
+    // Every priority is sent as a separate stream, so messages of the same priority are always received in the order they were sent,
+    // but messages of different priorities may overtake each other. Large messages are split into frames,
+    // so a higher priority message is only delayed by the frame currently being sent, rather than the entire message.
+    enum class message_priority : u8 {
+        // Small, latency-sensitive messages, e.g. player input.
+        HIGH   = 0,
+        NORMAL = 1,
+        // Large transfers that may be delayed in favour of other messages, and that do not depend on messages of other priorities.
+        BULK   = 2
+    };
+
+    constexpr inline std::size_t num_message_priorities = 3;
+
+
+    // Returns the most urgent of the two priorities.
+    constexpr inline message_priority most_urgent(message_priority a, message_priority b) {
+        return (message_priority) std::min((u8) a, (u8) b);
+    }
+}
\ No newline at end of file
@@ -24,9 +24,11 @@ namespace ve {
             if (type_data.is_core) return;
 
             // Otherwise send it to the remote.
+            // This is sent with the highest priority, so it arrives before any message of this type, regardless of that message's priority.
             send_message(
                 core_message_types::MSG_SYNC_MTR,
-                mtr_sync_message { .name = type_data.name, .type_hash = type_data.type_hash, .id = type_data.id }
+                mtr_sync_message { .name = type_data.name, .type_hash = type_data.type_hash, .id = type_data.id },
+                message_priority::HIGH
             );
 
             published_types.insert(type_data.id);
@@ -3,36 +3,81 @@
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/clientserver/message_handler.hpp>
 #include <VoxelEngine/clientserver/socket/socket_session.hpp>
+#include <VoxelEngine/clientserver/socket/udp_channel.hpp>
 
 
 namespace ve {
     class remote_message_handler : public message_handler {
     public:
         template <typename Instance>
-        remote_message_handler(Instance& instance, instance_id remote_id, shared<connection::socket_session> session) :
+        // If a UDP channel is provided, unreliable messages are sent over it once the remote has bound to it.
+        // Until then, they are sent over the session instead.
+        remote_message_handler(Instance& instance, instance_id remote_id, shared<connection::socket_session> session, shared<connection::udp_channel> channel = nullptr) :
             message_handler(instance, remote_id),
-            session(std::move(session))
+            session(std::move(session)),
+            channel(std::move(channel))
         {
             handler_id = this->session->add_raw_handler([this] (const connection::message_received_event& e) {
                 on_message_received(e.message);
             });
+
+            if (this->channel) {
+                channel_handler_id = this->channel->add_raw_handler([this] (const connection::datagram_received_event& e) {
+                    if (e.sender == get_remote_id()) on_unreliable_message_received(e.message);
+                });
+            }
         }
 
 
         ~remote_message_handler(void) {
             this->session->remove_handler<connection::message_received_event>(handler_id);
             this->session->stop();
+
+            if (channel) {
+                channel->remove_handler<connection::datagram_received_event>(channel_handler_id);
+                channel->remove_peer(get_remote_id());
+            }
         }
 
 
         VE_GET_VAL(session);
+        VE_GET_VAL(channel);
     protected:
-        void send_message(std::span<const u8> data) override {
-            session->write(connection::message_t { data.begin(), data.end() });
+        void send_message(std::span<const u8> data, message_priority priority) override {
+            session->write(connection::message_t { data.begin(), data.end() }, priority);
+        }
+
+        // Serialize the message directly into the buffer that is passed to the session, rather than copying it from a temporary one.
+        void send_message(mtr_id id, const void* msg, fn<void, const void*, std::vector<u8>&> to_bytes, message_priority priority) override {
+            connection::message_t data;
+            to_bytes(msg, data);
+            serialize::to_bytes(id, data);
+
+            session->write(std::move(data), priority);
+        }
+
+        void send_message_unreliable(mtr_id id, const void* msg, fn<void, const void*, std::vector<u8>&> to_bytes) override {
+            if (!channel || !channel->is_bound(get_remote_id())) {
+                return message_handler::send_message_unreliable(id, msg, to_bytes);
+            }
+
+            std::vector<u8> data;
+            to_bytes(msg, data);
+            serialize::to_bytes(id, data);
+
+            // Messages too large to be reassembled by the remote are sent reliably instead.
+            if (data.size() > connection::max_unreliable_message_size) {
+                session->write(std::move(data), message_priority::NORMAL);
+                return;
+            }
+
+            // Every message type gets its own stream, so a message is only superseded by newer messages of the same type.
+            channel->send(get_remote_id(), data, id);
         }
 
     private:
         shared<connection::socket_session> session;
-        event_handler_id_t handler_id;
+        shared<connection::udp_channel> channel;
+        event_handler_id_t handler_id, channel_handler_id;
     };
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/clientserver/message_priority.hpp>
 #include <VoxelEngine/event/delayed_event_dispatcher.hpp>
 #include <VoxelEngine/event/subscribe_only_view.hpp>
+#include <VoxelEngine/utility/buffer_pool.hpp>
+
+#include <any>
 
 #include <boost/asio.hpp>
 #include <VoxelEngine/core/windows_header_cleanup.hpp>
@@ -22,9 +26,51 @@ namespace ve::connection {
     using message_t    = std::vector<u8>;
 
 
-    constexpr u64 message_size_limit = 64 * 1024; // 64 MB
+    // Maximum size of a single message, both as received and after decompression.
+    // Every priority stream of a session may buffer a message of this size, so this bounds the memory a remote can make a session allocate.
+    // The largest messages sent by the engine are chunk messages, which are around 128 KiB before compression.
+    constexpr u64 message_size_limit = 1024 * 1024; // 1 MiB
     constexpr session_id invalid_session_id = max_value<session_id>;
 
+    // Messages larger than this are split into multiple frames, so that messages of a higher priority can be sent in between.
+    constexpr std::size_t max_frame_size = 16 * 1024;
+
+    // Messages smaller than this are sent uncompressed by default, since compression would likely make them larger.
+    constexpr std::size_t default_compression_threshold = 256;
+
+
+    // Every message on the wire is followed by a single byte indicating how it was encoded.
+    // Since the codec is sent with every message, the receiver can decode any message, regardless of the settings of the sender.
+    enum class message_codec : u8 {
+        RAW            = 0,
+        // Compressed using the sending session's deflate_stream. Must be decompressed in the order the messages were sent.
+        DEFLATE_STREAM = 1
+    };
+
+
+    // Can be passed to socket_session::write to override the codec selection for a single message,
+    // e.g. for messages that are known to be (in)compressible.
+    enum class codec_hint : u8 { AUTOMATIC, RAW, COMPRESSED };
+
+
+    // Simulated network conditions for a socket_session, used to test how the engine behaves over a real network when running over loopback.
+    // Conditions are applied to outgoing messages only, so to simulate a round trip, both ends of the connection should have them set.
+    struct network_conditions {
+        // Every message is delayed by the latency plus a random amount of time between zero and the jitter.
+        nanoseconds latency = nanoseconds { 0 };
+        nanoseconds jitter  = nanoseconds { 0 };
+        // Since sessions use TCP, lost messages are not dropped but delayed by the retransmit delay instead.
+        f32 loss = 0.0f;
+        nanoseconds retransmit_delay = milliseconds { 200 };
+        // Maximum number of bytes sent per second, or zero for no limit.
+        u64 bandwidth = 0;
+
+
+        bool is_ideal(void) const {
+            return latency == nanoseconds { 0 } && jitter == nanoseconds { 0 } && loss <= 0.0f && bandwidth == 0;
+        }
+    };
+
 
     struct dispatcher_t : public subscribe_only_view<delayed_event_dispatcher<true>> {
         friend class socket_session;
@@ -38,5 +84,14 @@ namespace ve::connection {
     struct session_start_event    { session_id session; };
     struct session_end_event      { session_id session; };
     struct session_error_event    { session_id session; error_code error; };
-    struct message_received_event { session_id session; message_t message; };
+    // The message is a view into a pooled buffer, which is returned to the pool once all handlers for the event have run,
+    // unless a handler keeps a copy of the handle.
+    // The payload is empty, unless it was set by the receive hook of the session (See receive_hook_t).
+    struct message_received_event { session_id session; pooled_buffer message; std::any payload = { }; };
+
+
+    // Optional function invoked on the I/O thread for every received message, before it is handed to the thread that updates the session.
+    // This can be used to move work like deserialization off of the main thread, by storing the result in the event's payload.
+    // Note: handlers may copy the event, so the payload should be cheap to copy (e.g. a shared pointer).
+    using receive_hook_t = std::function<void(message_received_event&)>;
 }
\ No newline at end of file
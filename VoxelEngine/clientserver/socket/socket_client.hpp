@@ -82,6 +82,7 @@ namespace ve::connection {
 
 
         void update(void) {
+            // The session dispatches received messages to the handlers of the client as well, after the client has handled its own events.
             dispatcher_t::dispatch_events();
 
             if (session) {
@@ -90,6 +91,12 @@ namespace ve::connection {
         }
 
 
+        // Sets the receive hook for the session. Must be called before the client is started. See receive_hook_t for details.
+        void set_receive_hook(receive_hook_t hook) {
+            receive_hook = std::move(hook);
+        }
+
+
         shared<socket_session> get_session(void) {
             return session;
         }
@@ -99,6 +106,7 @@ namespace ve::connection {
         std::atomic_bool exited = true;
 
         shared<socket_session> session;
+        receive_hook_t receive_hook;
 
         error_code connection_error;
         std::mutex mtx;
@@ -123,7 +131,7 @@ namespace ve::connection {
                     add_event(instance_error_event { error });
                     connection_error = error;
                 } else {
-                    session = socket_session::create(ctx, std::move(*socket), shared_from_this());
+                    session = socket_session::create(ctx, std::move(*socket), shared_from_this(), receive_hook);
                     session->start();
                 }
             }
@@ -33,6 +33,7 @@ namespace ve::connection {
 
             exited = false;
             sessions.clear();
+            active_sessions.clear();
 
 
             asio::ip::tcp::endpoint endpoint { asio::ip::tcp::v6(), port };
@@ -86,20 +87,49 @@ namespace ve::connection {
 
 
         // Dispatches events and destroys closed sessions.
+        // The list of sessions is only rebuilt when sessions are added or closed,
+        // so a tick without new or closed sessions does not take any locks other than those of the dispatchers.
         void update(void) {
+            if (sessions_added.exchange(false, std::memory_order_acquire)) {
+                std::shared_lock lock { session_mtx };
+                active_sessions = sessions | views::values | ranges::to<std::vector>;
+            }
+
+
+            // Sessions dispatch received messages to the handlers of the server as well, after the server has handled its own events,
+            // so that e.g. handlers added in response to a session_start_event are present before the first message of that session.
             dispatcher_t::dispatch_events();
 
-            {
-                std::unique_lock lock { session_mtx };
 
-                // A session could close between the point where it is updated and the point where it is removed,
-                // which could lead to events being lost.
-                // To fix this, update all sessions (even removed ones) after removing closed ones from the server.
-                auto all_sessions = sessions | views::values | ranges::to<std::vector>;
-                erase_if(sessions, [](const auto& kv) { return !kv.second->is_open(); });
+            // A session could close between the point where it is updated and the point where it is removed,
+            // which could lead to events being lost.
+            // To fix this, only remove sessions that were already closed before their last update.
+            closed_sessions.clear();
 
-                for (auto& session : all_sessions) session->update();
+            for (auto& session : active_sessions) {
+                const bool was_closed = !session->is_open();
+                session->update();
+
+                if (was_closed) {
+                    closed_sessions.push_back(session->get_id());
+                    session = nullptr;
+                }
             }
+
+
+            if (!closed_sessions.empty()) {
+                std::erase(active_sessions, nullptr);
+
+                std::unique_lock lock { session_mtx };
+                for (auto id : closed_sessions) sessions.erase(id);
+            }
+        }
+
+
+        // Sets the receive hook for sessions created after this call. See receive_hook_t for details.
+        void set_receive_hook(receive_hook_t hook) {
+            std::unique_lock lock { session_mtx };
+            receive_hook = std::move(hook);
         }
 
 
@@ -116,6 +146,12 @@ namespace ve::connection {
 
         std::shared_mutex session_mtx;
         hash_map<session_id, shared<socket_session>> sessions;
+        receive_hook_t receive_hook;
+
+        // Copy of the sessions for use by update, so it does not have to lock the session map every tick.
+        std::vector<shared<socket_session>> active_sessions;
+        std::vector<session_id> closed_sessions;
+        std::atomic_bool sessions_added = false;
 
         std::vector<std::thread> threads;
         std::size_t num_threads;
@@ -147,10 +183,12 @@ namespace ve::connection {
             {
                 std::unique_lock lock { session_mtx };
 
-                session = socket_session::create(ctx, std::move(*socket), shared_from_this());
+                session = socket_session::create(ctx, std::move(*socket), shared_from_this(), receive_hook);
                 sessions.emplace(session->get_id(), session);
             }
 
+            sessions_added.store(true, std::memory_order_release);
+
             session->start();
 
 
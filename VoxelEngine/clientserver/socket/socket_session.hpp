@@ -5,22 +5,27 @@
 #include <VoxelEngine/utility/raii.hpp>
 #include <VoxelEngine/utility/functional.hpp>
 #include <VoxelEngine/utility/compression.hpp>
+#include <VoxelEngine/utility/random.hpp>
 #include <VoxelEngine/utility/io/serialize/variable_length_encoder.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
 #include <VoxelEngine/utility/thread/threadsafe_counter.hpp>
+#include <VoxelEngine/utility/thread/spsc_queue.hpp>
 
-#include <queue>
+#include <deque>
 
 
 namespace ve::connection {
     class socket_session : public dispatcher_t, public std::enable_shared_from_this<socket_session> {
     public:
-        ve_shared_only(socket_session, asio::io_context& ctx, asio::ip::tcp::socket socket, shared<dispatcher_t> parent) :
+        ve_shared_only(socket_session, asio::io_context& ctx, asio::ip::tcp::socket socket, shared<dispatcher_t> parent, receive_hook_t receive_hook = nullptr) :
             dispatcher_t { },
             std::enable_shared_from_this<socket_session> { },
             id(threadsafe_counter<"ve.connection.session">::next()),
             socket { std::move(socket) },
             strand { ctx },
-            parent_dispatcher { std::move(parent) }
+            delay_timer { ctx },
+            parent_dispatcher { std::move(parent) },
+            receive_hook { std::move(receive_hook) }
         {}
 
         ~socket_session(void) {
@@ -29,7 +34,7 @@ namespace ve::connection {
 
             // Note that we can't simply dispatch any remaining events when we close the socket,
             // since we want to guarantee event handlers are called from the thread that invokes owner::update().
-            VE_ASSERT(!has_pending_events(), "Session was destroyed with pending events.");
+            VE_ASSERT(!has_pending_events() && received_messages.empty(), "Session was destroyed with pending events.");
         }
 
         ve_immovable(socket_session);
@@ -63,22 +68,95 @@ namespace ve::connection {
         }
 
 
-        void write(message_t message) {
+        void write(message_t message, codec_hint hint = codec_hint::AUTOMATIC) {
+            write(std::move(message), message_priority::NORMAL, hint);
+        }
+
+
+        void write(message_t message, message_priority priority, codec_hint hint = codec_hint::AUTOMATIC) {
             // do_async_write and write need to happen on the same thread, so use a strand for dispatching.
+            // Since messages are encoded on the strand, they are also compressed in the order they are sent, as required by deflate_stream.
             asio::dispatch(
                 strand,
-                [self = shared_from_this(), msg = std::move(message)] () {
-                    auto compressed_msg = compress(msg, compression_mode::BEST_PERFORMANCE);
+                [self = shared_from_this(), msg = std::move(message), priority, hint] () mutable {
+                    const auto stream = (std::size_t) priority;
+
+                    auto encoded = self->encode_message(std::move(msg), hint, stream);
+
+                    // Messages written after the conditions are reset are still held back by any delayed messages before them.
+                    if (!self->conditions.is_ideal() || !self->delayed_messages.empty()) [[unlikely]] {
+                        return self->delay_message(std::move(encoded), stream);
+                    }
 
-                    self->write_queue.push(std::move(compressed_msg));
-                    self->do_async_write();
+                    self->write_queues[stream].push_back(std::move(encoded));
+                    if (!self->flush_manually) self->do_async_write();
                 }
             );
         }
 
 
+        // Starts writing all queued messages. This is only required if manual flushing is enabled.
+        void flush(void) {
+            asio::dispatch(strand, [self = shared_from_this()] () { self->do_async_write(); });
+        }
+
+
+        // If enabled, written messages are only sent once flush is called. Update will also flush the session.
+        // This allows all messages produced during a tick to be sent as a single batch.
+        void set_manual_flush(bool enabled) {
+            flush_manually = enabled;
+            if (!enabled) flush();
+        }
+
+
+        // Sets the maximum number of frames and bytes sent in a single write. Messages larger than max_frame_size are sent as multiple frames.
+        // Note: more than 32 frames per write will cause ASIO to split the write into multiple system calls.
+        void set_max_batch_size(std::size_t messages, std::size_t bytes) {
+            max_batch_messages = std::max<std::size_t>(messages, 1);
+            max_batch_bytes    = bytes;
+        }
+
+
+        // Returns the number of writes started by this session, where each write sends a batch of frames.
+        u64 get_num_writes(void) const {
+            return num_writes;
+        }
+
+
+        // Returns the total number of bytes sent and received by this session, including frame headers.
+        u64 get_num_bytes_written(void) const {
+            return num_bytes_written;
+        }
+
+        u64 get_num_bytes_read(void) const {
+            return num_bytes_read;
+        }
+
+
+        // Simulates the given network conditions for messages written after this call. See network_conditions for details.
+        void set_network_conditions(const network_conditions& nc) {
+            asio::dispatch(strand, [self = shared_from_this(), nc] () { self->conditions = nc; });
+        }
+
+
+        // Messages of at least this size are compressed, unless a different codec_hint is passed to write.
+        void set_compression_threshold(std::size_t threshold) {
+            compression_threshold = threshold;
+        }
+
+        std::size_t get_compression_threshold(void) const {
+            return compression_threshold;
+        }
+
+
+        // Messages received since the last update are dispatched to the handlers of the parent and then to those of this session,
+        // before any other events of the session, so that e.g. the session_end_event comes after the last message.
+        // The parent should dispatch its own events before updating its sessions.
         void update(void) {
+            dispatch_received_messages();
             dispatch_events();
+
+            if (flush_manually) flush();
         }
 
 
@@ -95,16 +173,77 @@ namespace ve::connection {
         asio::io_context::strand strand;
 
         shared<dispatcher_t> parent_dispatcher;
+        receive_hook_t receive_hook;
 
-        // Since the buffer is sent out as an event twice, keeping it as a pointer prevents a copy.
-        shared<message_t> read_buffer;
+        // Received messages are handed to the thread calling update through a lock-free queue, since they make up most events.
+        // Reads are chained, so there is only ever one thread pushing to the queue at a time.
+        // Other events are rare and go through the (locking) dispatchers directly.
+        spsc_queue<message_received_event> received_messages;
+        // Messages are drained from the queue into this buffer and dispatched from there, rather than being copied into both dispatchers.
+        std::vector<message_received_event> received_batch;
+
+        // Every message priority is sent as its own stream, so a large message only delays messages of a higher priority by a single frame.
+        // Each frame header contains the size of the frame, its stream and whether it is the last frame of its message.
+        struct frame {
+            u8 stream;
+            bool last;
+            std::span<const u8> data;
+
+
+            u64 header(void) const {
+                return (u64(data.size()) << 3) | (u64(stream) << 1) | u64(last);
+            }
+        };
+
+        static_assert(num_message_priorities <= 4, "Frame header can only encode up to four streams.");
+
+
+        // Buffers are taken from the buffer_pool and handed to the received message event, so they are only recycled once the event is handled.
+        // Every stream has its own buffer, since frames of different streams may be interleaved.
+        std::array<pooled_buffer, num_message_priorities> read_buffers;
         message_t read_header_buffer;
-        std::queue<message_t> write_queue;
+
+        // Queued messages for every stream, and how much of the first message of each stream has already been sent.
+        std::array<std::deque<message_t>, num_message_priorities> write_queues;
+        std::array<std::size_t, num_message_priorities> write_offsets { };
+
+        // Frames and headers for the write currently in progress.
+        // Messages of which the last frame is being sent are moved into the batch, so they stay alive until the write completes.
+        std::vector<frame> write_frames;
+        std::vector<message_t> write_batch;
         message_t write_header_buffer;
+        std::vector<asio::const_buffer> write_buffers;
 
         bool is_writing = false;
+        std::atomic_bool flush_manually = false;
+        std::atomic<std::size_t> max_batch_messages = 32;
+        std::atomic<std::size_t> max_batch_bytes = 256 * 1024;
+        std::atomic<u64> num_writes = 0;
+        std::atomic<u64> num_bytes_written = 0;
+        std::atomic<u64> num_bytes_read = 0;
         std::atomic_bool is_closed = false;
 
+        // Streams are constructed on first use, since most of their memory usage comes from their internal buffers.
+        // Every message stream has its own deflate stream, since messages of different streams may be received in a different order than they were sent.
+        // The deflate streams are only used from the strand, and the inflate streams only from the read handlers, which never run concurrently.
+        std::array<std::optional<deflate_stream>, num_message_priorities> deflaters;
+        std::array<std::optional<inflate_stream>, num_message_priorities> inflaters;
+        std::atomic<std::size_t> compression_threshold = default_compression_threshold;
+
+
+        // Messages delayed by the simulated network conditions. Release times never decrease, since TCP delivers messages in order.
+        // Only used from the strand.
+        struct delayed_message {
+            steady_clock::time_point release;
+            std::size_t stream;
+            message_t message;
+        };
+
+        network_conditions conditions;
+        asio::steady_timer delay_timer;
+        std::deque<delayed_message> delayed_messages;
+        steady_clock::time_point link_free, last_release;
+
 
         template <typename Event> void dispatch_event(Event&& event) {
             dispatcher_t::add_event(event);
@@ -112,10 +251,134 @@ namespace ve::connection {
         };
 
 
+        void dispatch_received_messages(void) {
+            received_messages.drain([&] (message_received_event&& event) { received_batch.push_back(std::move(event)); });
+            if (received_batch.empty()) return;
+
+            const auto batch = std::span<const message_received_event> { received_batch };
+            parent_dispatcher->dispatch_events(batch);
+            dispatcher_t::dispatch_events(batch);
+
+            // Returns the message buffers to the pool, unless a handler kept a copy of them.
+            received_batch.clear();
+        }
+
+
+        message_t encode_message(message_t message, codec_hint hint, std::size_t stream) {
+            const bool should_compress =
+                hint == codec_hint::COMPRESSED ||
+                (hint == codec_hint::AUTOMATIC && message.size() >= compression_threshold);
+
+            if (!should_compress) {
+                message.push_back((u8) message_codec::RAW);
+                return message;
+            }
+
+
+            auto& deflater = deflaters[stream];
+            if (!deflater) deflater.emplace(compression_mode::BEST_PERFORMANCE);
+
+            message_t result;
+            deflater->compress(message, result);
+            result.push_back((u8) message_codec::DEFLATE_STREAM);
+
+            return result;
+        }
+
+
+        std::optional<pooled_buffer> decode_message(pooled_buffer message, std::size_t stream) {
+            if (message.empty()) [[unlikely]] return std::nullopt;
+
+            auto codec = (message_codec) message.get().back();
+            message.get().pop_back();
+
+
+            switch (codec) {
+                case message_codec::RAW:
+                    return std::move(message);
+
+                case message_codec::DEFLATE_STREAM: {
+                    auto& inflater = inflaters[stream];
+                    if (!inflater) inflater.emplace();
+
+                    pooled_buffer result = buffer_pool::instance().acquire(std::min<std::size_t>(message.size() * 4, message_size_limit));
+
+                    // Messages are received from an untrusted remote, so malformed data or data that expands too much must not throw
+                    // on the I/O thread. The inflate stream can't be used after an error, but the session is stopped anyway.
+                    try {
+                        inflater->decompress(message, result.get(), 64_kib, message_size_limit);
+                    } catch (...) {
+                        return std::nullopt;
+                    }
+
+                    return result;
+                }
+
+                default:
+                    return std::nullopt;
+            }
+        }
+
+
+        void delay_message(message_t message, std::size_t stream) {
+            const auto now = steady_clock::now();
+
+            // Messages can't be sent faster than the bandwidth allows, so a message starts sending once the previous one has been sent.
+            link_free = std::max(link_free, now);
+
+            if (conditions.bandwidth > 0) {
+                link_free += nanoseconds { (message.size() * 1'000'000'000ull) / conditions.bandwidth };
+            }
+
+
+            auto release = link_free + conditions.latency;
+
+            if (conditions.jitter > nanoseconds { 0 }) {
+                release += duration_cast<nanoseconds>(conditions.jitter * cheaprand::random_real(0.0, 1.0));
+            }
+
+            if (conditions.loss > 0.0f && cheaprand::random_real(0.0f, 1.0f) < conditions.loss) {
+                release += conditions.retransmit_delay;
+            }
+
+            // A lost or jittered message holds back all messages after it.
+            release      = std::max(release, last_release);
+            last_release = release;
+
+
+            delayed_messages.push_back(delayed_message { release, stream, std::move(message) });
+            if (delayed_messages.size() == 1) await_delayed_message();
+        }
+
+
+        void await_delayed_message(void) {
+            delay_timer.expires_at(delayed_messages.front().release);
+            delay_timer.async_wait(strand.wrap(ve::bind_front(&socket_session::on_delay_elapsed, shared_from_this())));
+        }
+
+
+        void on_delay_elapsed(error_code error) {
+            if (error == asio::error::operation_aborted) return;
+
+
+            const auto now = steady_clock::now();
+
+            while (!delayed_messages.empty() && delayed_messages.front().release <= now) {
+                auto& [release, stream, message] = delayed_messages.front();
+
+                write_queues[stream].push_back(std::move(message));
+                delayed_messages.pop_front();
+            }
+
+            if (!flush_manually) do_async_write();
+            if (!delayed_messages.empty()) await_delayed_message();
+        }
+
+
         void do_async_write(void) {
             // Already writing or nothing to write. A new write will be started if the current write (if any) is done or
             // when a new write request is issued.
-            if (is_writing || write_queue.empty()) return;
+            if (is_writing || std::ranges::all_of(write_queues, [] (const auto& queue) { return queue.empty(); })) return;
 
 
             // Dispatch an error event for sending data over a closed session, since data being lost may be an issue.
@@ -126,15 +389,68 @@ namespace ve::connection {
 
 
             is_writing = true;
+            ++num_writes;
 
-            // Header is transferred in reverse so the last byte has its msb set, which we use to indicate the end of the header.
+
+            // Take frames from the highest priority stream with queued messages, until the batch is full.
+            // At least one frame is always sent, even if it exceeds the size limit.
+            std::size_t batch_bytes = 0;
+            write_frames.clear();
+
+            while (write_frames.size() < max_batch_messages && (write_frames.empty() || batch_bytes < max_batch_bytes)) {
+                auto queue = std::ranges::find_if(write_queues, [] (const auto& queue) { return !queue.empty(); });
+                if (queue == write_queues.end()) break;
+
+                const auto stream  = (u8) std::distance(write_queues.begin(), queue);
+                auto& message      = queue->front();
+                auto& offset       = write_offsets[stream];
+
+                const std::size_t size = std::min(max_frame_size, message.size() - offset);
+                const bool last        = (offset + size == message.size());
+
+                write_frames.push_back(frame { stream, last, std::span<const u8> { message.data() + offset, size } });
+                batch_bytes += size;
+                offset      += size;
+
+                if (last) {
+                    // Moving the message does not move its data, so the frame remains valid.
+                    write_batch.push_back(std::move(message));
+                    queue->pop_front();
+                    offset = 0;
+                }
+            }
+
+
+            // Headers are written to one buffer first, since its storage may be reallocated while it is being filled.
             write_header_buffer.clear();
-            serialize::encode_variable_length(write_queue.front().size(), write_header_buffer);
-            std::reverse(write_header_buffer.begin(), write_header_buffer.end());
+            std::vector<std::size_t> header_ends;
+            header_ends.reserve(write_frames.size());
+
+            for (const auto& frame : write_frames) {
+                const std::size_t header_begin = write_header_buffer.size();
+
+                // Header is transferred in reverse so the last byte has its msb set, which we use to indicate the end of the header.
+                serialize::encode_variable_length(frame.header(), write_header_buffer);
+                std::reverse(write_header_buffer.begin() + header_begin, write_header_buffer.end());
+
+                header_ends.push_back(write_header_buffer.size());
+            }
+
+
+            write_buffers.clear();
+            std::size_t header_begin = 0;
+
+            for (const auto& [frame, header_end] : views::zip(write_frames, header_ends)) {
+                write_buffers.push_back(asio::buffer(write_header_buffer.data() + header_begin, header_end - header_begin));
+                write_buffers.push_back(asio::buffer(frame.data.data(), frame.data.size()));
+
+                header_begin = header_end;
+            }
+
 
             asio::async_write(
                 socket,
-                std::array<asio::const_buffer, 2> { asio::buffer(write_header_buffer), asio::buffer(write_queue.front()) },
+                write_buffers,
                 // do_async_write and write need to happen on the same thread, so use a strand for the callback.
                 strand.wrap(ve::bind_front(&socket_session::on_async_write_complete, shared_from_this()))
             );
@@ -147,10 +463,15 @@ namespace ve::connection {
                 return stop();
             }
 
-            write_queue.pop();
+            VE_METRIC_COUNTER("ve_socket_messages_sent_total", "Number of messages sent over TCP sessions.").add(write_batch.size());
+            VE_METRIC_COUNTER("ve_socket_bytes_sent_total", "Number of bytes sent over TCP sessions, including frame headers.").add(n);
+
+            write_batch.clear();
             is_writing = false;
+            num_bytes_written += n;
 
-            do_async_write();
+            // If manual flushing is enabled, messages queued during this write are sent on the next flush.
+            if (!flush_manually) do_async_write();
         }
 
 
@@ -178,40 +499,75 @@ namespace ve::connection {
                 }
             }
 
+            num_bytes_read += n;
+            VE_METRIC_COUNTER("ve_socket_bytes_received_total", "Number of bytes received over TCP sessions, including frame headers.").add(n);
+
             // Header is transferred in reverse so the last byte has its msb set, which we use to indicate the end of the header.
             std::reverse(read_header_buffer.begin(), read_header_buffer.end());
-            auto span = std::span<const u8> { read_header_buffer.begin(), read_header_buffer.end() };
-            u64 message_size = serialize::decode_variable_length(span);
+            auto span   = std::span<const u8> { read_header_buffer.begin(), read_header_buffer.end() };
+            u64  header = serialize::decode_variable_length(span);
+
+            const u64  frame_size = header >> 3;
+            const auto stream     = (u8) ((header >> 1) & 0b11);
+            const bool last       = header & 1;
 
-            if (message_size > message_size_limit) {
+            if (stream >= num_message_priorities) [[unlikely]] {
+                dispatch_event(session_error_event { id, asio::error::invalid_argument });
+                return stop();
+            }
+
+
+            // The header is untrusted, so the frame size must be validated before any memory is allocated for it.
+            auto& buffer = read_buffers[stream];
+            const std::size_t message_size = buffer.size() + frame_size;
+
+            if (frame_size > max_frame_size || message_size > message_size_limit) [[unlikely]] {
                 dispatch_event(session_error_event { id, asio::error::message_size });
                 return stop();
             }
 
+            if (!buffer) buffer = buffer_pool::instance().acquire(frame_size);
 
-            read_buffer = make_shared<message_t>();
-            read_buffer->reserve(message_size);
 
+            // Frame is appended to any frames of the same message that were received before.
             asio::async_read(
                 socket,
-                asio::dynamic_buffer(*read_buffer),
-                asio::transfer_exactly(message_size),
-                ve::bind_front(&socket_session::on_async_read_complete, shared_from_this(), message_size)
+                asio::dynamic_buffer(buffer.get()),
+                asio::transfer_exactly(frame_size),
+                ve::bind_front(&socket_session::on_async_read_complete, shared_from_this(), stream, last, message_size)
             );
         }
 
 
-        void on_async_read_complete(u64 msg_size, error_code error, std::size_t n) {
+        void on_async_read_complete(u8 stream, bool last, std::size_t msg_size, error_code error, std::size_t n) {
             if (error) [[unlikely]] {
                 // EOF can still trigger if all data was received.
-                if (error != asio::error::eof || read_buffer->size() != msg_size) {
+                if (error != asio::error::eof || read_buffers[stream].size() != msg_size) {
                     dispatch_event(session_error_event { id, error });
                     return stop();
                 }
             }
 
+            num_bytes_read += n;
+            VE_METRIC_COUNTER("ve_socket_bytes_received_total", "Number of bytes received over TCP sessions, including frame headers.").add(n);
+
+            if (!last) return do_async_read();
+
+
+            auto message = decode_message(std::move(read_buffers[stream]), stream);
+
+            if (!message) [[unlikely]] {
+                dispatch_event(session_error_event { id, asio::error::invalid_argument });
+                return stop();
+            }
+
+
+            VE_METRIC_COUNTER("ve_socket_messages_received_total", "Number of messages received over TCP sessions.").add();
+
+            message_received_event event { id, std::move(*message) };
+            if (receive_hook) receive_hook(event);
 
-            dispatch_event(message_received_event { id, decompress(*read_buffer) });
+            received_messages.push(std::move(event));
             return do_async_read();
         }
     };
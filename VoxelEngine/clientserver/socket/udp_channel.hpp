@@ -0,0 +1,519 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/clientserver/instance_id.hpp>
+#include <VoxelEngine/clientserver/socket/defs.hpp>
+#include <VoxelEngine/utility/buffer_pool.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+#include <mutex>
+
+
+namespace ve::connection {
+    // Maximum number of message bytes in a single datagram. Larger messages are split into multiple fragments.
+    // This keeps datagrams below the MTU of most networks, since fragmentation at the IP level would cause an entire message to be lost
+    // if any fragment is lost, without the possibility of discarding stale fragments.
+    constexpr std::size_t max_datagram_payload = 1200;
+
+    // Fragment counts are taken from untrusted datagrams, so they are limited to bound the memory used to reassemble a message.
+    constexpr std::size_t max_fragments_per_message   = 64;
+    constexpr std::size_t max_unreliable_message_size = max_fragments_per_message * max_datagram_payload;
+
+    // Maximum number of streams tracked per peer. Datagrams for new streams beyond this number are dropped.
+    constexpr std::size_t max_streams_per_peer = 256;
+
+    // Bind requests are resent at this interval until they are acknowledged by the remote.
+    constexpr nanoseconds bind_retry_interval = 100ms;
+
+
+    struct datagram_received_event { instance_id sender; u32 stream; pooled_buffer message; };
+    struct peer_bound_event        { instance_id peer; };
+
+
+    // Unreliable, sequenced datagram channel, used next to the TCP sessions for data where only the most recent value matters.
+    // Messages may be lost, but are never delivered out of order: a message is dropped if a newer message on the same stream
+    // has already been delivered, and a message which is only partially received is dropped once a fragment of a newer message arrives.
+    //
+    // Peers are identified by their instance ID, which is exchanged over the TCP session when the connection is made.
+    // The accepting side must first expect the peer (expect_peer), after which the connecting side binds to it by sending its ID
+    // together with a secret. Since instance IDs are not secret, the bind secret should be unique for every peer and only be shared
+    // over the TCP session, so other hosts cannot bind in place of the peer. Datagrams from unknown or unbound peers are ignored.
+    class udp_channel : public dispatcher_t, public std::enable_shared_from_this<udp_channel> {
+    public:
+        ve_shared_only(udp_channel, instance_id local_id) :
+            dispatcher_t(),
+            std::enable_shared_from_this<udp_channel>(),
+            local_id(local_id),
+            socket(ctx)
+        {}
+
+        ~udp_channel(void) {
+            stop();
+        }
+
+        ve_immovable(udp_channel);
+
+
+        // Open the channel on the given port to accept binds from expected peers. If the port is zero, any free port is used.
+        void start(u16 port) {
+            open(asio::ip::udp::endpoint { asio::ip::udp::v6(), port });
+        }
+
+
+        // Open the channel on any free port and bind it to the given remote. Binding is retried on every update until the remote responds.
+        // The secret must be the one the remote passed to expect_peer.
+        // If the address cannot be resolved, an instance_error_event is raised and the channel is not started.
+        void start(instance_id remote, std::string_view address, u16 port, u64 bind_secret) {
+            asio::ip::udp::resolver resolver { ctx };
+            error_code error;
+
+            auto results = resolver.resolve(address, to_string(port), error);
+            if (!error && results.empty()) error = asio::error::host_not_found;
+
+            if (error) [[unlikely]] {
+                add_event(instance_error_event { error });
+                return;
+            }
+
+            auto endpoint = results.begin()->endpoint();
+
+            if (!open(asio::ip::udp::endpoint { endpoint.protocol(), 0 })) return;
+
+            std::lock_guard lock { peer_mtx };
+            peers.emplace(remote, peer { .endpoint = endpoint, .bind_secret = bind_secret, .accepts_binds = false });
+        }
+
+
+        // Note: this will dispatch any remaining events and should therefore be called from the same thread as update.
+        void stop(void) {
+            if (exited) return;
+            exited = true;
+
+
+            error_code error;
+            socket.close(error);
+
+            // Note: as with the socket client, the ordering of below actions is important to prevent race conditions.
+            ctx.run();
+            ctx.stop();
+
+            thread->join();
+            thread = std::nullopt;
+
+            ctx.restart();
+
+
+            {
+                std::lock_guard lock { peer_mtx };
+                peers.clear();
+            }
+
+            add_event(instance_end_event { });
+            update();
+        }
+
+
+        // Dispatches events and resends bind requests that have not yet been acknowledged.
+        void update(void) {
+            {
+                std::lock_guard lock { peer_mtx };
+
+                for (auto& [id, peer] : peers) {
+                    if (peer.bound || peer.accepts_binds || time_since(peer.last_bind_request) < bind_retry_interval) continue;
+
+                    peer.last_bind_request = steady_clock::now();
+                    send_control_packet(packet_type::BIND, peer.endpoint, peer.bind_secret);
+                }
+            }
+
+            dispatcher_t::dispatch_events();
+        }
+
+
+        // Allow the given peer to bind to this channel, if it provides the given secret.
+        void expect_peer(instance_id remote, u64 bind_secret) {
+            std::lock_guard lock { peer_mtx };
+            peers.emplace(remote, peer { .bind_secret = bind_secret, .accepts_binds = true });
+        }
+
+
+        // Creates a secret for expect_peer, which should be sent to the peer over its TCP session.
+        static u64 create_bind_secret(void) {
+            return std::bit_cast<u64>(random::generate_seed<sizeof(u64)>());
+        }
+
+
+        void remove_peer(instance_id remote) {
+            std::lock_guard lock { peer_mtx };
+            peers.erase(remote);
+        }
+
+
+        bool is_bound(instance_id remote) const {
+            std::lock_guard lock { peer_mtx };
+
+            auto it = peers.find(remote);
+            return it != peers.end() && it->second.bound;
+        }
+
+
+        // Sends a message to the given peer, splitting it into multiple datagrams if required.
+        // Messages on the same stream supersede each other: the remote will not deliver a message if it has already delivered a newer one.
+        // Returns false if the peer is not bound, in which case nothing is sent.
+        bool send(instance_id remote, std::span<const u8> message, u32 stream = 0) {
+            if (message.size() > max_unreliable_message_size) [[unlikely]] {
+                add_event(instance_error_event { asio::error::message_size });
+                return false;
+            }
+
+
+            asio::ip::udp::endpoint endpoint;
+            u32 sequence;
+
+            {
+                std::lock_guard lock { peer_mtx };
+
+                auto it = peers.find(remote);
+                if (it == peers.end() || !it->second.bound) return false;
+
+                auto& streams = it->second.streams;
+                if (!streams.contains(stream) && streams.size() >= max_streams_per_peer) [[unlikely]] {
+                    add_event(instance_error_event { asio::error::no_buffer_space });
+                    return false;
+                }
+
+                endpoint = it->second.endpoint;
+                sequence = streams[stream].next_sequence++;
+            }
+
+
+            // All datagrams are written into a single buffer, which is kept alive until they are sent.
+            const std::size_t fragment_count = std::max<std::size_t>(1, (message.size() + max_datagram_payload - 1) / max_datagram_payload);
+            auto datagrams = buffer_pool::instance().acquire(message.size() + fragment_count * sizeof(packet_header));
+
+            for (std::size_t i = 0; i < fragment_count; ++i) {
+                packet_header header {
+                    .sender         = local_id,
+                    .stream         = stream,
+                    .sequence       = sequence,
+                    .fragment_index = (u16) i,
+                    .fragment_count = (u16) fragment_count,
+                    .type           = packet_type::DATA
+                };
+
+                auto payload = message.subspan(i * max_datagram_payload, std::min(max_datagram_payload, message.size() - i * max_datagram_payload));
+
+                auto& data = datagrams.get();
+                data.insert(data.end(), (const u8*) &header, (const u8*) (&header + 1));
+                data.insert(data.end(), payload.begin(), payload.end());
+            }
+
+
+            asio::post(ctx, [self = shared_from_this(), datagrams = std::move(datagrams), endpoint] {
+                std::span<const u8> remaining = datagrams;
+
+                while (!remaining.empty()) {
+                    auto datagram = take_front_n(remaining, std::min(remaining.size(), sizeof(packet_header) + max_datagram_payload));
+
+                    // Errors are ignored, since the datagram is considered lost, which the receiver must be able to handle anyway.
+                    error_code error;
+                    self->socket.send_to(asio::buffer(datagram.data(), datagram.size()), endpoint, 0, error);
+                }
+            });
+
+            return true;
+        }
+
+
+        u16 get_port(void) const {
+            return socket.local_endpoint().port();
+        }
+
+
+        // Returns the number of messages and fragments dropped because a newer message on the same stream was already received.
+        u64 get_num_stale_dropped(void) const {
+            return num_stale_dropped;
+        }
+
+
+        VE_GET_VAL(local_id);
+    private:
+        enum class packet_type : u8 { DATA = 0, BIND = 1, BIND_ACK = 2 };
+
+
+        struct packet_header {
+            instance_id sender;
+            u32 stream;
+            u32 sequence;
+            u16 fragment_index;
+            u16 fragment_count;
+            packet_type type;
+            std::array<u8, 3> reserved { };
+        };
+
+        static_assert(std::is_trivially_copyable_v<packet_header>);
+
+
+        struct reassembly_state {
+            u32 sequence;
+            u16 fragment_count;
+            u16 fragments_received = 0;
+            std::size_t message_size = 0;
+            std::vector<bool> received;
+            pooled_buffer data;
+        };
+
+
+        struct stream_state {
+            u32 next_sequence = 0;
+            std::optional<u32> last_delivered;
+            std::optional<reassembly_state> reassembly;
+        };
+
+
+        struct peer {
+            asio::ip::udp::endpoint endpoint;
+            u64 bind_secret;
+            // True if this channel accepts binds from the peer, false if this channel binds to the peer.
+            bool accepts_binds;
+            bool bound = false;
+            steady_clock::time_point last_bind_request = epoch_time<steady_clock::time_point>();
+            hash_map<u32, stream_state> streams;
+        };
+
+
+        instance_id local_id;
+
+        asio::io_context ctx;
+        asio::ip::udp::socket socket;
+        std::optional<std::thread> thread;
+        std::atomic_bool exited = true;
+
+        mutable std::mutex peer_mtx;
+        hash_map<instance_id, peer> peers;
+
+        // Only used from the IO thread.
+        std::array<u8, 64 * 1024> receive_buffer;
+        asio::ip::udp::endpoint receive_endpoint;
+
+        std::atomic<u64> num_stale_dropped = 0;
+
+
+        bool open(const asio::ip::udp::endpoint& local) {
+            if (!exited) {
+                add_event(instance_error_event { asio::error::already_started });
+                return false;
+            }
+
+
+            error_code error;
+
+            socket.open(local.protocol(), error);
+            // Accept datagrams from IPv4 remotes as well.
+            if (!error && local.protocol() == asio::ip::udp::v6()) socket.set_option(asio::ip::v6_only(false), error);
+            if (!error) socket.bind(local, error);
+
+            if (error) [[unlikely]] {
+                add_event(instance_error_event { error });
+
+                socket.close(error);
+                return false;
+            }
+
+
+            exited = false;
+
+            do_async_receive();
+            thread = std::thread { [&] { while (!exited) ctx.run_one(); } };
+
+            add_event(instance_start_event { });
+            return true;
+        }
+
+
+        // Sends are performed on the IO thread, so they never run concurrently with other operations on the socket.
+        // Bind packets are followed by the bind secret.
+        void send_control_packet(packet_type type, const asio::ip::udp::endpoint& endpoint, u64 bind_secret = 0) {
+            packet_header header { .sender = local_id, .stream = 0, .sequence = 0, .fragment_index = 0, .fragment_count = 0, .type = type };
+
+            std::array<u8, sizeof(packet_header) + sizeof(u64)> packet;
+            std::memcpy(packet.data(), &header, sizeof(header));
+            std::memcpy(packet.data() + sizeof(header), &bind_secret, sizeof(bind_secret));
+
+            const std::size_t size = (type == packet_type::BIND) ? packet.size() : sizeof(packet_header);
+
+            asio::post(ctx, [self = shared_from_this(), packet, size, endpoint] {
+                error_code error;
+                self->socket.send_to(asio::buffer(packet.data(), size), endpoint, 0, error);
+            });
+        }
+
+
+        void do_async_receive(void) {
+            if (exited) return;
+
+            socket.async_receive_from(
+                asio::buffer(receive_buffer),
+                receive_endpoint,
+                ve::bind_front(&udp_channel::on_async_receive, shared_from_this())
+            );
+        }
+
+
+        void on_async_receive(error_code error, std::size_t n) {
+            if (error == asio::error::operation_aborted) return;
+
+            // Other errors only affect a single datagram (e.g. an ICMP port unreachable message from a peer that has disconnected),
+            // so keep receiving.
+            if (!error && n >= sizeof(packet_header)) {
+                on_datagram_received(std::span<const u8> { receive_buffer.data(), n });
+            }
+
+            do_async_receive();
+        }
+
+
+        void on_datagram_received(std::span<const u8> datagram) {
+            packet_header header;
+            std::memcpy(&header, take_front_n(datagram, sizeof(packet_header)).data(), sizeof(packet_header));
+
+
+            // Events are dispatched after the peer mutex is released, since event handlers may call back into the channel.
+            std::optional<peer_bound_event> bound_event;
+            std::optional<datagram_received_event> message_event;
+
+            {
+                std::lock_guard lock { peer_mtx };
+
+                auto it = peers.find(header.sender);
+                if (it == peers.end()) return;
+
+                auto& peer = it->second;
+
+
+                switch (header.type) {
+                    case packet_type::BIND: {
+                        if (!peer.accepts_binds || datagram.size() != sizeof(u64)) return;
+
+                        u64 secret;
+                        std::memcpy(&secret, datagram.data(), sizeof(secret));
+                        if (secret != peer.bind_secret) return;
+
+                        // The peer may rebind if its address changes, e.g. due to NAT.
+                        peer.endpoint = receive_endpoint;
+                        if (!std::exchange(peer.bound, true)) bound_event = peer_bound_event { header.sender };
+
+                        send_control_packet(packet_type::BIND_ACK, receive_endpoint);
+                        break;
+                    }
+
+                    case packet_type::BIND_ACK:
+                        if (peer.accepts_binds || receive_endpoint != peer.endpoint) return;
+                        if (!std::exchange(peer.bound, true)) bound_event = peer_bound_event { header.sender };
+
+                        break;
+
+                    case packet_type::DATA: {
+                        if (!peer.bound || receive_endpoint != peer.endpoint) return;
+
+                        auto stream = peer.streams.find(header.stream);
+
+                        if (stream == peer.streams.end()) {
+                            if (peer.streams.size() >= max_streams_per_peer) return;
+                            std::tie(stream, std::ignore) = peer.streams.emplace(header.stream, stream_state { });
+                        }
+
+                        if (auto message = on_fragment_received(header, datagram, stream->second); message) {
+                            message_event = datagram_received_event { header.sender, header.stream, std::move(*message) };
+                        }
+
+                        break;
+                    }
+
+                    default:
+                        return;
+                }
+            }
+
+
+            // Posting rather than adding events keeps the I/O thread from contending with the dispatching thread for the dispatcher's lock.
+            if (bound_event)   post_event(std::move(*bound_event));
+            if (message_event) post_event(std::move(*message_event));
+        }
+
+
+        // Returns the message if the fragment completes it.
+        std::optional<pooled_buffer> on_fragment_received(const packet_header& header, std::span<const u8> payload, stream_state& stream) {
+            // Sequence numbers are compared with wraparound, so the comparison is valid as long as the numbers are less than 2^31 apart.
+            auto is_newer = [] (u32 a, u32 b) { return (i32) (a - b) > 0; };
+
+            if (stream.last_delivered && !is_newer(header.sequence, *stream.last_delivered)) {
+                ++num_stale_dropped;
+                return std::nullopt;
+            }
+
+
+            // Validate the fragment: all fragments except the last one must be completely filled.
+            const bool is_last = (header.fragment_index + 1 == header.fragment_count);
+
+            if (
+                header.fragment_index >= header.fragment_count ||
+                header.fragment_count > max_fragments_per_message ||
+                payload.size() > max_datagram_payload ||
+                (!is_last && payload.size() != max_datagram_payload)
+            ) [[unlikely]] return std::nullopt;
+
+
+            if (header.fragment_count == 1) {
+                stream.last_delivered = header.sequence;
+
+                auto message = buffer_pool::instance().acquire(payload.size());
+                message.get().assign(payload.begin(), payload.end());
+
+                return message;
+            }
+
+
+            auto& state = stream.reassembly;
+
+            if (!state || state->sequence != header.sequence) {
+                if (state && is_newer(state->sequence, header.sequence)) {
+                    ++num_stale_dropped;
+                    return std::nullopt;
+                }
+
+                // Any message that was still being reassembled is older than this one, so it can be discarded.
+                state = reassembly_state {
+                    .sequence       = header.sequence,
+                    .fragment_count = header.fragment_count,
+                    .received       = std::vector<bool>(header.fragment_count, false),
+                    .data           = buffer_pool::instance().acquire(header.fragment_count * max_datagram_payload)
+                };
+
+                state->data.get().resize(header.fragment_count * max_datagram_payload);
+            }
+
+            if (header.fragment_count != state->fragment_count || state->received[header.fragment_index]) return std::nullopt;
+
+
+            state->received[header.fragment_index] = true;
+            ++state->fragments_received;
+
+            std::memcpy(state->data.get().data() + header.fragment_index * max_datagram_payload, payload.data(), payload.size());
+            if (is_last) state->message_size = header.fragment_index * max_datagram_payload + payload.size();
+
+
+            if (state->fragments_received == state->fragment_count) {
+                stream.last_delivered = header.sequence;
+
+                auto message = std::move(state->data);
+                message.get().resize(state->message_size);
+                state.reset();
+
+                return message;
+            }
+
+            return std::nullopt;
+        }
+    };
+}
\ No newline at end of file
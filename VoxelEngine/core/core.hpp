@@ -27,6 +27,7 @@
 #include <VoxelEngine/core/profiler.hpp>
 #include <VoxelEngine/core/range.hpp>
 #include <VoxelEngine/core/settings_preinclude.hpp>
+#include <VoxelEngine/core/trace_profiler.hpp>
 #include <VoxelEngine/core/typedef/chrono.hpp>
 #include <VoxelEngine/core/typedef/container.hpp>
 #include <VoxelEngine/core/typedef/function.hpp>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <VoxelEngine/core/platform.hpp>
+#include <VoxelEngine/core/trace_profiler.hpp>
 
 #include <optick.h>
 #include <boost/preprocessor.hpp>
@@ -9,7 +10,23 @@
 #define VE_IMPL_PROFILER_SAVE_PATH(Path) (Path).string().c_str()
 
 
-#if defined(VE_PROFILER)
+// Defining VE_PROFILER enables profiling with Optick.
+// If VE_PROFILER_TRACE is defined as well, the trace_profiler is used instead, which saves Chrome traces and does not require the Optick GUI.
+#if defined(VE_PROFILER) && defined(VE_PROFILER_TRACE)
+    #define VE_PROFILE_BEGIN() ve::trace_profiler::instance().start()
+    #define VE_PROFILE_END(...) ve::trace_profiler::instance().stop(__VA_ARGS__)
+
+    #define VE_PROFILE_FRAME(Name)                                     \
+    ve::trace_profiler::instance().on_frame();                         \
+    VE_PROFILE_FN(Name)
+
+    #define VE_PROFILE_FN(...)                                         \
+    ve::trace_scope BOOST_PP_CAT(ve_impl_trace_scope_, __LINE__) {     \
+        ve::detail::trace_scope_name(__func__ __VA_OPT__(,) __VA_ARGS__) \
+    }
+
+    #define VE_PROFILE_WORKER_THREAD(...) ve::trace_profiler::instance().set_thread_name(__VA_ARGS__)
+#elif defined(VE_PROFILER)
     #define VE_PROFILE_BEGIN() OPTICK_START_CAPTURE()
 
     #define VE_PROFILE_END(...)                                     \
@@ -14,6 +14,6 @@
 // This header can be used to define settings externally to include in the engine as part of the core header.
 // This can be used to overload different settings structs within engine code.
 // Note that the pre-include file may not include any engine headers itself, as this would produce a circular dependency.
-#ifndef VE_TESTING
+#if !defined(VE_TESTING) && !defined(VE_BENCHMARKING)
     #include <VEEngineSettings/preinclude.hpp>
 #endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include <VoxelEngine/core/trace_profiler.hpp>
+#include <VoxelEngine/utility/logger.hpp>
+#include <VoxelEngine/utility/string.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+
+namespace ve {
+    namespace detail {
+        // Threads only get a buffer once they record an event, so the name is stored separately until then.
+        thread_local const char* trace_thread_name = nullptr;
+
+
+        struct trace_buffer_owner {
+            trace_buffer* buffer = nullptr;
+
+            ~trace_buffer_owner(void) {
+                if (buffer) trace_profiler::instance().retire_buffer(buffer);
+            }
+        };
+
+        thread_local trace_buffer_owner trace_thread_buffer;
+
+
+        static void write_json_string(std::ostream& stream, std::string_view string) {
+            stream << '"';
+
+            for (char c : string) {
+                if (c == '"' || c == '\\') stream << '\\' << c;
+                else if ((unsigned char) c < 0x20) stream << ' ';
+                else stream << c;
+            }
+
+            stream << '"';
+        }
+
+
+        // Chrome traces use microseconds, but fractional values are allowed.
+        static void write_microseconds(std::ostream& stream, i64 ns) {
+            stream << (ns / 1000) << '.' << std::setw(3) << std::setfill('0') << (ns % 1000) << std::setfill(' ');
+        }
+    }
+
+
+    void trace_profiler::start(void) {
+        std::lock_guard lock { mtx };
+        if (std::exchange(started, true)) return;
+
+        start_time = steady_clock::now();
+        num_recording.fetch_add(1, std::memory_order_relaxed);
+    }
+
+
+    void trace_profiler::stop(const fs::path& path) {
+        std::unique_lock lock { mtx };
+        if (!std::exchange(started, false)) return;
+
+        const auto from = start_time;
+
+        lock.unlock();
+        if (!path.empty()) save(path, from, steady_clock::now());
+
+        // The recording only ends once it has been saved, so the buffers of threads that exit in the meantime aren't freed before that.
+        end_recording();
+    }
+
+
+    void trace_profiler::capture(nanoseconds duration, fs::path path) {
+        std::lock_guard lock { mtx };
+
+        // A new capture replaces any capture that is still pending.
+        if (!capture_state) num_recording.fetch_add(1, std::memory_order_relaxed);
+
+        const auto now = steady_clock::now();
+        capture_state = pending_capture { now, now + duration, std::move(path) };
+    }
+
+
+    void trace_profiler::write(std::ostream& stream, steady_clock::time_point from, steady_clock::time_point to) const {
+        std::lock_guard lock { mtx };
+
+        const i64 from_ns = from.time_since_epoch().count();
+        const i64 to_ns   = to.time_since_epoch().count();
+        bool first = true;
+
+        auto separate = [&] {
+            if (!std::exchange(first, false)) stream << ",\n";
+        };
+
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        for (const auto& buffer : buffers) {
+            if (const char* name = buffer->thread_name.load(std::memory_order_relaxed); name) {
+                separate();
+
+                stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_index << ",\"args\":{\"name\":";
+                detail::write_json_string(stream, name);
+                stream << "}}";
+            }
+
+
+            // The owning thread keeps recording while the buffer is copied, so slots that were overwritten during the copy are discarded afterwards.
+            const u64 written = buffer->written.load(std::memory_order_acquire);
+            const u64 oldest  = written > buffer->capacity ? written - buffer->capacity : 0;
+
+            struct copied_event { const char* name; i64 begin, end; };
+            std::vector<copied_event> events;
+            events.reserve(written - oldest);
+
+            for (u64 i = oldest; i < written; ++i) {
+                const auto& event = buffer->events[i % buffer->capacity];
+
+                events.push_back(copied_event {
+                    event.name.load(std::memory_order_relaxed),
+                    event.begin.load(std::memory_order_relaxed),
+                    event.end.load(std::memory_order_relaxed)
+                });
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const u64 started = buffer->started.load(std::memory_order_relaxed);
+            const u64 valid   = started > buffer->capacity ? started - buffer->capacity : 0;
+
+
+            for (u64 i = std::max(oldest, valid); i < written; ++i) {
+                const auto& event = events[i - oldest];
+                if (event.begin < from_ns || event.end > to_ns) continue;
+
+                separate();
+
+                stream << "{\"name\":";
+                detail::write_json_string(stream, event.name);
+                stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index << ",\"ts\":";
+                detail::write_microseconds(stream, event.begin - from_ns);
+                stream << ",\"dur\":";
+                detail::write_microseconds(stream, event.end - event.begin);
+                stream << "}";
+            }
+        }
+
+        stream << "\n]}\n";
+    }
+
+
+    void trace_profiler::on_frame(void) {
+        if (!is_recording()) return;
+
+        // Frames are marked from the main thread.
+        if (!detail::trace_thread_name) set_thread_name("Main Thread");
+
+
+        std::unique_lock lock { mtx };
+        if (!capture_state || steady_clock::now() < capture_state->end) return;
+
+        auto completed = std::move(*capture_state);
+        capture_state.reset();
+
+        lock.unlock();
+        save(completed.path, completed.start, completed.end);
+
+        end_recording();
+    }
+
+
+    void trace_profiler::set_thread_name(const char* name) {
+        detail::trace_thread_name = name;
+        if (auto* buffer = detail::trace_thread_buffer.buffer; buffer) buffer->thread_name.store(name, std::memory_order_relaxed);
+    }
+
+
+    detail::trace_buffer& trace_profiler::local_buffer(void) {
+        auto& owner = detail::trace_thread_buffer;
+
+        if (!owner.buffer) [[unlikely]] {
+            std::lock_guard lock { mtx };
+
+            auto& buffer = buffers.emplace_back(make_unique<detail::trace_buffer>(
+                events_per_thread.load(std::memory_order_relaxed),
+                next_thread_index++
+            ));
+
+            buffer->thread_name.store(detail::trace_thread_name, std::memory_order_relaxed);
+            owner.buffer = buffer.get();
+        }
+
+        return *owner.buffer;
+    }
+
+
+    void trace_profiler::retire_buffer(detail::trace_buffer* buffer) {
+        {
+            std::lock_guard lock { mtx };
+            buffer->retired = true;
+        }
+
+        free_retired_buffers();
+    }
+
+
+    void trace_profiler::end_recording(void) {
+        num_recording.fetch_sub(1, std::memory_order_relaxed);
+        free_retired_buffers();
+    }
+
+
+    // Events are only recorded while recording, and a new recording never includes events from before it started,
+    // so once nothing is being recorded, the events of exited threads can no longer end up in a trace.
+    void trace_profiler::free_retired_buffers(void) {
+        std::lock_guard lock { mtx };
+        if (is_recording()) return;
+
+        std::erase_if(buffers, [] (const auto& buffer) { return buffer->retired; });
+    }
+
+
+    void trace_profiler::save(const fs::path& path, steady_clock::time_point from, steady_clock::time_point to) const {
+        auto json_path = path;
+        json_path.replace_extension(".json");
+
+        std::ofstream stream { json_path, std::ios::trunc };
+        write(stream, from, to);
+
+        if (stream) VE_LOG_INFO(cat("Saved trace to ", json_path, "."));
+        else VE_LOG_ERROR(cat("Failed to save trace to ", json_path, "."));
+    }
+}
\ No newline at end of file
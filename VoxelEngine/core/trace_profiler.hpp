@@ -0,0 +1,172 @@
+#pragma once
+
+#include <VoxelEngine/core/includes.hpp>
+#include <VoxelEngine/core/codegen/move.hpp>
+#include <VoxelEngine/core/typedef/chrono.hpp>
+#include <VoxelEngine/core/typedef/pointer.hpp>
+#include <VoxelEngine/core/typedef/scalar.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+
+
+namespace ve {
+    namespace detail {
+        struct trace_event {
+            std::atomic<const char*> name;
+            std::atomic<i64> begin, end;
+        };
+
+
+        // Fixed-size ring buffer of completed events, written only by its owning thread.
+        // Once the buffer is full, new events overwrite the oldest ones, so memory usage is bounded regardless of capture length.
+        struct trace_buffer {
+            unique<trace_event[]> events;
+            std::size_t capacity;
+            u32 thread_index;
+            std::atomic<const char*> thread_name = nullptr;
+            // Set when the owning thread exits. Guarded by the mutex of the trace profiler.
+            bool retired = false;
+
+            // Writes to slot n start by setting started to n + 1, and are published by setting written to n + 1.
+            // Readers use started to detect slots that were overwritten while they were being copied.
+            std::atomic<u64> started = 0, written = 0;
+
+
+            trace_buffer(std::size_t capacity, u32 thread_index) :
+                events(make_unique<trace_event[]>(capacity)), capacity(capacity), thread_index(thread_index)
+            {}
+
+
+            void push(const char* name, i64 begin, i64 end) {
+                const u64 index = written.load(std::memory_order_relaxed);
+
+                started.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                auto& event = events[index % capacity];
+                event.name.store(name, std::memory_order_relaxed);
+                event.begin.store(begin, std::memory_order_relaxed);
+                event.end.store(end, std::memory_order_relaxed);
+
+                written.store(index + 1, std::memory_order_release);
+            }
+        };
+
+
+        // Thread-local handle to the buffer of a thread, which retires the buffer when the thread exits.
+        struct trace_buffer_owner;
+    }
+
+
+    // Lightweight profiler that records scopes into per-thread ring buffers and saves them as Chrome Trace Event JSON,
+    // which can be viewed in chrome://tracing or Perfetto. Unlike Optick, this does not require a GUI to capture a trace,
+    // so it can be used on headless servers. Used by the VE_PROFILE macros if VE_PROFILER_TRACE is defined.
+    class trace_profiler {
+    public:
+        constexpr static inline std::size_t default_events_per_thread = 1 << 16;
+
+
+        static trace_profiler& instance(void) {
+            // The profiler is never destroyed, since threads that are joined during static destruction may still retire their buffer.
+            static trace_profiler* i = new trace_profiler();
+            return *i;
+        }
+
+        ve_immovable(trace_profiler);
+
+
+        // Starts recording until stop is called. Only the most recent events of each thread are kept.
+        void start(void);
+
+        // Stops recording and, if a path is given, saves the recorded events to it. The extension of the path is replaced with .json.
+        void stop(const fs::path& path = {});
+
+        // Records events for the given duration and then saves them to the given path, without interrupting a recording started with start.
+        // The capture is completed by the first frame marker after the duration has elapsed.
+        void capture(nanoseconds duration, fs::path path);
+
+        // Writes all events recorded between the given times as Chrome Trace Event JSON.
+        void write(std::ostream& stream, steady_clock::time_point from, steady_clock::time_point to) const;
+
+
+        // Called at the start of every frame. Completes any capture of which the duration has elapsed.
+        void on_frame(void);
+
+        // Sets the name shown for the calling thread in the trace. The name must have static storage duration.
+        void set_thread_name(const char* name = "Worker Thread");
+
+        // Sets the size of the ring buffer for threads that have not recorded any events yet.
+        void set_events_per_thread(std::size_t count) {
+            events_per_thread.store(std::max<std::size_t>(count, 1), std::memory_order_relaxed);
+        }
+
+
+        bool is_recording(void) const {
+            return num_recording.load(std::memory_order_relaxed) > 0;
+        }
+
+
+        // Names must have static storage duration, since only a pointer to them is stored.
+        void record(const char* name, steady_clock::time_point begin, steady_clock::time_point end) {
+            local_buffer().push(name, begin.time_since_epoch().count(), end.time_since_epoch().count());
+        }
+    private:
+        struct pending_capture {
+            steady_clock::time_point start, end;
+            fs::path path;
+        };
+
+
+        // Number of active recordings, i.e. one for start and one for a pending capture.
+        std::atomic<u32> num_recording = 0;
+        std::atomic<std::size_t> events_per_thread = default_events_per_thread;
+
+        mutable std::mutex mtx;
+        bool started = false;
+        steady_clock::time_point start_time;
+        std::optional<pending_capture> capture_state;
+
+        // Buffers are kept after their thread exits while a recording is active, so its events can still be saved.
+        // Once nothing is being recorded, the buffers of exited threads are freed.
+        std::vector<unique<detail::trace_buffer>> buffers;
+        u32 next_thread_index = 0;
+
+
+        trace_profiler(void) = default;
+
+        friend struct detail::trace_buffer_owner;
+
+        detail::trace_buffer& local_buffer(void);
+        void retire_buffer(detail::trace_buffer* buffer);
+        void end_recording(void);
+        void free_retired_buffers(void);
+        void save(const fs::path& path, steady_clock::time_point from, steady_clock::time_point to) const;
+    };
+
+
+    namespace detail {
+        // Scopes are named after the enclosing function, unless a name is given.
+        constexpr const char* trace_scope_name(const char* function) { return function; }
+        constexpr const char* trace_scope_name(const char*, const char* name) { return name; }
+    }
+
+
+    // Records the time between its construction and destruction as an event, if the trace profiler is recording.
+    class trace_scope {
+    public:
+        explicit trace_scope(const char* name) : name(name) {
+            if (trace_profiler::instance().is_recording()) begin = steady_clock::now();
+        }
+
+        ~trace_scope(void) {
+            if (begin) trace_profiler::instance().record(name, *begin, steady_clock::now());
+        }
+
+        ve_immovable(trace_scope);
+    private:
+        const char* name;
+        std::optional<steady_clock::time_point> begin;
+    };
+}
\ No newline at end of file
@@ -16,6 +16,10 @@ namespace ve::component_tags {
     template <typename Component> constexpr static bool is_synchronizable_v =
         !requires { typename Component::non_synchronizable_tag; };
 
+    // Checks if the component should be included in registry snapshots, assuming it is serializable.
+    template <typename Component> constexpr static bool is_snapshottable_v =
+        !requires { typename Component::non_snapshottable_tag; };
+
     // Checks if a component can be removed from an entity once it is added.
     template <typename Component> constexpr static bool is_removable_v =
         !requires { typename Component::non_removable_tag; };
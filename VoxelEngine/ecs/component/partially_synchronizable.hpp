@@ -61,12 +61,16 @@ namespace ve {
 
         // partially_synchronizable class is made serializable so that it can automatically be created / destroyed using system_synchronizer.
         // No data is actually serialized by these methods.
-        void to_bytes(std::vector<u8>& dst) const {}
+        void to_bytes(auto& dst) const {}
 
-        static Derived from_bytes(std::span<const u8>& src) {
+        static Derived from_bytes(auto& src) {
             return Derived {};
         }
 
+        std::size_t serialized_size(void) const {
+            return 0;
+        }
+
 
         // Automatically set the connection to send messages on when the component is used by some instance.
         void on_component_added(registry& owner, entt::entity entity) {
@@ -89,7 +93,10 @@ namespace ve {
 
 
         // Sends the given message to the version of this component on the given remote.
-        template <typename Msg> void send_message(const Msg& msg, instance_id remote) {
+        // Messages of different priorities may arrive in a different order than they were sent (See message_priority).
+        // Components are created on remotes by messages of normal priority, so messages of a lower priority may arrive before the component exists,
+        // in which case they are dropped.
+        template <typename Msg> void send_message(const Msg& msg, instance_id remote, message_priority priority = message_priority::NORMAL) {
             VE_DEBUG_ASSERT(owner, "Cannot send message from partially_synchronized component which does not belong to any entity.");
 
             detail::autoregister_ps_message<detail::type_pair<Derived, Msg>>();
@@ -100,14 +107,16 @@ namespace ve {
                     .data = serialize::to_bytes(msg),
                     .message_type = type_hash<detail::type_pair<Derived, Msg>>(),
                     .entity = entt::to_entity(owner->get_storage(), (Derived&) *this)
-                }
+                },
+                priority
             );
         }
 
 
         // Sends the given message to the version of this component on every remote that can see this component.
         // (As determined by the synchronization system that manages this component.)
-        template <typename Msg> void broadcast_message(const Msg& msg) {
+        // The same ordering restrictions as for send_message apply.
+        template <typename Msg> void broadcast_message(const Msg& msg, message_priority priority = message_priority::NORMAL) {
             if (!owner) return;
 
             detail::autoregister_ps_message<detail::type_pair<Derived, Msg>>();
@@ -121,7 +130,8 @@ namespace ve {
             for (const auto& remote : get_visible_remotes()) {
                 owner->get_connection(remote)->send_message(
                     core_message_types::MSG_PARTIAL_SYNC,
-                    sync_msg
+                    sync_msg,
+                    priority
                 );
             }
         }
@@ -168,9 +178,11 @@ namespace ve {
         template <typename Derived, typename Msg>
         fn<void, instance&, entt::entity, std::span<const u8>, instance_id> create_invoke_on_received_fn(void) {
             return [](instance& i, entt::entity e, std::span<const u8> message, instance_id remote) {
-                auto& component = i.template get_component<Derived>(e);
+                // A message of a different priority than the one that created or removed the component may arrive before or after it exists.
+                auto* component = i.template try_get_component<Derived>(e);
+                if (!component) return;
 
-                component.on_message_received(
+                component->on_message_received(
                     serialize::from_bytes<Msg>(message),
                     remote
                 );
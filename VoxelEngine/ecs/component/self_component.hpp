@@ -9,8 +9,9 @@ namespace ve {
 
     // Used by static_entities to interface with their associated instance.
     struct self_component {
-        using non_syncable_tag  = void;
-        using non_removable_tag = void;
+        using non_syncable_tag      = void;
+        using non_removable_tag     = void;
+        using non_snapshottable_tag = void; // Pointer is meaningless outside the current process.
 
         static_entity* self = nullptr;
     };
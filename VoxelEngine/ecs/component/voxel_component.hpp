@@ -26,14 +26,17 @@ namespace ve {
 
     public:
         using constant_address_tag = void;
+        using non_snapshottable_tag = void; // The voxel space is not part of the serialized component, so there is nothing to restore.
 
 
         voxel_component(bool host = false, shared<voxel::chunk_generator> generator = nullptr) : host(host) {
             if (host) {
                 VE_DEBUG_ASSERT(generator, "A chunk generator should be provided for the hosting voxel space.");
 
+                // The host does not render the space, so it is created without meshing or GPU-side buffers.
+                // TODO: Find a more robust way to do this, this will break on unified instances.
                 loader = std::move(generator);
-                space  = voxel::voxel_space::create(loader);
+                space  = voxel::voxel_space::create(loader, false);
             } else {
                 auto remote_generator = make_shared<voxel::remote_loader>();
 
@@ -42,13 +45,13 @@ namespace ve {
 
                 space->add_chunk_loader(std::move(remote_generator));
             }
-
-            // TODO: Find a more robust way to do this, this will break on unified instances.
-            space->toggle_meshing(!host);
         }
 
 
         void on_component_added_wrapped(registry& owner, entt::entity entity) {
+            // All voxel messages are sent with normal priority, since they must be applied in the order they were sent,
+            // e.g. a voxel change must not be overwritten by an earlier chunk load, and they must not arrive before the component is created,
+            // which is synchronized with normal priority as well. Large chunk messages can still be overtaken by high priority messages.
             on_chunk_load = space->add_raw_handler([this] (const voxel::chunk_loaded_event& e) {
                 broadcast_message(chunk_load_message { .where = e.chunkpos, .data = e.chunk->get_chunk_data() });
             });
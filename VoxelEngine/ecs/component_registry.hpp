@@ -2,10 +2,12 @@
 
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/ecs/change_validator.hpp>
+#include <VoxelEngine/ecs/component/component_tags.hpp>
 #include <VoxelEngine/clientserver/instance_id.hpp>
 #include <VoxelEngine/utility/type_registry.hpp>
 #include <VoxelEngine/utility/traits/value.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/utility/io/serialize/delta_serializer.hpp>
 
 
 namespace ve {
@@ -15,9 +17,12 @@ namespace ve {
     namespace registry_callbacks {
         template <typename T> void set_component   (registry& r, entt::entity e, T&& v);
         template <typename T> T&   get_component   (registry& r, entt::entity e);
+        template <typename T> T*   try_get_component(registry& r, entt::entity e);
         template <typename T> void remove_component(registry& r, entt::entity e);
         template <typename T> std::pair<change_result, T*> set_component_checked   (instance_id remote, registry& r, entt::entity e, T&& v);
         template <typename T> std::pair<change_result, T*> remove_component_checked(instance_id remote, registry& r, entt::entity e);
+        template <typename T> bool write_snapshot_column  (const registry& r, std::vector<u8>& dest);
+        template <typename T> void restore_snapshot_column(registry& r, std::span<const u8> src);
     }
 
 
@@ -47,6 +52,40 @@ namespace ve {
                 }
             };
 
+            if constexpr (std::is_copy_constructible_v<T>) {
+                apply_delta_checked = [] (instance_id remote, registry& r, entt::entity e, u64 baseline_hash, std::span<const u8> v) {
+                    using result_t = std::optional<std::pair<change_result, std::vector<u8>>>;
+
+                    // Deltas can only be applied to an existing value. If the component doesn't exist (anymore), ignore the change.
+                    const T* current = registry_callbacks::try_get_component<T>(r, e);
+                    if (!current) return result_t { std::pair { change_result::UNOBSERVABLE, std::vector<u8>{} } };
+
+                    // Applying the delta to a different value than the one it was created against would result in a mix of both values.
+                    if (serialize::baseline_hash(*current) != baseline_hash) return result_t { std::nullopt };
+
+                    T value = *current;
+                    serialize::apply_delta(value, v);
+
+                    auto result = registry_callbacks::set_component_checked<T>(remote, r, e, std::move(value));
+
+                    if (result.first == change_result::FORBIDDEN) {
+                        return result_t { std::pair { result.first, serialize::to_bytes(*result.second) } };
+                    } else {
+                        return result_t { std::pair { result.first, std::vector<u8>{} } };
+                    }
+                };
+            }
+
+            if constexpr (component_tags::is_snapshottable_v<T>) {
+                write_snapshot_column = [] (const registry& r, std::vector<u8>& dest) {
+                    return registry_callbacks::write_snapshot_column<T>(r, dest);
+                };
+
+                restore_snapshot_column = [] (registry& r, std::span<const u8> src) {
+                    registry_callbacks::restore_snapshot_column<T>(r, src);
+                };
+            }
+
             remove_component_checked = [] (instance_id remote, registry& r, entt::entity e) {
                 auto result = registry_callbacks::remove_component_checked<T>(remote, r, e);
 
@@ -67,6 +106,14 @@ namespace ve {
         // This is because this is the only situation where the old value has to be sent back to the remote.
         fn<std::pair<change_result, std::vector<u8>>, instance_id, registry&, entt::entity, std::span<const u8>> set_component_checked;
         fn<std::pair<change_result, std::vector<u8>>, instance_id, registry&, entt::entity> remove_component_checked;
+        // Applies a delta created with serialize::delta_to_bytes to the current value of the component. Null for non-copyable components.
+        // Returns std::nullopt without applying the delta if the current value does not match the given serialize::baseline_hash.
+        fn<std::optional<std::pair<change_result, std::vector<u8>>>, instance_id, registry&, entt::entity, u64, std::span<const u8>> apply_delta_checked = nullptr;
+
+        // Writes all components of this type to a column of a registry_snapshot. Returns false if there are no components to write.
+        // Null for components that should not be snapshotted.
+        fn<bool, const registry&, std::vector<u8>&> write_snapshot_column = nullptr;
+        fn<void, registry&, std::span<const u8>> restore_snapshot_column = nullptr;
     };
 
 
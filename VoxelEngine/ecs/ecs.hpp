@@ -22,6 +22,7 @@
 #include <VoxelEngine/ecs/entt_include.hpp>
 #include <VoxelEngine/ecs/registry.hpp>
 #include <VoxelEngine/ecs/registry_helpers.hpp>
+#include <VoxelEngine/ecs/registry_snapshot.hpp>
 #include <VoxelEngine/ecs/system/system.hpp>
 #include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
 #include <VoxelEngine/ecs/system/system_mixin.hpp>
@@ -29,6 +30,7 @@
 #include <VoxelEngine/ecs/system/system_remote_initializer.hpp>
 #include <VoxelEngine/ecs/system/system_renderer.hpp>
 #include <VoxelEngine/ecs/system/system_renderer_mixins.hpp>
+#include <VoxelEngine/ecs/system/system_spatial_visibility.hpp>
 #include <VoxelEngine/ecs/system/system_synchronizer.hpp>
 #include <VoxelEngine/ecs/system/system_updater.hpp>
 #include <VoxelEngine/ecs/system/system_utils.hpp>
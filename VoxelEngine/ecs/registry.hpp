@@ -5,6 +5,7 @@
 #include <VoxelEngine/ecs/view.hpp>
 #include <VoxelEngine/ecs/component_registry.hpp>
 #include <VoxelEngine/ecs/registry_helpers.hpp>
+#include <VoxelEngine/ecs/registry_snapshot.hpp>
 #include <VoxelEngine/ecs/system/system.hpp>
 #include <VoxelEngine/ecs/component/component_tags.hpp>
 #include <VoxelEngine/event/simple_event_dispatcher.hpp>
@@ -104,24 +105,57 @@ namespace ve {
 
         // It is allowed, but not required, to store a static entity within the registry containing its components.
         // If this is done, the static entity will be automatically destroyed when the underlying entity is destroyed.
+        // Static entities are stored per type, so iterating over all entities of one type (see for_each_static_entity) is cache friendly.
         template <typename Entity> requires std::is_base_of_v<static_entity, Entity>
         Entity& store_static_entity(Entity&& entity) {
             entt::entity id = entity.get_id();
+            VE_DEBUG_ASSERT(!static_entity_locations.contains(id), "Attempt to store the same static entity twice.");
 
-            auto [it, success] = static_entities.emplace(
-                id,
-                make_unique<detail::static_entity_storage<Entity>>(std::move(entity))
-            );
+            auto& pool = get_static_entity_pool<Entity>();
+            auto [slot, stored] = pool.emplace(std::move(entity));
+
+            static_entity_locations.emplace(id, detail::static_entity_location { &pool, slot });
+            return *stored;
+        }
+
+
+        // Returns the static entity stored for the given entity, or nullptr if there is none or it is not of the given type.
+        template <typename Entity> requires std::is_base_of_v<static_entity, Entity>
+        Entity* try_get_static_entity(entt::entity entity) {
+            if (!static_entity_locations.contains(entity)) return nullptr;
+
+            const auto& location = static_entity_locations.get(entity);
+            auto it = static_entity_pools.find(type_hash<Entity>());
+
+            if (it == static_entity_pools.end() || it->second.get() != location.pool) return nullptr;
+            return &((detail::static_entity_pool<Entity>*) location.pool)->get(location.slot);
+        }
 
-            return ((detail::static_entity_storage<Entity>*) it->second.get())->entity;
+
+        template <typename Entity> requires std::is_base_of_v<static_entity, Entity>
+        const Entity* try_get_static_entity(entt::entity entity) const {
+            return const_cast<registry*>(this)->template try_get_static_entity<Entity>(entity);
+        }
+
+
+        // Invokes the given function for every static entity of the given type stored in this registry.
+        // Entities may not be stored or destroyed from within the callback.
+        template <typename Entity, typename F> requires std::is_base_of_v<static_entity, Entity>
+        void for_each_static_entity(F&& fn) {
+            if (auto it = static_entity_pools.find(type_hash<Entity>()); it != static_entity_pools.end()) {
+                ((detail::static_entity_pool<Entity>*) it->second.get())->for_each(fwd(fn));
+            }
         }
 
 
         void destroy_entity(entt::entity entity) {
             dispatch_event(entity_destroyed_event { this, entity });
 
-            if (auto it = static_entities.find(entity); it != static_entities.end()) {
-                static_entities.erase(it);
+            if (static_entity_locations.contains(entity)) {
+                auto location = static_entity_locations.get(entity);
+                static_entity_locations.erase(entity);
+
+                location.pool->erase(location.slot);
             }
 
             storage.destroy(entity);
@@ -332,6 +366,99 @@ namespace ve {
         }
 
 
+        // Snapshots
+        // Creates a snapshot of all entities in the registry and all their serializable components.
+        registry_snapshot take_snapshot(void) const {
+            registry_snapshot snapshot;
+            storage.each([&] (entt::entity entity) { snapshot.entities.push_back(entity); });
+
+            for (const auto& [type, data] : component_registry::instance().get_storage()) {
+                if (!data.write_snapshot_column) continue;
+
+                std::vector<u8> column;
+                if (data.write_snapshot_column(*this, column)) {
+                    snapshot.columns.push_back(registry_snapshot::component_column { type, std::move(column) });
+                }
+            }
+
+            return snapshot;
+        }
+
+
+        // Recreates the entities and components from the given snapshot in this registry. Entities keep the same ID they had in the snapshot.
+        // Components are inserted in bulk one column at a time, and events for the inserted components are dispatched after each column.
+        // Entities from the snapshot may not already exist in this registry.
+        void restore_snapshot(const registry_snapshot& snapshot) {
+            for (auto entity : snapshot.entities) {
+                [[maybe_unused]] auto created = storage.create(entity);
+                VE_ASSERT(created == entity, "Attempt to restore snapshot with an entity that already exists in the registry.");
+
+                dispatch_event(entity_created_event { this, entity });
+            }
+
+            const auto& component_types = component_registry::instance().get_storage();
+
+            for (const auto& column : snapshot.columns) {
+                // The snapshot may have been taken by a program with different component types, so unknown columns are skipped.
+                auto it = component_types.find(column.component_type);
+
+                if (it == component_types.end() || !it->second.restore_snapshot_column) {
+                    VE_LOG_WARN(cat("Skipping snapshot column for unknown or non-snapshottable component type ", column.component_type, "."));
+                    continue;
+                }
+
+                it->second.restore_snapshot_column(*this, std::span { column.data.begin(), column.data.end() });
+            }
+        }
+
+
+        template <typename Component> bool write_snapshot_column(std::vector<u8>& dest) const {
+            const auto& component_storage = storage.template storage<Component>();
+            if (component_storage.empty()) return false;
+
+            detail::write_snapshot_column(component_storage, dest);
+            return true;
+        }
+
+
+        template <typename Component> void restore_snapshot_column(std::span<const u8> src) {
+            std::vector<entt::entity> entities;
+            std::vector<Component> components;
+            detail::read_snapshot_column(src, entities, components);
+
+            auto& component_storage = storage.template storage<Component>();
+
+            // Storages of empty types only store entities, so there is no stored component to pass to callbacks and events either.
+            if constexpr (std::is_empty_v<Component>) {
+                component_storage.insert(entities.begin(), entities.end());
+
+                const Component value { };
+
+                if constexpr (component_tags::has_added_callback_v<Component>) {
+                    for (auto entity : entities) Component { }.on_component_added(*this, entity);
+                }
+
+                if (has_handlers_for<component_created_event<Component>>()) {
+                    for (auto entity : entities) dispatch_event(component_created_event<Component> { this, entity, &value });
+                }
+            } else {
+                component_storage.insert(entities.begin(), entities.end(), std::make_move_iterator(components.begin()));
+
+
+                if constexpr (component_tags::has_added_callback_v<Component>) {
+                    for (auto entity : entities) component_storage.get(entity).on_component_added(*this, entity);
+                }
+
+                // Skip event handling if there are no handlers.
+                if (has_handlers_for<component_created_event<Component>>()) {
+                    for (auto entity : entities) {
+                        dispatch_event(component_created_event<Component> { this, entity, &component_storage.get(entity) });
+                    }
+                }
+            }
+        }
+
+
         VE_GET_MREF(validator);
         // Note: acting upon the storage directly will cause events to not be fired, and should be avoided, as systems may depend on them.
         VE_GET_MREF(storage);
@@ -357,9 +484,17 @@ namespace ve {
         change_validator validator;
 
 
-        // TODO: Better cache locality would probably help here, since a system is likely to iterate over many of the same type of static entity in order.
-        // Consider using entt::storage with ve::stack_polymorph instead (with a fallback for very large entities), or store entities on a per-type basis.
-        hash_map<entt::entity, unique<detail::static_entity_storage_base>> static_entities;
+        template <typename Entity> detail::static_entity_pool<Entity>& get_static_entity_pool(void) {
+            auto& pool = static_entity_pools[type_hash<Entity>()];
+            if (!pool) pool = make_unique<detail::static_entity_pool<Entity>>();
+
+            return *((detail::static_entity_pool<Entity>*) pool.get());
+        }
+
+
+        // Note: pools must be declared before storage, so static entities are destroyed after their components.
+        hash_map<u64, unique<detail::static_entity_pool_base>> static_entity_pools;
+        entt::storage<detail::static_entity_location> static_entity_locations;
         entt::registry storage;
 
 
@@ -382,6 +517,11 @@ namespace ve {
         }
 
 
+        template <typename T> T* try_get_component(registry& r, entt::entity e) {
+            return r.template try_get_component<T>(e);
+        }
+
+
         template <typename T> void remove_component(registry& r, entt::entity e) {
             if constexpr (component_tags::is_removable_v<T>) r.template remove_component<T>(e);
             else VE_ASSERT(false, "Attempt to remove non-removable component");
@@ -396,5 +536,15 @@ namespace ve {
         template <typename T> std::pair<change_result, T*> remove_component_checked(instance_id remote, registry& r, entt::entity e) {
             return r.template remove_component_checked<T>(remote, e);
         }
+
+
+        template <typename T> bool write_snapshot_column(const registry& r, std::vector<u8>& dest) {
+            return r.template write_snapshot_column<T>(dest);
+        }
+
+
+        template <typename T> void restore_snapshot_column(registry& r, std::span<const u8> src) {
+            r.template restore_snapshot_column<T>(src);
+        }
     }
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/assert.hpp>
 
 #include <VoxelEngine/ecs/entt_include.hpp>
 
+#include <bitset>
+#include <new>
+
 
 namespace ve {
     class registry;
@@ -48,13 +52,113 @@ namespace ve::detail {
 
     // Storage for static entities.
     // Wrapper is required since static_entity does not provide a virtual destructor.
-    struct static_entity_storage_base {
-        virtual ~static_entity_storage_base(void) = default;
+    struct static_entity_pool_base {
+        virtual ~static_entity_pool_base(void) = default;
+        virtual void erase(u32 slot) = 0;
+    };
+
+
+    // Static entities of the same type are stored contiguously in fixed-size slabs, so iterating over them is cache friendly.
+    // Slabs are never reallocated, so entities keep the same address for as long as they exist,
+    // which is required since the self_component of the entity points to it.
+    template <typename Entity> class static_entity_pool : public static_entity_pool_base {
+    public:
+        // Aim for slabs of around 64KiB, so allocations are rare without wasting too much memory on rarely used types.
+        constexpr static std::size_t slab_size = std::max<std::size_t>(1, (64 * 1024) / sizeof(Entity));
+
+
+        static_entity_pool(void) = default;
+        ve_immovable(static_entity_pool);
+
+
+        ~static_entity_pool(void) {
+            for (u32 slot = 0; slot < capacity(); ++slot) {
+                if (is_alive(slot)) erase(slot);
+            }
+        }
+
+
+        std::pair<u32, Entity*> emplace(Entity&& entity) {
+            if (free_slots.empty()) {
+                slabs.push_back(make_unique<slab>());
+
+                // Push in reverse, so slots are handed out in order.
+                for (u32 i = slab_size; i-- > 0;) {
+                    free_slots.push_back(u32((slabs.size() - 1) * slab_size + i));
+                }
+            }
+
+
+            u32 slot = free_slots.back();
+            free_slots.pop_back();
+
+            auto& s = get_slab(slot);
+            s.alive.set(slot % slab_size);
+            ++count;
+
+            return { slot, new (&s.storage[slot % slab_size]) Entity { std::move(entity) } };
+        }
+
+
+        void erase(u32 slot) override {
+            VE_DEBUG_ASSERT(is_alive(slot), "Attempt to erase non-existent static entity.");
+
+            auto& s = get_slab(slot);
+            std::launder((Entity*) &s.storage[slot % slab_size])->~Entity();
+            s.alive.reset(slot % slab_size);
+
+            free_slots.push_back(slot);
+            --count;
+        }
+
+
+        Entity& get(u32 slot) {
+            return *std::launder((Entity*) &get_slab(slot).storage[slot % slab_size]);
+        }
+
+        const Entity& get(u32 slot) const {
+            return *std::launder((const Entity*) &get_slab(slot).storage[slot % slab_size]);
+        }
+
+
+        // Invokes the given function for every entity in the pool, in storage order.
+        template <typename F> void for_each(F&& fn) {
+            for (auto& s : slabs) {
+                for (std::size_t i = 0; i < slab_size; ++i) {
+                    if (s->alive.test(i)) std::invoke(fn, *std::launder((Entity*) &s->storage[i]));
+                }
+            }
+        }
+
+
+        bool is_alive(u32 slot) const {
+            return slot < capacity() && get_slab(slot).alive.test(slot % slab_size);
+        }
+
+
+        std::size_t size(void) const { return count; }
+        std::size_t capacity(void) const { return slabs.size() * slab_size; }
+    private:
+        struct slab {
+            struct alignas(Entity) entity_storage { std::byte data[sizeof(Entity)]; };
+
+            std::array<entity_storage, slab_size> storage;
+            std::bitset<slab_size> alive;
+        };
+
+        std::vector<unique<slab>> slabs;
+        std::vector<u32> free_slots;
+        std::size_t count = 0;
+
+
+        slab& get_slab(u32 slot) { return *slabs[slot / slab_size]; }
+        const slab& get_slab(u32 slot) const { return *slabs[slot / slab_size]; }
     };
 
-    template <typename Entity> struct static_entity_storage : static_entity_storage_base {
-        explicit static_entity_storage(Entity&& entity) : entity(std::move(entity)) {}
 
-        Entity entity;
+    // Location of a static entity within its pool, used to look up static entities by their ID.
+    struct static_entity_location {
+        static_entity_pool_base* pool;
+        u32 slot;
     };
 }
\ No newline at end of file
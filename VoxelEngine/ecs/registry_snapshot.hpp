@@ -0,0 +1,116 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/ecs/view.hpp>
+#include <VoxelEngine/ecs/component/component_tags.hpp>
+#include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+
+#include <VoxelEngine/ecs/entt_include.hpp>
+
+
+namespace ve {
+    // Snapshot of all entities in a registry and all their serializable components. See registry::take_snapshot.
+    // Components are stored as one column per component type, rather than per entity, so they can be written and restored in bulk.
+    // Trivially copyable components are stored as raw bytes, so a snapshot should only be restored by the same build of a program.
+    // Note: static entities are not part of the snapshot, only their components are.
+    struct registry_snapshot {
+        struct component_column {
+            u64 component_type;
+            std::vector<u8> data;
+        };
+
+        std::vector<entt::entity> entities;
+        std::vector<component_column> columns;
+    };
+
+
+    namespace detail {
+        // Components can be copied into the snapshot as raw bytes if they are trivially copyable and don't have a custom serializer,
+        // since such a serializer might exclude some state from serialization.
+        // Storages with constant addresses may contain tombstones, so they are copied element-by-element instead.
+        // Empty types (tags) have no component storage at all, so only their entities are stored.
+        template <typename T> constexpr inline bool supports_bulk_snapshot_v =
+            !std::is_empty_v<T> &&
+            std::is_trivially_copyable_v<T> &&
+            std::is_default_constructible_v<T> &&
+            requires { typename serialize::binary_serializer<T>::non_overloaded_tag; } &&
+            !component_tags::has_constant_address_v<T>;
+
+
+        // Column layout: [entities] [values] [entity count].
+        // Values are either raw bytes or serialized in reverse order, so they can be popped in order. Columns of empty types have no values.
+        template <typename T> inline void write_snapshot_column(const storage_type<T>& storage, std::vector<u8>& dest) {
+            if constexpr (std::is_empty_v<T>) {
+                std::vector<entt::entity> entities;
+                entities.reserve(storage.size());
+
+                for (auto entity : view_from_storage(storage)) entities.push_back(entity);
+
+
+                std::size_t offset = dest.size();
+                dest.resize(offset + entities.size() * sizeof(entt::entity));
+                std::memcpy(dest.data() + offset, entities.data(), entities.size() * sizeof(entt::entity));
+
+                serialize::push_serializer ser { dest };
+                ser.push((u64) entities.size());
+            } else if constexpr (supports_bulk_snapshot_v<T>) {
+                constexpr std::size_t page_size = entt::component_traits<T>::page_size;
+                const std::size_t count = storage.size();
+
+                std::size_t offset = dest.size();
+                dest.resize(offset + count * (sizeof(entt::entity) + sizeof(T)));
+
+                // Both the entities and the components are stored in packed arrays, but components are paged, so copy them a page at a time.
+                std::memcpy(dest.data() + offset, storage.data(), count * sizeof(entt::entity));
+                offset += count * sizeof(entt::entity);
+
+                for (std::size_t i = 0; i < count; i += page_size) {
+                    const std::size_t page_count = std::min(page_size, count - i);
+
+                    std::memcpy(dest.data() + offset, storage.raw()[i / page_size], page_count * sizeof(T));
+                    offset += page_count * sizeof(T);
+                }
+
+                serialize::push_serializer ser { dest };
+                ser.push((u64) count);
+            } else {
+                std::vector<entt::entity> entities;
+                entities.reserve(storage.size());
+
+                for (auto entity : view_from_storage(storage)) entities.push_back(entity);
+
+
+                std::size_t offset = dest.size();
+                dest.resize(offset + entities.size() * sizeof(entt::entity));
+                std::memcpy(dest.data() + offset, entities.data(), entities.size() * sizeof(entt::entity));
+
+                for (auto entity : entities | views::reverse) serialize::to_bytes(storage.get(entity), dest);
+
+                serialize::push_serializer ser { dest };
+                ser.push((u64) entities.size());
+            }
+        }
+
+
+        template <typename T> inline void read_snapshot_column(std::span<const u8> src, std::vector<entt::entity>& entities, std::vector<T>& values) {
+            serialize::pop_deserializer ser { take_back_n(src, sizeof(u64)) };
+            const std::size_t count = (std::size_t) ser.pop<u64>();
+
+            entities.resize(count);
+            std::memcpy(entities.data(), src.data(), count * sizeof(entt::entity));
+            src = src.subspan(count * sizeof(entt::entity));
+
+
+            if constexpr (std::is_empty_v<T>) {
+                values.resize(count);
+            } else if constexpr (supports_bulk_snapshot_v<T>) {
+                values.resize(count);
+                std::memcpy(values.data(), src.data(), count * sizeof(T));
+            } else {
+                values.reserve(count);
+                for (std::size_t i = 0; i < count; ++i) values.push_back(serialize::from_bytes<T>(src));
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -16,9 +16,8 @@ namespace ve {
     // The entity visibility system determines what remote instances have vision of what entities,
     // and performs synchronization (of entity IDs, not of components) accordingly.
     // To synchronize components associated with a synchronized entity, use system_synchronizer.
-    //
-    // TODO: It would be more optimal to have the ability to create a view over all entities with the same visibility state.
-    // E.g. create a view of all visible entities, or all entities that are going invisible.
+    // Note: this system evaluates the visibility rule for every entity for every remote on every update.
+    // For large numbers of entities and remotes, consider using system_spatial_visibility instead.
     //
     // TODO: Allow usage of tags to split entities across multiple systems. Excluded entities should appear as invisible.
     template <
@@ -104,7 +103,10 @@ namespace ve {
 
             for (auto& connection : instance.get_connections()) {
                 auto [it, success] = storage.try_emplace(connection->get_remote_id());
-                auto& storage_for_conn = it->second;
+                auto& storage_for_conn = it->second.status;
+
+                it->second.became_visible.clear();
+                it->second.became_invisible.clear();
 
 
                 // For every entity, update its visibility status based on the provided rule.
@@ -120,8 +122,13 @@ namespace ve {
                     );
 
 
-                    if      (old_status == BECAME_VISIBLE  ) added.changed.push_back(entity);
-                    else if (old_status == BECAME_INVISIBLE) removed.changed.push_back(entity);
+                    if (old_status == BECAME_VISIBLE) {
+                        it->second.became_visible.emplace(entity);
+                        added.changed.push_back(entity);
+                    } else if (old_status == BECAME_INVISIBLE) {
+                        it->second.became_invisible.emplace(entity);
+                        removed.changed.push_back(entity);
+                    }
                 }
 
 
@@ -158,7 +165,19 @@ namespace ve {
         // Returns a view of the visibility status of every entity for the given remote. Note that this includes invisible entities.
         // Entities and remotes that were added since the last call to update are not accessible this way.
         auto visibility_for_remote(instance_id remote) const {
-            return view_from_storage(storage.at(remote));
+            return view_from_storage(storage.at(remote).status);
+        }
+
+
+        // Returns a view of all entities that became visible to the given remote during the last update.
+        auto became_visible_for_remote(instance_id remote) const {
+            return view_from_set(storage.at(remote).became_visible);
+        }
+
+
+        // Returns a view of all entities that became invisible to the given remote during the last update.
+        auto became_invisible_for_remote(instance_id remote) const {
+            return view_from_set(storage.at(remote).became_invisible);
         }
 
 
@@ -168,19 +187,26 @@ namespace ve {
         bool is_visible(entt::entity entity, instance_id remote) const {
             // TODO: Would it be better to always invoke the rule instead of checking this?
             if (auto remote_it = storage.find(remote); remote_it != storage.end()) {
-                if (remote_it->second.contains(entity)) {
-                    return remote_it->second.get(entity) & VISIBILITY_BIT;
+                if (remote_it->second.status.contains(entity)) {
+                    return remote_it->second.status.get(entity) & VISIBILITY_BIT;
                 }
             }
 
             return std::invoke(rule, static_cast<const registry&>(*owner), entity, owner->get_connection(remote).get());
         }
     private:
+        struct remote_data {
+            storage_type<visibility_status> status;
+            // Entities whose visibility changed during the last update, split by the state they changed to.
+            entt::sparse_set became_visible, became_invisible;
+        };
+
+
         u16 priority;
 
         instance* owner = nullptr;
         VisibilityRule rule;
-        hash_map<instance_id, storage_type<visibility_status>> storage;
+        hash_map<instance_id, remote_data> storage;
 
         event_handler_id_t entity_destroyed_handler, remote_disconnected_handler;
         entt::sparse_set destroyed_entities;
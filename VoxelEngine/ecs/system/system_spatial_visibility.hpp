@@ -0,0 +1,363 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/ecs/view.hpp>
+#include <VoxelEngine/ecs/registry.hpp>
+#include <VoxelEngine/ecs/system/system.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/clientserver/instance.hpp>
+#include <VoxelEngine/clientserver/instance_events.hpp>
+#include <VoxelEngine/clientserver/core_messages/core_message_setup.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_add_del_entity.hpp>
+#include <VoxelEngine/utility/functional.hpp>
+#include <VoxelEngine/utility/traits/pack/pack.hpp>
+
+
+namespace ve {
+    // Grid-based alternative to system_entity_visibility, which can be used anywhere a visibility system is expected.
+    // Entities are bucketed into cubic cells based on the position of their transform_component. Every remote observes the cells
+    // within subscription_range cells of the position returned by the subscription rule for that remote.
+    // Rather than evaluating a rule for every entity for every remote each tick, visibility is only re-evaluated for entities
+    // that moved to a different cell, and for the contents of cells that a remote started or stopped observing.
+    //
+    // Entities without a transform_component are placed in a global cell, which is observed by every remote.
+    // If the subscription rule returns std::nullopt for some remote, that remote will only observe the global cell.
+    template <
+        typename SubscriptionRule = fn<std::optional<vec3f>, const registry&, const message_handler*>,
+        template <typename System> typename... Mixins
+    > requires (
+        std::is_invocable_r_v<std::optional<vec3f>, SubscriptionRule, const registry&, const message_handler*>
+    ) class system_spatial_visibility : public system<
+        system_spatial_visibility<SubscriptionRule, Mixins...>,
+        meta::pack<>,
+        meta::pack<>,
+        meta::pack<transform_component>,
+        Mixins...
+    > {
+    public:
+        using system_entity_visibility_tag = void;
+        using subscription_rule_t          = SubscriptionRule;
+        using cell_t                       = vec3i;
+
+
+        enum visibility_status : u8 {
+            INVISIBLE        = 0b00,
+            VISIBLE          = 0b01,
+            BECAME_INVISIBLE = 0b10,
+            BECAME_VISIBLE   = 0b11
+        };
+
+        constexpr static inline u8 VISIBILITY_BIT = 0b01;
+        constexpr static inline u8 CHANGED_BIT    = 0b10;
+
+        // Cell used for entities without a position. This cell is observed by every remote.
+        const static inline cell_t global_cell = cell_t { min_value<cell_t::value_type> };
+
+
+        explicit system_spatial_visibility(
+            SubscriptionRule rule,
+            f32 cell_size = 32.0f,
+            i32 subscription_range = 2,
+            u16 priority = priority::LOWEST + 1
+        ) :
+            priority(priority),
+            cell_size(cell_size),
+            subscription_range(subscription_range),
+            rule(std::move(rule))
+        {
+            VE_ASSERT(cell_size > 0.0f, "Cell size of spatial visibility system must be positive.");
+            VE_ASSERT(subscription_range >= 0, "Subscription range of spatial visibility system cannot be negative.");
+        }
+
+
+        u16 get_priority(void) const {
+            return priority;
+        }
+
+
+        template <typename Component> constexpr static u8 access_mode_for_component(void) {
+            return (u8) system_access_mode::READ_CMP;
+        }
+
+
+        void on_system_added(registry& owner) {
+            VE_DEBUG_ASSERT(
+                dynamic_cast<class instance*>(&owner),
+                "Registry must be part of an instance in order to use a synchronization system."
+            );
+
+            entity_destroyed_handler = owner.add_raw_handler([&] (const entity_destroyed_event& e) {
+                if (!destroyed_entities.contains(e.entity)) destroyed_entities.emplace(e.entity);
+            });
+
+            remote_disconnected_handler = owner.add_raw_handler([&] (const instance_disconnected_event& e) {
+                storage.erase(e.remote);
+            });
+
+            destroyed_entities.clear();
+            storage.clear();
+            cells.clear();
+            entity_cells.clear();
+
+            this->owner = static_cast<class instance*>(&owner);
+        }
+
+
+        void on_system_removed(registry& owner) {
+            owner.template remove_handler<entity_destroyed_event>(entity_destroyed_handler);
+            owner.template remove_handler<instance_disconnected_event>(remote_disconnected_handler);
+
+            this->owner = nullptr;
+        }
+
+
+        void on_system_update(registry& owner, view_type view, nanoseconds dt) {
+            auto& instance = static_cast<class instance&>(owner);
+            add_del_entity_message added, removed;
+
+            update_cells(owner, view);
+
+
+            for (auto& connection : instance.get_connections()) {
+                auto [it, is_new_remote] = storage.try_emplace(connection->get_remote_id());
+                auto& data = it->second;
+
+
+                // Changes from the last update have been observed by now. Entities that went invisible are dropped from the storage
+                // entirely, so it only ever contains entities near the remote.
+                for (auto entity : data.became_visible) data.status.get(entity) = VISIBLE;
+                data.status.erase(data.became_invisible.begin(), data.became_invisible.end());
+
+                data.became_visible.clear();
+                data.became_invisible.clear();
+
+
+                // Destroyed entities will appear as going invisible on the remote.
+                auto destroyed_view = view_from_set(destroyed_entities) | view_from_storage(data.status);
+
+                for (auto entity : destroyed_view) {
+                    if (data.status.get(entity) & VISIBILITY_BIT) removed.changed.push_back(entity);
+                }
+
+                data.status.erase(destroyed_view.begin(), destroyed_view.end());
+
+
+                auto update_entity = [&] (entt::entity entity, const cell_t& cell, const std::optional<cell_t>& center) {
+                    bool was_visible = data.status.contains(entity);
+                    bool now_visible = is_observed(cell, center);
+
+                    if (was_visible == now_visible) return;
+
+                    if (now_visible) {
+                        data.status.emplace(entity, BECAME_VISIBLE);
+                        data.became_visible.emplace(entity);
+                        added.changed.push_back(entity);
+                    } else {
+                        data.status.get(entity) = BECAME_INVISIBLE;
+                        data.became_invisible.emplace(entity);
+                        removed.changed.push_back(entity);
+                    }
+                };
+
+                auto update_cell = [&] (const cell_t& cell, const std::optional<cell_t>& center) {
+                    if (auto cell_it = cells.find(cell); cell_it != cells.end()) {
+                        for (auto entity : cell_it->second) update_entity(entity, cell, center);
+                    }
+                };
+
+
+                // Update the set of cells the remote is subscribed to. Only cells that entered or left the subscription range
+                // need to be re-evaluated.
+                std::optional<cell_t> center;
+                if (auto position = std::invoke(rule, static_cast<const registry&>(owner), connection.get()); position) {
+                    center = cell_for(*position);
+                }
+
+                if (is_new_remote) update_cell(global_cell, center);
+
+                if (center != data.center) {
+                    if (data.center) foreach_cell_in_range(*data.center, [&] (const cell_t& cell) {
+                        if (!is_observed(cell, center)) update_cell(cell, center);
+                    });
+
+                    if (center) foreach_cell_in_range(*center, [&] (const cell_t& cell) {
+                        if (!is_observed(cell, data.center)) update_cell(cell, center);
+                    });
+
+                    data.center = center;
+                }
+
+
+                // Entities that moved to a different cell (or were just created) may have changed visibility.
+                for (auto entity : moved_entities) update_entity(entity, entity_cells.get(entity), center);
+
+
+                // Send lists of entities that became visible and invisible to remote.
+                if (!added.changed.empty()) {
+                    connection->send_message(core_message_types::MSG_ADD_ENTITY, added);
+                    added.changed.clear();
+                }
+
+                if (!removed.changed.empty()) {
+                    connection->send_message(core_message_types::MSG_DEL_ENTITY, removed);
+                    removed.changed.clear();
+                }
+            }
+
+
+            destroyed_entities.clear();
+        }
+
+
+        // Returns a view of the visibility status of every entity that is or just stopped being visible to the given remote.
+        // Entities and remotes that were added since the last call to update are not accessible this way.
+        auto visibility_for_remote(instance_id remote) const {
+            return view_from_storage(storage.at(remote).status);
+        }
+
+
+        // Returns a view of all entities that became visible to the given remote during the last update.
+        auto became_visible_for_remote(instance_id remote) const {
+            return view_from_set(storage.at(remote).became_visible);
+        }
+
+
+        // Returns a view of all entities that became invisible to the given remote during the last update.
+        auto became_invisible_for_remote(instance_id remote) const {
+            return view_from_set(storage.at(remote).became_invisible);
+        }
+
+
+        // Returns the visibility of the given entity for the given instance.
+        // Like with system_entity_visibility, this method is also able to evaluate entities that may have been added
+        // since the last call to update.
+        bool is_visible(entt::entity entity, instance_id remote) const {
+            auto remote_it = storage.find(remote);
+
+            if (remote_it != storage.end()) {
+                if (remote_it->second.status.contains(entity)) {
+                    return remote_it->second.status.get(entity) & VISIBILITY_BIT;
+                }
+
+                // Entity was evaluated during the last update and is not observed by the remote.
+                if (entity_cells.contains(entity)) return false;
+            }
+
+
+            const auto* transform = owner->template try_get_component<transform_component>(entity);
+            cell_t cell = transform ? cell_for(transform->position) : global_cell;
+
+            if (remote_it != storage.end()) {
+                return is_observed(cell, remote_it->second.center);
+            } else {
+                auto position = std::invoke(rule, static_cast<const registry&>(*owner), owner->get_connection(remote).get());
+                return is_observed(cell, position ? std::optional<cell_t> { cell_for(*position) } : std::nullopt);
+            }
+        }
+
+
+        cell_t cell_for(const vec3f& position) const {
+            return (cell_t) glm::floor(position / cell_size);
+        }
+
+
+        VE_GET_VAL(cell_size);
+        VE_GET_VAL(subscription_range);
+    private:
+        struct remote_data {
+            storage_type<visibility_status> status;
+            // Entities whose visibility changed during the last update, split by the state they changed to.
+            entt::sparse_set became_visible, became_invisible;
+            // The cell the subscription range of the remote is centered on, if any.
+            std::optional<cell_t> center;
+        };
+
+
+        u16 priority;
+        f32 cell_size;
+        i32 subscription_range;
+
+        instance* owner = nullptr;
+        SubscriptionRule rule;
+        hash_map<instance_id, remote_data> storage;
+
+        hash_map<cell_t, hash_set<entt::entity>> cells;
+        storage_type<cell_t> entity_cells;
+        // Entities that changed cells during the current update, including ones that were not in any cell before.
+        std::vector<entt::entity> moved_entities;
+
+        event_handler_id_t entity_destroyed_handler, remote_disconnected_handler;
+        entt::sparse_set destroyed_entities;
+
+
+        // Moves every entity into the cell matching its current position.
+        void update_cells(registry& owner, view_type view) {
+            moved_entities.clear();
+
+
+            for (auto entity : destroyed_entities) {
+                if (entity_cells.contains(entity)) {
+                    remove_from_cell(entity, entity_cells.get(entity));
+                    entity_cells.erase(entity);
+                }
+            }
+
+
+            for (auto entity : view) {
+                const auto* transform = owner.template try_get_component<transform_component>(entity);
+                cell_t cell = transform ? cell_for(transform->position) : global_cell;
+
+                if (!entity_cells.contains(entity)) [[unlikely]] {
+                    entity_cells.emplace(entity, cell);
+                } else if (auto& old_cell = entity_cells.get(entity); old_cell != cell) {
+                    remove_from_cell(entity, old_cell);
+                    old_cell = cell;
+                } else continue;
+
+                cells[cell].insert(entity);
+                moved_entities.push_back(entity);
+            }
+        }
+
+
+        void remove_from_cell(entt::entity entity, const cell_t& cell) {
+            auto it = cells.find(cell);
+            it->second.erase(entity);
+
+            if (it->second.empty()) cells.erase(it);
+        }
+
+
+        bool is_observed(const cell_t& cell, const std::optional<cell_t>& center) const {
+            if (cell == global_cell) return true;
+            if (!center) return false;
+
+            auto delta = glm::abs(cell - *center);
+            return std::max({ delta.x, delta.y, delta.z }) <= subscription_range;
+        }
+
+
+        void foreach_cell_in_range(const cell_t& center, auto pred) const {
+            for (i32 x = -subscription_range; x <= subscription_range; ++x) {
+                for (i32 y = -subscription_range; y <= subscription_range; ++y) {
+                    for (i32 z = -subscription_range; z <= subscription_range; ++z) {
+                        std::invoke(pred, center + cell_t { x, y, z });
+                    }
+                }
+            }
+        }
+    };
+
+
+    template <typename Rule>
+    system_spatial_visibility(Rule) -> system_spatial_visibility<Rule>;
+
+    template <typename Rule>
+    system_spatial_visibility(Rule, f32) -> system_spatial_visibility<Rule>;
+
+    template <typename Rule>
+    system_spatial_visibility(Rule, f32, i32) -> system_spatial_visibility<Rule>;
+
+    template <typename Rule>
+    system_spatial_visibility(Rule, f32, i32, u16) -> system_spatial_visibility<Rule>;
+}
\ No newline at end of file
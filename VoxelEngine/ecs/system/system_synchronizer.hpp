@@ -7,14 +7,18 @@
 #include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
 #include <VoxelEngine/ecs/component/component_tags.hpp>
 #include <VoxelEngine/clientserver/instance.hpp>
+#include <VoxelEngine/clientserver/instance_events.hpp>
 #include <VoxelEngine/clientserver/core_messages/core_message_setup.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_compound.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_set_component.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_set_component_delta.hpp>
 #include <VoxelEngine/clientserver/core_messages/msg_del_component.hpp>
 #include <VoxelEngine/utility/stack_polymorph.hpp>
 #include <VoxelEngine/utility/traits/function_traits.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
 #include <VoxelEngine/utility/traits/pack/pack.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/utility/io/serialize/delta_serializer.hpp>
 
 #include <xxhash.h>
 
@@ -36,6 +40,21 @@ namespace ve {
     // per-remote basis.
     // Each component has an associated synchronization interval. The component is also always synchronized when it
     // first becomes visible to a remote.
+    //
+    // Optionally, a bandwidth budget can be set to limit the number of bytes of component data sent to each remote per update.
+    // In this mode, changed components are queued per remote and ranked by the product of their component's importance and the
+    // sync priority function (e.g. based on the distance to the remote's player). Updates that do not fit within the budget
+    // are carried over to the next update, and their priority accumulates over time so that stale updates are eventually sent.
+    //
+    // Components can also be delta-encoded, in which case only the fields that changed since the last value sent to each remote
+    // are synchronized (See serialize::delta_to_bytes). The baseline for each remote is the value it decoded from the last message sent,
+    // which may be quantized if the component has lossy delta hints. Since messages are delivered reliably and in-order,
+    // this is also the value the remote will have when the delta arrives, unless the remote changed the value itself.
+    // Deltas therefore carry a hash of their baseline, and a remote that holds a different value requests the full value instead.
+    //
+    // Components can also be sent over an unreliable channel (See message_channel::UNRELIABLE_LATEST), so that high-rate updates
+    // are not delayed behind other traffic. Since lost updates are never resent, these components are sent on every synchronization,
+    // even if they did not change. Values for entities that just became visible are still sent reliably.
     template <
         meta::pack_of_types Synchronized,
         meta::pack_of_types RequiredTags = meta::pack<>,
@@ -59,12 +78,17 @@ namespace ve {
     > {
     private:
         // TODO: Sync cache component should persist between ticks so we can skip sending values that have not changed.
+        // The caches are rebuilt by the synchronizer as required, so they should not be part of registry snapshots.
         template <typename Component> struct sync_cache_component {
+            using non_snapshottable_tag = void;
+
             std::vector<u8> data;
             bool changed = true;
         };
 
-        template <typename Component> struct sync_cache_up_to_date_component {};
+        template <typename Component> struct sync_cache_up_to_date_component {
+            using non_snapshottable_tag = void;
+        };
 
         // Wrapper around bool types to avoid conflicts with views that also include a bool type from a registry component.
         struct bool_wrapper { bool value; };
@@ -74,13 +98,15 @@ namespace ve {
         using synchronized_types      = Synchronized;
         using partially_synced_types  = typename Synchronized::template filter_trait<detail::is_partially_synchronizable>;
         using vis_status              = std::add_const_t<typename VisibilitySystem::visibility_status>;
+        using sync_priority_fn        = std::function<f32(const registry&, entt::entity, const message_handler*)>;
 
 
         explicit system_synchronizer(VisibilitySystem& visibility_system, nanoseconds default_sync_rate = nanoseconds{1s} / 30, u16 priority = priority::LOWEST) :
             priority(priority),
             visibility_system(&visibility_system),
             sync_rates(create_filled_array<synchronized_types::size>(produce(default_sync_rate))),
-            last_sync(create_filled_array<synchronized_types::size>(produce(epoch_time<steady_clock::time_point>())))
+            last_sync(create_filled_array<synchronized_types::size>(produce(epoch_time<steady_clock::time_point>()))),
+            sync_importance(create_filled_array<synchronized_types::size>(produce(1.0f)))
         {
             VE_ASSERT(
                 get_priority() < visibility_system.get_priority(),
@@ -104,10 +130,26 @@ namespace ve {
                 dynamic_cast<class instance*>(&owner),
                 "Registry must be part of an instance in order to use a synchronization system."
             );
+
+            remote_disconnected_handler = owner.add_raw_handler([&] (const instance_disconnected_event& e) {
+                pending_updates.erase(e.remote);
+                delta_baselines.erase(e.remote);
+                erase_resend_requests(owner, [&] (const auto& request) { return request.first == e.remote; });
+            });
+
+            pending_updates.clear();
+            delta_baselines.clear();
+        }
+
+
+        void on_system_removed(registry& owner) {
+            owner.template remove_handler<instance_disconnected_event>(remote_disconnected_handler);
         }
 
 
         void on_system_update(registry& owner, view_type view, nanoseconds dt) {
+            VE_METRIC_TIMER("ve_sync_update_seconds", "Time taken to synchronize components with all remotes.");
+
             auto& instance = static_cast<class instance&>(owner);
             u64 tick = instance.get_tick_count();
 
@@ -122,7 +164,8 @@ namespace ve {
                 auto vis_for_conn = visibility_system->visibility_for_remote(connection->get_remote_id());
 
 
-                compound_message msg;
+                compound_message_v2 msg, unreliable_msg;
+                add_resends_to_message(connection.get(), msg, owner, vis_for_conn);
 
 
                 synchronized_types::foreach_indexed([&] <typename Component, std::size_t Index> {
@@ -130,7 +173,7 @@ namespace ve {
                         bool sync_timer_elapsed = synchronize_now[Index];
 
                         update_serialized_values<Component>(owner, view, sync_timer_elapsed);
-                        add_changes_to_message<Component>(connection.get(), msg, owner, view, sync_timer_elapsed);
+                        add_changes_to_message<Component>(connection.get(), msg, unreliable_msg, owner, view, sync_timer_elapsed);
                         add_removals_to_message<Component>(connection.get(), msg, owner, view, sync_timer_elapsed);
                         remove_destroyed_component_data<Component>(owner);
                     };
@@ -153,7 +196,21 @@ namespace ve {
                 });
 
 
-                if (!msg.empty()) connection->send_message(core_message_types::MSG_COMPOUND, msg);
+                if (bandwidth_budget > 0) add_budgeted_changes_to_message(connection.get(), msg, owner, vis_for_conn);
+
+                synchronized_types::foreach_indexed([&] <typename Component, std::size_t Index> {
+                    if (delta_encoding[Index]) remove_stale_baselines<Component>(connection->get_remote_id(), vis_for_conn);
+                });
+
+                if (!msg.empty()) connection->send_message(core_message_types::MSG_COMPOUND_V2, msg, msg.priority);
+                if (!unreliable_msg.empty()) connection->send_message(core_message_types::MSG_COMPOUND_V2, unreliable_msg, message_channel::UNRELIABLE_LATEST);
+
+                for (const auto* sent : { &msg, &unreliable_msg }) {
+                    if (sent->empty()) continue;
+
+                    VE_METRIC_COUNTER("ve_sync_messages_total", "Number of synchronization messages sent.").add();
+                    VE_METRIC_COUNTER("ve_sync_bytes_total", "Size of synchronization messages sent, before compression.").add(sent->data.size());
+                }
 
 
                 // Remove cached values for components that no longer exist.
@@ -188,6 +245,66 @@ namespace ve {
         }
 
 
+        // Enables or disables delta encoding of changes to the given component.
+        // This requires a copy of the last value sent to each remote to be stored for every entity.
+        template <typename Component> requires (
+            synchronized_types::template contains<Component> &&
+            std::is_copy_constructible_v<Component> &&
+            std::is_copy_assignable_v<Component>
+        ) void set_delta_encoding(bool enabled) {
+            constexpr std::size_t index = synchronized_types::template find<Component>;
+
+            VE_ASSERT(
+                !enabled || channels[index] == message_channel::RELIABLE_ORDERED,
+                "Delta encoding requires the remote to have received the previous value, so it cannot be used with an unreliable channel."
+            );
+
+            delta_encoding[index] = enabled;
+
+            if (!enabled) {
+                for (auto& [remote, baselines] : delta_baselines) std::get<index>(baselines).clear();
+            }
+        }
+
+
+        // Sets the channel used to synchronize changes to the given component.
+        // Changes sent over an unreliable channel are not subject to the bandwidth budget, and cannot be delta-encoded.
+        template <typename Component> requires synchronized_types::template contains<Component>
+        void set_message_channel(message_channel channel) {
+            constexpr std::size_t index = synchronized_types::template find<Component>;
+
+            VE_ASSERT(
+                channel == message_channel::RELIABLE_ORDERED || !delta_encoding[index],
+                "Delta encoding requires the remote to have received the previous value, so it cannot be used with an unreliable channel."
+            );
+
+            channels[index] = channel;
+        }
+
+
+        // Sets the maximum number of bytes of component data sent to each remote per update. Changes exceeding the budget are deferred.
+        // Note that at least one change is always sent per update, even if it exceeds the budget by itself.
+        // Setting the budget to zero disables budgeting, causing all changes to be sent immediately.
+        void set_bandwidth_budget(std::size_t bytes_per_update) {
+            bandwidth_budget = bytes_per_update;
+            if (bytes_per_update == 0) pending_updates.clear();
+        }
+
+
+        // Sets the weight of the given component when ranking changes in bandwidth-budgeted mode.
+        template <typename Component> requires synchronized_types::template contains<Component>
+        void set_sync_importance(f32 importance) {
+            sync_importance[synchronized_types::template find<Component>] = importance;
+        }
+
+
+        // Sets the function used to rank changes to different entities in bandwidth-budgeted mode.
+        // The returned priority is accumulated every update until the change is sent.
+        void set_sync_priority_function(sync_priority_fn fn) {
+            priority_fn = std::move(fn);
+        }
+
+
         // Adds a rule to determine synchronization of the given component on a per-entity and per-instance basis.
         template <
             typename Rule,
@@ -214,9 +331,40 @@ namespace ve {
         std::array<steady_clock::time_point, synchronized_types::size> last_sync;
 
 
+        // Bandwidth budgeting data. For every remote, stores the accumulated priority of each change that has yet to be sent.
+        struct sync_candidate {
+            f32 priority;
+            u16 component_index;
+            entt::entity entity;
+            const std::vector<u8>* data;
+        };
+
+        std::size_t bandwidth_budget = 0;
+        std::array<f32, synchronized_types::size> sync_importance;
+        sync_priority_fn priority_fn = [] (const registry&, entt::entity, const message_handler*) { return 1.0f; };
+
+        hash_map<instance_id, std::array<storage_type<f32>, synchronized_types::size>> pending_updates;
+        std::vector<sync_candidate> candidates;
+        std::vector<entt::entity> stale_candidates;
+
+        event_handler_id_t remote_disconnected_handler;
+
+
+        // Delta encoding data. For every remote, stores the last value of every delta-encoded component that was sent to it.
+        using baseline_storage = typename synchronized_types
+            ::template expand_outside<storage_type>
+            ::template expand_inside<std::tuple>;
+
+        std::array<bool, synchronized_types::size> delta_encoding { };
+        std::array<message_channel, synchronized_types::size> channels { };
+        hash_map<instance_id, baseline_storage> delta_baselines;
+        std::vector<entt::entity> stale_baselines;
+
+
         struct rule_storage_base {
             virtual ~rule_storage_base(void) = default;
             virtual void update_sync_list(registry& owner, instance_id remote, storage_type<bool_wrapper>& storage) const = 0;
+            virtual bool includes(registry& owner, instance_id remote, entt::entity entity) const = 0;
         };
 
         template <typename Rule, typename Component, meta::pack_of_types Required, meta::pack_of_types Excluded>
@@ -232,6 +380,14 @@ namespace ve {
                     view.template get<bool_wrapper>(entity).value &= std::invoke(rule, remote, owner, entity, view.template get<Component>(entity));
                 }
             }
+
+            // Equivalent to update_sync_list for a single entity. Entities the rule does not apply to are included.
+            bool includes(registry& owner, instance_id remote, entt::entity entity) const override {
+                auto view = owner.template view_pack<typename Required::template append<Component>, Excluded>();
+                if (!view.contains(entity)) return true;
+
+                return std::invoke(rule, remote, owner, entity, view.template get<Component>(entity));
+            }
         };
 
         using rule_storage_poly_t = stack_polymorph<rule_storage_base, sizeof(rule_storage_base) + 32>;
@@ -319,7 +475,7 @@ namespace ve {
 
 
         // Add the data about which (visible) components were changed to the provided message.
-        template <typename Component> void add_changes_to_message(message_handler* connection, compound_message& msg, registry& owner, auto visibility_view, bool sync_timer_elapsed) {
+        template <typename Component> void add_changes_to_message(message_handler* connection, compound_message_v2& msg, compound_message_v2& unreliable_msg, registry& owner, auto visibility_view, bool sync_timer_elapsed) {
             auto view_synchronized = visibility_view | owner.template view_pack<
                 typename RequiredTags::template append<sync_cache_component<Component>>,
                 ExcludedTags
@@ -328,27 +484,269 @@ namespace ve {
             for (auto entity : view_synchronized) {
                 if (!is_synchronized(entity, view_synchronized, sync_timer_elapsed)) continue;
 
-                const static mtr_id id = get_core_mtr_id(core_message_types::MSG_SET_COMPONENT);
-                const auto& cache = view_synchronized.template get<sync_cache_component<Component>>(entity);
+                const auto& cache     = view_synchronized.template get<sync_cache_component<Component>>(entity);
+                const bool  new_value = (view_synchronized.template get<vis_status>(entity) & VisibilitySystem::CHANGED_BIT);
+
+                // Unreliable updates may be lost, so they are sent regardless of whether the value changed.
+                if (channels[synchronized_types::template find<Component>] == message_channel::UNRELIABLE_LATEST && !new_value) {
+                    push_change<Component>(connection, unreliable_msg, owner, entity, cache.data);
+                    continue;
+                }
 
                 // If the component didn't change and the remote already has the most up-to-date value, we don't have to synchronize it again.
-                if (!cache.changed && !(view_synchronized.template get<vis_status>(entity) & VisibilitySystem::CHANGED_BIT)) continue;
+                if (!cache.changed && !new_value) continue;
 
-                msg.push_message(
-                    id,
-                    set_component_message {
-                        .component_data = cache.data, // TODO: Elude this copy!
-                        .component_type = type_hash<Component>(),
-                        .entity         = entity
-                    },
-                    connection
-                );
+                // If the entity just became visible, the remote won't have any value to apply a delta to.
+                if (new_value) erase_baseline<Component>(connection->get_remote_id(), entity);
+
+                // In bandwidth-budgeted mode, the change is queued and sent later by add_budgeted_changes_to_message.
+                // Entities that just became visible are always sent immediately, so the remote never has an entity without its components.
+                if (bandwidth_budget > 0 && !new_value) {
+                    auto& pending = pending_updates[connection->get_remote_id()][synchronized_types::template find<Component>];
+                    if (!pending.contains(entity)) pending.emplace(entity, 0.0f);
+
+                    continue;
+                }
+
+                if (new_value) erase_pending<Component>(connection->get_remote_id(), entity);
+                push_change<Component>(connection, msg, owner, entity, cache.data);
+            }
+        }
+
+
+        // Add the full value of components the remote requested to be resent, because it rejected a delta that did not match the value it holds.
+        // This is done before adding other changes, so any changes made during this update are sent as a delta against the resent value.
+        void add_resends_to_message(message_handler* connection, compound_message_v2& msg, registry& owner, auto visibility_view) {
+            const auto remote = connection->get_remote_id();
+
+            for (auto entity : owner.template view<resend_request_component>()) {
+                for (const auto& [requester, type] : owner.template get_component<resend_request_component>(entity).requests) {
+                    if (requester != remote) continue;
+
+                    synchronized_types::foreach_indexed([&] <typename Component, std::size_t Index> {
+                        if (type != type_hash<Component>()) return;
+
+                        // Without a baseline, the component is sent in full the next time it is synchronized, even if it cannot be sent now.
+                        erase_baseline<Component>(remote, entity);
+
+                        const auto* cache = owner.template try_get_component<sync_cache_component<Component>>(entity);
+
+                        if (
+                            !cache ||
+                            !visibility_view.contains(entity) ||
+                            !(visibility_view.template get<vis_status>(entity) & VisibilitySystem::VISIBILITY_BIT) ||
+                            !std::ranges::all_of(per_entity_rules[Index], [&] (const auto& rule) { return rule->includes(owner, remote, entity); })
+                        ) return;
+
+                        erase_pending<Component>(remote, entity);
+                        push_change<Component>(connection, msg, owner, entity, cache->data);
+                    });
+                }
+            }
+
+
+            // Requests for components that are not synchronized by this system are left for the systems that do synchronize them.
+            erase_resend_requests(owner, [&] (const auto& request) {
+                bool synchronized = false;
+                synchronized_types::foreach([&] <typename Component> { synchronized |= (request.second == type_hash<Component>()); });
+
+                return request.first == remote && synchronized;
+            });
+        }
+
+
+        // Removes all resend requests matching the given predicate, and removes the request component from entities without any remaining requests.
+        // Local connections deliver messages immediately, so requests can be added while the system is updating.
+        // Only requests that have been handled should be removed, so those added since are handled during the next update.
+        void erase_resend_requests(registry& owner, auto pred) {
+            stale_candidates.clear();
+
+            for (auto entity : owner.template view<resend_request_component>()) {
+                auto& requests = owner.template get_component<resend_request_component>(entity).requests;
+                requests.erase(std::remove_if(requests.begin(), requests.end(), pred), requests.end());
+
+                if (requests.empty()) stale_candidates.push_back(entity);
+            }
+
+            for (auto entity : stale_candidates) owner.template remove_component<resend_request_component>(entity);
+        }
+
+
+        // Remove a queued change that is superseded by sending the full value.
+        template <typename Component> void erase_pending(instance_id remote, entt::entity entity) {
+            if (auto it = pending_updates.find(remote); it != pending_updates.end()) {
+                auto& pending = it->second[synchronized_types::template find<Component>];
+                if (pending.contains(entity)) pending.erase(entity);
+            }
+        }
+
+
+        // Add a message containing the new value of the given component to the provided message,
+        // either as a delta against the last value sent to the remote or as the full value.
+        template <typename Component> void push_change(message_handler* connection, compound_message_v2& msg, registry& owner, entt::entity entity, const std::vector<u8>& data) {
+            constexpr std::size_t index = synchronized_types::template find<Component>;
+
+            const static mtr_id set_id   = get_core_mtr_id(core_message_types::MSG_SET_COMPONENT);
+            const static mtr_id delta_id = get_core_mtr_id(core_message_types::MSG_DELTA_COMPONENT);
+
+
+            if constexpr (std::is_copy_constructible_v<Component> && std::is_copy_assignable_v<Component>) {
+                const Component* value = owner.template try_get_component<Component>(entity);
+
+                if (delta_encoding[index] && value) {
+                    auto& baselines = std::get<index>(delta_baselines[connection->get_remote_id()]);
+
+                    if (baselines.contains(entity)) {
+                        auto& baseline = baselines.get(entity);
+
+                        set_component_delta_message delta_msg {
+                            .baseline_hash  = serialize::baseline_hash(baseline),
+                            .component_type = type_hash<Component>(),
+                            .entity         = entity
+                        };
+
+                        // Lossy delta hints may cause the remote to hold a quantized value, so the baseline must track that value
+                        // rather than the exact one, or the two would drift apart.
+                        serialize::delta_to_bytes_and_advance(baseline, *value, delta_msg.component_delta);
+
+                        if (delta_msg.component_delta.size() < data.size()) {
+                            msg.push_message(delta_id, delta_msg, connection);
+                            return;
+                        }
+
+                        // The full value is sent instead, which is not quantized.
+                        baseline = *value;
+                    } else {
+                        baselines.emplace(entity, *value);
+                    }
+
+
+                    // The cached data may be older than the current value, so serialize it again to make sure it matches the baseline.
+                    msg.push_message(
+                        set_id,
+                        set_component_message {
+                            .component_data = serialize::to_bytes(*value),
+                            .component_type = type_hash<Component>(),
+                            .entity         = entity
+                        },
+                        connection
+                    );
+
+                    return;
+                }
+            }
+
+
+            msg.push_message(
+                set_id,
+                set_component_message {
+                    .component_data = data, // TODO: Elude this copy!
+                    .component_type = type_hash<Component>(),
+                    .entity         = entity
+                },
+                connection
+            );
+        }
+
+
+        template <typename Component> void erase_baseline(instance_id remote, entt::entity entity) {
+            if (!delta_encoding[synchronized_types::template find<Component>]) return;
+
+            if (auto it = delta_baselines.find(remote); it != delta_baselines.end()) {
+                auto& baselines = std::get<synchronized_types::template find<Component>>(it->second);
+                if (baselines.contains(entity)) baselines.erase(entity);
+            }
+        }
+
+
+        // Remove baselines for entities that are no longer visible to the remote, since they will be sent in full once they become visible again.
+        template <typename Component> void remove_stale_baselines(instance_id remote, auto visibility_view) {
+            auto it = delta_baselines.find(remote);
+            if (it == delta_baselines.end()) return;
+
+            auto& baselines = std::get<synchronized_types::template find<Component>>(it->second);
+            stale_baselines.clear();
+
+            for (auto entity : baselines) {
+                if (!visibility_view.contains(entity) || !(visibility_view.template get<vis_status>(entity) & VisibilitySystem::VISIBILITY_BIT)) {
+                    stale_baselines.push_back(entity);
+                }
+            }
+
+            baselines.erase(stale_baselines.begin(), stale_baselines.end());
+        }
+
+
+        // Add the pending changes with the highest accumulated priority to the provided message, until the bandwidth budget is exhausted.
+        // Changes that are not sent have their priority increased, so they will be more likely to be sent during the next update.
+        void add_budgeted_changes_to_message(message_handler* connection, compound_message_v2& msg, registry& owner, auto visibility_view) {
+            auto it = pending_updates.find(connection->get_remote_id());
+            if (it == pending_updates.end()) return;
+
+            auto& pending_for_remote = it->second;
+            candidates.clear();
+
+
+            synchronized_types::foreach_indexed([&] <typename Component, std::size_t Index> {
+                auto& pending = pending_for_remote[Index];
+                stale_candidates.clear();
+
+                for (auto entity : pending) {
+                    const auto* cache = owner.template try_get_component<sync_cache_component<Component>>(entity);
+
+                    // Entity may have gone out of sight, lost its component or become excluded by a per-entity rule since the change was queued.
+                    if (
+                        !cache ||
+                        !visibility_view.contains(entity) ||
+                        !(visibility_view.template get<vis_status>(entity) & VisibilitySystem::VISIBILITY_BIT) ||
+                        !std::ranges::all_of(per_entity_rules[Index], [&] (const auto& rule) { return rule->includes(owner, connection->get_remote_id(), entity); })
+                    ) {
+                        stale_candidates.push_back(entity);
+                        continue;
+                    }
+
+                    f32& accumulated = pending.get(entity);
+                    accumulated += sync_importance[Index] * std::invoke(priority_fn, owner, entity, connection);
+
+                    candidates.push_back(sync_candidate {
+                        .priority        = accumulated,
+                        .component_index = (u16) Index,
+                        .entity          = entity,
+                        .data            = &cache->data
+                    });
+                }
+
+                pending.erase(stale_candidates.begin(), stale_candidates.end());
+            });
+
+
+            std::sort(candidates.begin(), candidates.end(), [] (const auto& a, const auto& b) { return a.priority > b.priority; });
+
+
+            // Only the budgeted changes count towards the budget, not removals or the state of newly visible entities already in the message.
+            std::size_t used = 0;
+            bool sent_any    = false;
+
+            for (const auto& candidate : candidates) {
+                // Smaller changes with a lower priority may still fit within the budget, so don't stop at the first one that doesn't.
+                if (sent_any && used + candidate.data->size() > bandwidth_budget) continue;
+
+                const std::size_t size_before = msg.data.size();
+
+                synchronized_types::foreach_indexed([&] <typename Component, std::size_t Index> {
+                    if (Index == candidate.component_index) push_change<Component>(connection, msg, owner, candidate.entity, *candidate.data);
+                });
+
+                pending_for_remote[candidate.component_index].erase(candidate.entity);
+
+                used    += msg.data.size() - size_before;
+                sent_any = true;
             }
         }
 
 
         // Add the data about which (visible) components were removed to the provided message.
-        template <typename Component> void add_removals_to_message(message_handler* connection, compound_message& msg, registry& owner, auto visibility_view, bool sync_timer_elapsed) {
+        template <typename Component> void add_removals_to_message(message_handler* connection, compound_message_v2& msg, registry& owner, auto visibility_view, bool sync_timer_elapsed) {
             // If the component was synced before and it has been removed since then, it will still have a cache.
             auto view_removed = visibility_view | owner.template view_pack<
                 typename RequiredTags::template append<sync_cache_component<Component>>,
@@ -369,6 +767,8 @@ namespace ve {
                     },
                     connection
                 );
+
+                erase_baseline<Component>(connection->get_remote_id(), entity);
             }
         }
 
@@ -2,6 +2,7 @@
 #include <VoxelEngine/engine_events.hpp>
 #include <VoxelEngine/utility/assert.hpp>
 #include <VoxelEngine/utility/io/paths.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
 #include <VoxelEngine/utility/thread/thread_pool.hpp>
 #include <VoxelEngine/clientserver/instance.hpp>
 #include <VoxelEngine/dependent/plugin_registry.hpp>
@@ -13,6 +14,8 @@
 #include <boost/exception/exception.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 
+#include <csignal>
+
 
 // In debug mode we often want the exception to not be intercepted, so we can see the point where it was thrown.
 #ifndef VE_DEBUG
@@ -21,6 +24,10 @@
 
 
 namespace ve {
+    // Without SDL, termination signals are not turned into exit requests, so they are handled here instead.
+    static volatile std::sig_atomic_t exit_signal_received = 0;
+
+
     [[noreturn]] void engine::main(i32 argc, char** argv) {
         engine::arguments.feed((std::size_t) argc, (const char**) argv);
 
@@ -65,6 +72,12 @@ namespace ve {
         
         if (immediate) engine::immediate_exit();
     }
+
+
+    void engine::set_headless(bool headless) {
+        VE_ASSERT(engine::engine_state == engine::state::UNINITIALIZED, "Headless mode must be set before the engine is initialized.");
+        engine::headless = headless;
+    }
     
     
     void engine::init(void) {
@@ -77,22 +90,40 @@ namespace ve {
         }
 
 
+        if (engine::arguments.has("headless")) engine::headless = true;
+
         engine::event_dispatcher.dispatch_event(engine_pre_init_event{});
         engine::engine_state = engine::state::INITIALIZING;
 
 
+        if (auto budget = engine::arguments.get<i64>("main_thread_budget_us"); budget) {
+            thread_pool::instance().set_main_thread_budget(microseconds { *budget });
+        }
+
+        engine::metrics_file        = engine::arguments.get<std::string>("metrics_file").value_or((io::paths::PATH_LOGS / "metrics.prom").string());
+        engine::metrics_interval    = milliseconds { engine::arguments.value_or<i64>("metrics_interval_ms", 10'000) };
+        engine::last_metrics_export = steady_clock::now();
+
+
         for (const auto& path : io::paths::get_registered_paths()) {
             fs::create_directories(path);
         }
 
 
-        SDL_SetMainReady();
-        SDL_Init(SDL_INIT_EVERYTHING);
+        if (engine::headless) {
+            VE_LOG_INFO("Running in headless mode.");
 
-        input_manager::instance().add_raw_handler(
-            [](const exit_requested_event&) { engine::exit(); },
-            priority::LOWEST // Give the game the opportunity to handle this event first.
-        );
+            std::signal(SIGINT,  [] (int) { exit_signal_received = 1; });
+            std::signal(SIGTERM, [] (int) { exit_signal_received = 1; });
+        } else {
+            SDL_SetMainReady();
+            SDL_Init(SDL_INIT_EVERYTHING);
+
+            input_manager::instance().add_raw_handler(
+                [](const exit_requested_event&) { engine::exit(); },
+                priority::LOWEST // Give the game the opportunity to handle this event first.
+            );
+        }
 
 
         {
@@ -128,13 +159,20 @@ namespace ve {
 
         engine::event_dispatcher.dispatch_event(engine_pre_loop_event { engine::tick_count });
 
-        gfx::window_registry::instance().begin_frame();
+        if (engine::headless) {
+            if (exit_signal_received) engine::exit();
+        } else {
+            gfx::window_registry::instance().begin_frame();
+            input_manager::instance().update(engine::tick_count);
+        }
 
-        input_manager::instance().update(engine::tick_count);
-        thread_pool::instance().execute_main_thread_tasks();
+        {
+            VE_PROFILE_FN("Main Thread Tasks");
+            thread_pool::instance().execute_main_thread_tasks();
+        }
         instance_registry::instance().update_all(last_dt);
 
-        gfx::window_registry::instance().end_frame();
+        if (!engine::headless) gfx::window_registry::instance().end_frame();
 
         engine::event_dispatcher.dispatch_event(engine_post_loop_event { engine::tick_count });
 
@@ -145,11 +183,39 @@ namespace ve {
 
         ++engine::tick_count;
         last_dt = time_since(tick_begin);
+
+        update_metrics(last_dt);
+    }
+
+
+    void engine::update_metrics(nanoseconds tick_time) {
+        VE_METRIC_HISTOGRAM("ve_engine_tick_seconds", "Duration of an engine tick.").observe(tick_time);
+        VE_METRIC_COUNTER("ve_engine_ticks_total", "Number of engine ticks.").add();
+
+
+        auto& pool = thread_pool::instance();
+        const auto main_stats = pool.get_main_thread_statistics();
+
+        VE_METRIC_GAUGE("ve_thread_pool_queued_jobs", "Number of jobs waiting for a worker thread.").set(f64(pool.get_num_queued()));
+        VE_METRIC_GAUGE("ve_main_thread_queued_tasks", "Number of tasks waiting for the main thread.").set(f64(std::reduce(main_stats.queue_depth.begin(), main_stats.queue_depth.end())));
+        VE_METRIC_GAUGE("ve_main_thread_task_latency_seconds", "Mean time main thread tasks executed during the last tick spent queued.").set(duration<f64> { main_stats.mean_latency }.count());
+
+
+        // Exporting is done on a worker, since writing the file could stall the main thread.
+        if (engine::metrics_interval > nanoseconds { 0 } && steady_clock::now() - engine::last_metrics_export >= engine::metrics_interval) {
+            engine::last_metrics_export = steady_clock::now();
+
+            pool.invoke_on_thread(
+                [path = engine::metrics_file] { metrics::registry::instance().export_to_file(path); },
+                job_priority::BACKGROUND_IO
+            );
+        }
     }
     
     
     [[noreturn]] void engine::immediate_exit(void) {
         if (profiler_active) VE_PROFILE_END(io::paths::PATH_LOGS / "profile_engine.opt");
+        if (engine::metrics_interval > nanoseconds { 0 }) metrics::registry::instance().export_to_file(engine::metrics_file);
 
         game_callbacks::pre_exit();
         engine::event_dispatcher.dispatch_event(engine_pre_exit_event { engine::exit_code });
@@ -166,7 +232,7 @@ namespace ve {
         );
 
 
-        SDL_Quit();
+        if (!engine::headless) SDL_Quit();
 
 
         engine::engine_state = engine::state::EXITED;
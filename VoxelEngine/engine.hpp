@@ -27,6 +27,13 @@ namespace ve {
         [[noreturn]] static void main(i32 argc, char** argv);
         static void exit(i32 code = 0, bool immediate = false);
 
+
+        // In headless mode, SDL video and input are not initialized and windows cannot be created,
+        // so the engine can run on machines without a display or GPU, e.g. as a dedicated server.
+        // Headless mode is enabled with the --headless argument, or by calling set_headless from game_callbacks::pre_init.
+        [[nodiscard]] static bool is_headless(void) { return headless; }
+        static void set_headless(bool headless);
+
         
         VE_GET_STATIC_CREF(arguments);
         VE_GET_STATIC_VAL(engine_state);
@@ -38,11 +45,18 @@ namespace ve {
         static inline u64 tick_count       = 0;
         static inline i32 exit_code        = -1;
         static inline bool profiler_active = false;
+        static inline bool headless        = false;
+
+        // Metrics are exported to this file periodically. An interval of zero disables exporting.
+        static inline fs::path metrics_file;
+        static inline nanoseconds metrics_interval = 10s;
+        static inline steady_clock::time_point last_metrics_export;
 
         static inline dispatcher_t event_dispatcher = {};
         
         static void init(void);
         static void loop(void);
+        static void update_metrics(nanoseconds tick_time);
         [[noreturn]] static void immediate_exit(void);
     };
 }
\ No newline at end of file
@@ -2,15 +2,32 @@
 
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/utility/thread/dummy_mutex.hpp>
+#include <VoxelEngine/utility/thread/spsc_queue.hpp>
 #include <VoxelEngine/utility/algorithm.hpp>
 #include <VoxelEngine/event/dispatcher.hpp>
+#include <VoxelEngine/event/event_type_index.hpp>
+#include <VoxelEngine/event/handler_list.hpp>
 
 #include <ctti/type_id.hpp>
 
 #include <mutex>
+#include <atomic>
 
 
 namespace ve {
+    namespace detail {
+        // Unique IDs for dispatchers and threads posting events to them.
+        // Unlike addresses and std::thread::id, these are never reused, so they can safely be cached by a thread.
+        inline std::atomic<u64> next_dispatcher_uid = 0, next_producer_uid = 0;
+
+        inline u64 current_producer_uid(void) {
+            thread_local const u64 uid = next_producer_uid++;
+            return uid;
+        }
+    }
+
+
+
     // An event handler that collects events internally and dispatches them all at once when dispatch_events is called.
     // Events of the same type are dispatched in the order they were added and are not interleaved with events of different types.
     // The order in which different event types are dispatched is not specified.
@@ -24,6 +41,11 @@ namespace ve {
     // the addition or removal of the handler is delayed until the dispatcher finishes doing so.
     // If the handler is added or removed while the dispatcher is dispatching a different type of event, or is not dispatching
     // any events, the addition or removal is processed immediately.
+    // Handlers can also be added as batch handlers, which receive all events of their type that are dispatched together as a single span.
+    // Other handlers still receive events one at a time, with additions and removals of handlers processed after every event
+    // (See detail::handler_list for the order of invocation).
+    // Threadsafe dispatchers additionally support post_event, a lock-free alternative to add_event for threads that produce many events
+    // without dispatching them themselves (e.g. I/O threads).
     template <bool Threadsafe = false, bool Cancellable = false, typename Priority = u16>
     class delayed_event_dispatcher : public dispatcher<
         delayed_event_dispatcher<Threadsafe, Cancellable, Priority>,
@@ -54,18 +76,7 @@ namespace ve {
             std::lock_guard lock { mtx };
 
             auto action = [this, handler = std::move(handler), p, id = next_id] () mutable {
-                constexpr auto type = ctti::unnamed_type_id<Event>();
-
-                auto it = handlers.find(type);
-                if (it == handlers.end()) {
-                    std::tie(it, std::ignore) = handlers.emplace(
-                        type,
-                        make_unique<handler_data<Event>>(pending_actions)
-                    );
-                }
-
-                auto& data = *((handler_data<Event>*) it->second.get());
-                data.handlers[p].emplace_back(id, std::move(handler));
+                get_handler_data<Event>().handlers.add(std::move(handler), p, id);
             };
 
             if (currently_dispatched == ctti::unnamed_type_id<Event>()) pending_actions.emplace_back(std::move(action));
@@ -75,13 +86,35 @@ namespace ve {
         }
 
 
+        template <typename Event>
+        handler_token add_batch_handler(batch_handler_t<Event> handler, Priority p = Priority(0)) {
+            std::lock_guard lock { mtx };
+
+            auto action = [this, handler = std::move(handler), p, id = next_id] () mutable {
+                get_handler_data<Event>().handlers.add_batch(std::move(handler), p, id);
+            };
+
+            if (currently_dispatched == ctti::unnamed_type_id<Event>()) pending_actions.emplace_back(std::move(action));
+            else action();
+
+            return handler_token { meta::type_wrapper<Event>{}, next_id++, this };
+        }
+
+
         template <typename Event>
         handler_token add_one_time_handler(handler_t<Event> handler, Priority p = Priority(0)) {
             std::lock_guard lock { mtx };
 
-            auto wrapping_handler = [this, id = next_id, handler = std::move(handler)] (const Event& event) mutable {
-                handler(event);
+            // Removal may be delayed until the current batch of events has been dispatched,
+            // so the handler must itself make sure it is not invoked again in the meantime.
+            auto wrapping_handler = [this, id = next_id, handler = std::move(handler), invoked = false] (const Event& event) mutable {
+                if (std::exchange(invoked, true)) {
+                    if constexpr (Cancellable) return false;
+                    else return;
+                }
+
                 remove_handler<Event>(id);
+                return handler(event);
             };
 
             return add_handler<Event>(std::move(wrapping_handler), p);
@@ -94,7 +127,7 @@ namespace ve {
 
             auto action = [this, id] {
                 if (auto it = handlers.find(ctti::unnamed_type_id<Event>()); it != handlers.end()) {
-                    it->second->erase(id);
+                    ((handler_data<Event>*) it->second.get())->handlers.erase(id);
                 }
             };
 
@@ -109,26 +142,27 @@ namespace ve {
 
             // No currently_dispatched check necessary here:
             // if this event type is currently being handled, this event will simply be handled as well.
-            auto type = ctti::unnamed_type_id<Event>();
-
-            auto it = handlers.find(type);
-            if (it == handlers.end()) {
-                std::tie(it, std::ignore) = handlers.emplace(
-                    type,
-                    make_unique<handler_data<Event>>(pending_actions)
-                );
-            }
-
             // Note: add will move the event, but it cannot be passed as Event&& due to type erasure.
-            it->second->add(&event);
-            handlers_with_events.insert(type);
+            get_handler_data<Event>().add(&event);
+            handlers_with_events.insert(ctti::unnamed_type_id<Event>());
 
             has_events = true;
         }
+
+
+        // Equivalent to add_event, but events are pushed to a queue owned by the calling thread, rather than taking the dispatcher's lock.
+        // After the first event of a given type, this does not lock or allocate, unless the thread alternates between dispatchers.
+        // Posted events are moved to the dispatcher at the start of dispatch_events. Events posted by the same thread are dispatched in order,
+        // but there is no ordering between posted events from different threads, or between posted events and events added with add_event.
+        template <typename Event> requires Threadsafe
+        void post_event(Event event) {
+            get_posted_queue<Event>().push(std::move(event));
+        }
         
         
         void dispatch_events(void) {
             std::lock_guard lock { mtx };
+            if constexpr (Threadsafe) collect_posted_events();
 
             // Cannot foreach, since handlers may insert new events.
             while (!handlers_with_events.empty()) {
@@ -145,6 +179,20 @@ namespace ve {
         }
 
 
+        // Dispatches the given events to the handlers for their type immediately, without adding them to the dispatcher.
+        // This allows the thread that dispatches events to hand over events it has collected itself without moving them into the dispatcher.
+        // Handlers are invoked the same way as for events dispatched by dispatch_events.
+        template <typename Event> void dispatch_events(std::span<const Event> events) {
+            if (events.empty()) return;
+
+            std::lock_guard lock { mtx };
+
+            auto previous = std::exchange(currently_dispatched, ctti::unnamed_type_id<Event>());
+            get_handler_data<Event>().dispatch(events);
+            currently_dispatched = previous;
+        }
+
+
         // Does this dispatcher have any handlers for the given event type?
         // This can be used as an optimisation before dispatching a large number of events of the same type.
         // Note: if this method returns false, event dispatching can be safely skipped, but this method returning true does not guarantee there are handlers.
@@ -154,8 +202,8 @@ namespace ve {
             // Cannot check, assume there are handlers.
             if (!pending_actions.empty()) return true;
 
-            if (auto it = handlers.find(ctti::type_id<Event>()); it != handlers.end()) {
-                return !it->second.empty();
+            if (auto it = handlers.find(ctti::unnamed_type_id<Event>()); it != handlers.end()) {
+                return !((handler_data<Event>*) it->second.get())->handlers.empty();
             }
 
             return false;
@@ -170,19 +218,27 @@ namespace ve {
 
         bool has_pending_events(void) const {
             std::lock_guard lock { mtx };
-            return has_events;
+            if (has_events) return true;
+
+            if constexpr (Threadsafe) {
+                std::lock_guard posted_lock { posted_mtx };
+
+                for (const auto& queues : posted_events) {
+                    if (queues && !queues->empty()) return true;
+                }
+            }
+
+            return false;
         }
     private:
         struct handler_data_base {
             virtual ~handler_data_base(void) = default;
             virtual void add(void* event) = 0;
             virtual void invoke(void) = 0;
-            virtual void erase(raw_handler id) = 0;
-            virtual bool empty(void) const = 0;
         };
         
         template <typename Event> struct handler_data : handler_data_base {
-            vec_map<Priority, std::vector<std::pair<raw_handler, handler_t<Event>>>> handlers;
+            detail::handler_list<Event, handler_t<Event>, Priority> handlers;
             std::vector<Event> events;
             std::vector<std::function<void(void)>>& pending_actions;
 
@@ -196,60 +252,118 @@ namespace ve {
             }
             
             void invoke(void) override {
-                // Note: handlers may dispatch additional events, so we can't use iterators here.
-                for (std::size_t i = 0; i < events.size(); ++i) {
-                    auto event = std::move(events[i]);
-
-                    for (auto& [p, handlers_for_p] : handlers | views::reverse) {
-                        for (auto& [id, handler] : handlers_for_p) {
-                            if constexpr (Cancellable) {
-                                if (std::invoke(handler, event)) goto event_done;
-                            } else {
-                                std::invoke(handler, event);
-                            }
-                        }
-                    }
+                // Handlers may add additional events of this type, so events are swapped out and dispatched in batches until none remain.
+                std::vector<Event> batch;
 
-                    event_done:
+                while (!events.empty()) {
+                    std::swap(batch, events);
+                    dispatch(batch);
+                    batch.clear();
+                }
+
+                // Keep the largest buffer, so adding events does not cause a reallocation every time.
+                if (batch.capacity() > events.capacity()) std::swap(batch, events);
+            }
+
+            void dispatch(std::span<const Event> batch) {
+                handlers.invoke(batch, [&] {
                     if (!pending_actions.empty()) [[unlikely]] {
                         for (auto& action : pending_actions) action();
                         pending_actions.clear();
                     }
+                });
+            }
+        };
+
+
+        // Queues of events posted with post_event. There is one queue for every thread that has posted events of the given type,
+        // so each queue has a single producer, and the thread calling dispatch_events is the single consumer.
+        struct posted_event_queues_base {
+            virtual ~posted_event_queues_base(void) = default;
+            virtual void collect(delayed_event_dispatcher& dispatcher) = 0;
+            virtual bool empty(void) const = 0;
+        };
+
+        template <typename Event> struct posted_event_queues : posted_event_queues_base {
+            std::vector<std::pair<u64, unique<spsc_queue<Event>>>> producers;
+
+
+            void collect(delayed_event_dispatcher& dispatcher) override {
+                handler_data<Event>* data = nullptr;
+
+                for (auto& [uid, queue] : producers) {
+                    queue->drain([&] (Event&& event) {
+                        if (!data) [[unlikely]] data = &dispatcher.template get_handler_data<Event>();
+                        data->add(&event);
+                    });
                 }
 
-                events.clear();
-            }
-            
-            void erase(raw_handler id) override {
-                auto check = [&](Priority p) {
-                    if (auto it = handlers.find(p); it != handlers.end()) {
-                        auto& handlers_for_p = it->second;
-                        
-                        for (auto elem_it = handlers_for_p.begin(); elem_it != handlers_for_p.end(); ++elem_it) {
-                            if (elem_it->first == id) {
-                                handlers_for_p.erase(elem_it);
-                                return true;
-                            }
-                        }
-                    }
-                    
-                    return false;
-                };
-                
-                
-                // Since 0 is the default priority, it is worth checking that one first,
-                // since it is the most likely one.
-                if (check(0)) return;
-                
-                for (Priority p : handlers | views::keys | views::remove(0)) {
-                    if (check(p)) return;
+                if (data) {
+                    dispatcher.handlers_with_events.insert(ctti::unnamed_type_id<Event>());
+                    dispatcher.has_events = true;
                 }
             }
 
             bool empty(void) const override {
-                return handlers.empty();
+                return std::ranges::all_of(producers, [] (const auto& producer) { return producer.second->empty(); });
             }
         };
+
+
+        template <typename Event> handler_data<Event>& get_handler_data(void) {
+            auto type = ctti::unnamed_type_id<Event>();
+
+            auto it = handlers.find(type);
+            if (it == handlers.end()) {
+                std::tie(it, std::ignore) = handlers.emplace(
+                    type,
+                    make_unique<handler_data<Event>>(pending_actions)
+                );
+            }
+
+            return *((handler_data<Event>*) it->second.get());
+        }
+
+
+        template <typename Event> spsc_queue<Event>& get_posted_queue(void) {
+            // Every thread caches the queue it last posted to, so the lock only has to be taken the first time a thread posts an event
+            // of a given type, or if it alternates between multiple dispatchers.
+            struct cached_queue {
+                u64 dispatcher_uid = max_value<u64>;
+                spsc_queue<Event>* queue = nullptr;
+            };
+
+            thread_local cached_queue cache;
+            if (cache.dispatcher_uid == dispatcher_uid) [[likely]] return *cache.queue;
+
+
+            std::lock_guard lock { posted_mtx };
+
+            const auto index = event_type_index::get<Event>();
+            if (index >= posted_events.size()) posted_events.resize(index + 1);
+
+            auto& queues = posted_events[index];
+            if (!queues) queues = make_unique<posted_event_queues<Event>>();
+
+            auto& producers = ((posted_event_queues<Event>*) queues.get())->producers;
+            const auto producer_uid = detail::current_producer_uid();
+
+            auto it = std::ranges::find(producers, producer_uid, [] (const auto& producer) { return producer.first; });
+            if (it == producers.end()) it = producers.insert(producers.end(), std::pair { producer_uid, make_unique<spsc_queue<Event>>() });
+
+            cache = cached_queue { dispatcher_uid, it->second.get() };
+            return *cache.queue;
+        }
+
+
+        // Must be called with mtx held, from the thread that dispatches events.
+        void collect_posted_events(void) {
+            std::lock_guard lock { posted_mtx };
+
+            for (auto& queues : posted_events) {
+                if (queues) queues->collect(*this);
+            }
+        }
         
         
         hash_map<ctti::type_index, unique<handler_data_base>> handlers;
@@ -260,5 +374,10 @@ namespace ve {
         std::optional<ctti::type_index> currently_dispatched;
         std::vector<std::function<void(void)>> pending_actions;
         bool has_events = false;
+
+        // Indexed by event_type_index. Producers only take posted_mtx when they add a new queue.
+        std::vector<unique<posted_event_queues_base>> posted_events;
+        mutable std::mutex posted_mtx;
+        u64 dispatcher_uid = detail::next_dispatcher_uid++;
     };
 }
\ No newline at end of file
@@ -7,5 +7,7 @@
 #include <VoxelEngine/event/delayed_event_dispatcher.hpp>
 #include <VoxelEngine/event/dispatcher.hpp>
 #include <VoxelEngine/event/event_handler_id.hpp>
+#include <VoxelEngine/event/event_type_index.hpp>
+#include <VoxelEngine/event/handler_list.hpp>
 #include <VoxelEngine/event/simple_event_dispatcher.hpp>
 #include <VoxelEngine/event/subscribe_only_view.hpp>
@@ -0,0 +1,14 @@
+#include <VoxelEngine/event/event_type_index.hpp>
+
+#include <mutex>
+
+
+namespace ve {
+    std::size_t event_type_index::assign(u64 type_id) {
+        static std::mutex mtx;
+        static hash_map<u64, std::size_t> indices;
+
+        std::lock_guard lock { mtx };
+        return indices.try_emplace(type_id, indices.size()).first->second;
+    }
+}
\ No newline at end of file
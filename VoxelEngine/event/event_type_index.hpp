@@ -0,0 +1,24 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+
+
+namespace ve {
+    // Assigns dense indices to event types, so dispatchers can store per-type data in flat arrays rather than hash maps.
+    // Indices are assigned the first time they are requested for a type, so only event types that are actually used take up a slot.
+    //
+    // Since the game and plugins are separate modules, each of them would have their own copy of any counter defined in this header.
+    // Instead, indices are assigned by the engine, keyed by the type's hash, which is the same in every module,
+    // so the same event type maps to the same index everywhere. Each module only caches the index it was given.
+    class event_type_index {
+    public:
+        event_type_index(void) = delete;
+
+        template <typename Event> static std::size_t get(void) {
+            static const std::size_t index = assign(type_hash<Event>());
+            return index;
+        }
+    private:
+        static std::size_t assign(u64 type_id);
+    };
+}
\ No newline at end of file
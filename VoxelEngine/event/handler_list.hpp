@@ -0,0 +1,138 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/event/event_handler_id.hpp>
+
+#include <span>
+
+
+namespace ve {
+    // Handler that receives multiple events of the same type at once.
+    // Batch handlers cannot cancel events, since they would have to cancel all events in the batch at once.
+    template <typename Event> using batch_handler_t = std::function<void(std::span<const Event>)>;
+
+
+    namespace detail {
+        // Flat list of the handlers for a single event type, sorted from highest to lowest priority.
+        // Handlers with the same priority are kept in the order they were added.
+        // Every handler receives either single events or spans of events, depending on how it was added.
+        // Handlers erased while a span of events is being dispatched are only marked as erased until the dispatch is done,
+        // so the list can keep track of its position between events.
+        template <typename Event, typename Handler, typename Priority> class handler_list {
+        public:
+            constexpr static bool is_cancellable = std::is_same_v<std::invoke_result_t<Handler&, const Event&>, bool>;
+
+
+            void add(Handler handler, Priority p, event_handler_id_t id) {
+                insert(entry { p, id, std::move(handler), nullptr });
+            }
+
+            void add_batch(batch_handler_t<Event> handler, Priority p, event_handler_id_t id) {
+                insert(entry { p, id, nullptr, std::move(handler) });
+            }
+
+
+            void erase(event_handler_id_t id) {
+                auto it = ranges::find(handlers, id, &entry::id);
+                if (it == handlers.end()) return;
+
+                if (span_dispatch_depth > 0) it->erased = true;
+                else handlers.erase(it);
+            }
+
+
+            bool empty(void) const {
+                return handlers.empty();
+            }
+
+
+            // Invokes all handlers for a single event. Batch handlers receive a span containing just this event.
+            void invoke(const Event& event) {
+                for (auto& entry : handlers) {
+                    if (entry.erased) continue;
+
+                    if (entry.batch_handler) {
+                        std::invoke(entry.batch_handler, std::span<const Event> { &event, 1 });
+                    } else if constexpr (is_cancellable) {
+                        if (std::invoke(entry.handler, event)) return;
+                    } else {
+                        std::invoke(entry.handler, event);
+                    }
+                }
+            }
+
+
+            // Invokes all handlers for all the given events. after_each_event is invoked after each event has been dispatched to the
+            // handlers receiving single events, and after each batch handler, and is where dispatchers apply deferred additions and removals
+            // of handlers. This way, handlers receiving single events see the same events as if every event was dispatched on its own.
+            // If handlers can cancel events, events are dispatched one at a time, and batch handlers receive spans of one event,
+            // since any handler may cancel an event for the handlers after it.
+            // Otherwise, each run of consecutive handlers receiving single events receives all events, one event at a time,
+            // after which the batch handler following them (if any) receives all events at once.
+            template <typename F> void invoke(std::span<const Event> events, F&& after_each_event) {
+                ++span_dispatch_depth;
+
+                if constexpr (is_cancellable) {
+                    for (const auto& event : events) {
+                        invoke(event);
+                        std::invoke(after_each_event);
+                    }
+                } else {
+                    // Handlers may be added between events, so keep track of the position by the last batch handler that was invoked.
+                    std::optional<event_handler_id_t> last_batch_handler;
+
+                    auto run_begin = [&] {
+                        if (!last_batch_handler) return std::size_t { 0 };
+                        return (std::size_t) std::distance(handlers.begin(), ranges::find(handlers, *last_batch_handler, &entry::id)) + 1;
+                    };
+
+
+                    while (run_begin() < handlers.size()) {
+                        // Invoke the run of handlers receiving single events up to the next batch handler, one event at a time.
+                        if (!handlers[run_begin()].batch_handler) {
+                            for (const auto& event : events) {
+                                for (std::size_t i = run_begin(); i < handlers.size() && !handlers[i].batch_handler; ++i) {
+                                    if (!handlers[i].erased) std::invoke(handlers[i].handler, event);
+                                }
+
+                                std::invoke(after_each_event);
+                            }
+                        }
+
+
+                        // Then invoke the batch handler following the run.
+                        std::size_t batch = run_begin();
+                        while (batch < handlers.size() && !handlers[batch].batch_handler) ++batch;
+                        if (batch == handlers.size()) break;
+
+                        last_batch_handler = handlers[batch].id;
+
+                        if (!handlers[batch].erased) {
+                            std::invoke(handlers[batch].batch_handler, events);
+                            std::invoke(after_each_event);
+                        }
+                    }
+                }
+
+                if (--span_dispatch_depth == 0) std::erase_if(handlers, [] (const entry& e) { return e.erased; });
+            }
+        private:
+            struct entry {
+                Priority priority;
+                event_handler_id_t id;
+                Handler handler;
+                batch_handler_t<Event> batch_handler;
+                bool erased = false;
+            };
+
+            std::vector<entry> handlers;
+            std::size_t span_dispatch_depth = 0;
+
+
+            void insert(entry&& e) {
+                auto it = ranges::find_if(handlers, [&] (const entry& other) { return other.priority < e.priority; });
+                handlers.insert(it, std::move(e));
+            }
+        };
+    }
+}
\ No newline at end of file
@@ -4,8 +4,8 @@
 #include <VoxelEngine/utility/assert.hpp>
 #include <VoxelEngine/utility/thread/dummy_mutex.hpp>
 #include <VoxelEngine/event/dispatcher.hpp>
-
-#include <ctti/type_id.hpp>
+#include <VoxelEngine/event/event_type_index.hpp>
+#include <VoxelEngine/event/handler_list.hpp>
 
 #include <mutex>
 
@@ -19,6 +19,10 @@ namespace ve {
     // If a new event is recursively received while another event is being dispatched, the new event is completed first.
     // If event handlers are added or removed while one or more events are being dispatched, this addition or removal
     // is processed after all aforementioned events have finished being dispatched.
+    // Handlers are stored in a flat array per event type, indexed by event_type_index and sorted by priority,
+    // so dispatching an event type without handlers only costs an index lookup.
+    // Handlers can also be added as batch handlers, which receive a span of events. Events dispatched one at a time are passed to them
+    // as a span of one event, while dispatch_events passes all given events at once (See detail::handler_list for the order of invocation).
     template <bool Threadsafe = false, bool Cancellable = false, typename Priority = u16>
     class simple_event_dispatcher : public dispatcher<
         simple_event_dispatcher<Threadsafe, Cancellable, Priority>,
@@ -49,13 +53,31 @@ namespace ve {
             std::lock_guard lock { mtx };
 
 
-            if (is_dispatching(ctti::unnamed_type_id<Event>())) [[unlikely]] {
+            if (is_dispatching(event_type_index::get<Event>())) [[unlikely]] {
                 // Cannot use bind_front here due to mutability.
                 pending_actions.emplace_back([this, handler = std::move(handler), p, id = next_id] () mutable {
-                    add_handler_impl<Event>(std::move(handler), p, id);
+                    get_handler_data<Event>().handlers.add(std::move(handler), p, id);
+                });
+            } else {
+                get_handler_data<Event>().handlers.add(std::move(handler), p, next_id);
+            }
+
+
+            return handler_token { meta::type_wrapper<Event>{}, next_id++, this };
+        }
+
+
+        template <typename Event>
+        [[nodiscard]] handler_token add_batch_handler(batch_handler_t<Event> handler, Priority p = Priority(0)) {
+            std::lock_guard lock { mtx };
+
+
+            if (is_dispatching(event_type_index::get<Event>())) [[unlikely]] {
+                pending_actions.emplace_back([this, handler = std::move(handler), p, id = next_id] () mutable {
+                    get_handler_data<Event>().handlers.add_batch(std::move(handler), p, id);
                 });
             } else {
-                add_handler_impl<Event>(std::move(handler), p, next_id);
+                get_handler_data<Event>().handlers.add_batch(std::move(handler), p, next_id);
             }
 
 
@@ -67,9 +89,16 @@ namespace ve {
         [[nodiscard]] handler_token add_one_time_handler(handler_t<Event> handler, Priority p = Priority(0)) {
             std::lock_guard lock { mtx };
 
-            auto wrapping_handler = [this, id = next_id, handler = std::move(handler)] (const Event& event) mutable {
-                handler(event);
+            // Removal is delayed until the dispatcher is done dispatching events of this type,
+            // so the handler must itself make sure it is not invoked again in the meantime.
+            auto wrapping_handler = [this, id = next_id, handler = std::move(handler), invoked = false] (const Event& event) mutable {
+                if (std::exchange(invoked, true)) {
+                    if constexpr (Cancellable) return false;
+                    else return;
+                }
+
                 remove_handler<Event>(id);
+                return handler(event);
             };
 
             return add_handler<Event>(std::move(wrapping_handler), p);
@@ -81,13 +110,11 @@ namespace ve {
 
 
             auto remove = [this, id] {
-                if (auto it = handlers.find(ctti::unnamed_type_id<Event>()); it != handlers.end()) {
-                    it->second->erase(id);
-                }
+                if (auto* data = find_handler_data<Event>(); data) data->handlers.erase(id);
             };
 
 
-            if (is_dispatching(ctti::unnamed_type_id<Event>())) [[unlikely]] {
+            if (is_dispatching(event_type_index::get<Event>())) [[unlikely]] {
                 pending_actions.emplace_back(std::move(remove));
             } else {
                 remove();
@@ -99,25 +126,48 @@ namespace ve {
         void dispatch_event(const Event& event) {
             std::lock_guard lock { mtx };
 
-            constexpr auto type = ctti::unnamed_type_id<Event>();
+
+            // Many events (e.g. component events from the registry) are dispatched without anyone listening to them,
+            // so skip all bookkeeping if there are no handlers.
+            auto* data = find_handler_data<Event>();
+            if (!data || data->handlers.empty()) return;
 
 
             // Keep track of events being dispatched to we don't edit storage while iterating
             // if the handler itself interacts with the dispatcher.
-            currently_dispatched.push_back(type);
+            currently_dispatched.push_back(event_type_index::get<Event>());
+            data->handlers.invoke(event);
+            currently_dispatched.pop_back();
 
-            if (auto it = handlers.find(type); it != handlers.end()) {
-                it->second->invoke(&event);
-            }
+            execute_pending_actions();
+        }
 
-            currently_dispatched.pop_back();
 
+        // Dispatches all the given events, with the same overhead as dispatching a single event.
+        // Additions and removals of handlers for this event type by the handlers are processed after every event,
+        // like they would be if the events were dispatched one at a time.
+        template <typename Event>
+        void dispatch_events(std::span<const Event> events) {
+            std::lock_guard lock { mtx };
 
-            // Execute any actions we couldn't perform during handling of the event.
-            if (currently_dispatched.empty() && !pending_actions.empty()) [[unlikely]] {
-                for (const auto& action : pending_actions) action();
-                pending_actions.clear();
-            }
+            auto* data = find_handler_data<Event>();
+            if (!data || data->handlers.empty() || events.empty()) return;
+
+
+            const auto index = event_type_index::get<Event>();
+            currently_dispatched.push_back(index);
+
+            data->handlers.invoke(events, [&] {
+                if (pending_actions.empty()) [[likely]] return;
+
+                currently_dispatched.pop_back();
+                execute_pending_actions();
+                currently_dispatched.push_back(index);
+            });
+
+            currently_dispatched.pop_back();
+
+            execute_pending_actions();
         }
 
 
@@ -127,11 +177,8 @@ namespace ve {
             // Cannot check, assume there are handlers.
             if (!pending_actions.empty()) return true;
 
-            if (auto it = handlers.find(ctti::type_id<Event>()); it != handlers.end()) {
-                return !it->second->empty();
-            }
-
-            return false;
+            auto* data = find_handler_data<Event>();
+            return data && !data->handlers.empty();
         }
 
 
@@ -139,27 +186,7 @@ namespace ve {
             return false;
         }
     private:
-        template <typename Event>
-        void add_handler_impl(handler_t<Event>&& handler, Priority p, raw_handler id) {
-            std::lock_guard lock { mtx };
-
-
-            constexpr auto type = ctti::unnamed_type_id<Event>();
-
-            auto it = handlers.find(type);
-            if (it == handlers.end()) {
-                std::tie(it, std::ignore) = handlers.emplace(
-                    type,
-                    make_unique<handler_data<Event>>()
-                );
-            }
-
-            auto& data = *((handler_data<Event>*) it->second.get());
-            data.handlers[p].emplace_back(id, std::move(handler));
-        }
-
-
-        bool is_dispatching(ctti::type_index type) const {
+        bool is_dispatching(std::size_t type) const {
             if (!currently_dispatched.empty()) [[unlikely]] {
                 if (auto it = ranges::find(currently_dispatched, type); it != currently_dispatched.end()) {
                     return true;
@@ -170,65 +197,47 @@ namespace ve {
         }
 
 
+        // Execute any actions we couldn't perform during handling of the event.
+        void execute_pending_actions(void) {
+            if (currently_dispatched.empty() && !pending_actions.empty()) [[unlikely]] {
+                for (const auto& action : pending_actions) action();
+                pending_actions.clear();
+            }
+        }
+
+
         struct handler_data_base {
             virtual ~handler_data_base(void) = default;
-            virtual void invoke(const void* event) = 0;
-            virtual void erase(raw_handler id) = 0;
-            virtual bool empty(void) const = 0;
         };
-    
-        template <typename Event> struct handler_data : handler_data_base {
-            vec_map<Priority, std::vector<std::pair<raw_handler, handler_t<Event>>>> handlers;
-            
-            void invoke(const void* event) override {
-                for (auto& [p, handlers_for_p] : handlers | views::reverse) {
-                    for (auto& [id, handler] : handlers_for_p) {
-                        if constexpr (Cancellable) {
-                            if (std::invoke(handler, *((const Event*) event))) return;
-                        } else {
-                            std::invoke(handler, *((const Event*) event));
-                        }
-                    }
-                }
-            }
-            
-            void erase(raw_handler id) override {
-                auto check = [&](Priority p) {
-                    if (auto it = handlers.find(p); it != handlers.end()) {
-                        auto& handlers_for_p = it->second;
-                        
-                        for (auto elem_it = handlers_for_p.begin(); elem_it != handlers_for_p.end(); ++elem_it) {
-                            if (elem_it->first == id) {
-                                handlers_for_p.erase(elem_it);
-                                return true;
-                            }
-                        }
-                    }
-                    
-                    return false;
-                };
-                
-                
-                // Since 0 is the default priority, it is worth checking that one first,
-                // since it is the most likely one.
-                if (check(0)) return;
-                
-                for (Priority p : handlers | views::keys | views::remove(0)) {
-                    if (check(p)) return;
-                }
-            }
 
-            bool empty(void) const override {
-                return handlers.empty();
-            }
+        template <typename Event> struct handler_data : handler_data_base {
+            detail::handler_list<Event, handler_t<Event>, Priority> handlers;
         };
+
+
+        template <typename Event> handler_data<Event>& get_handler_data(void) {
+            const auto index = event_type_index::get<Event>();
+            if (index >= handlers.size()) handlers.resize(index + 1);
+
+            auto& data = handlers[index];
+            if (!data) data = make_unique<handler_data<Event>>();
+
+            return *((handler_data<Event>*) data.get());
+        }
+
+
+        template <typename Event> handler_data<Event>* find_handler_data(void) {
+            const auto index = event_type_index::get<Event>();
+            return index < handlers.size() ? (handler_data<Event>*) handlers[index].get() : nullptr;
+        }
         
         
-        hash_map<ctti::type_index, unique<handler_data_base>> handlers;
+        // Indexed by event_type_index.
+        std::vector<unique<handler_data_base>> handlers;
         raw_handler next_id = 0;
         mutable lock_t mtx;
 
-        std::vector<ctti::type_index> currently_dispatched;
+        std::vector<std::size_t> currently_dispatched;
         std::vector<std::function<void(void)>> pending_actions;
     };
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ namespace ve {
         using Dispatcher::add_raw_handler;
         using Dispatcher::add_one_time_handler;
         using Dispatcher::add_one_time_raw_handler;
+        using Dispatcher::add_batch_handler;
         using Dispatcher::remove_handler;
 
 
@@ -1,6 +1,8 @@
 #include <VoxelEngine/graphics/presentation/window.hpp>
+#include <VoxelEngine/engine.hpp>
 #include <VoxelEngine/graphics/texture/utility/utility.hpp>
 #include <VoxelEngine/input/input_manager.hpp>
+#include <VoxelEngine/utility/assert.hpp>
 #include <VoxelEngine/utility/priority.hpp>
 #include <VoxelEngine/utility/raii.hpp>
 #include <VoxelEngine/utility/io/file_io.hpp>
@@ -10,6 +12,7 @@
 namespace ve::gfx {
     void window::init(const window::arguments& args) {
         VE_PROFILE_FN();
+        VE_ASSERT(!engine::is_headless(), "Cannot create window ", args.title, " while the engine is running in headless mode.");
 
         if (args.graphics_window) gfxapi::prepare_api_state(args.api_settings);
 
@@ -5,7 +5,7 @@
 #include <VoxelEngine/utility/functional.hpp>
 #include <VoxelEngine/utility/io/file_io.hpp>
 #include <VoxelEngine/utility/io/image.hpp>
-#include <VoxelEngine/utility/thread/thread_pool.hpp>
+#include <VoxelEngine/utility/thread/task.hpp>
 #include <VoxelEngine/graphics/texture/missing_texture.hpp>
 #include <VoxelEngine/graphics/texture/texture_source.hpp>
 #include <VoxelEngine/graphics/texture/generative_texture_atlas.hpp>
@@ -27,7 +27,7 @@ namespace ve::gfx {
 
         // Loads the texture from the given source, if it is not cached already, otherwise returns the cached value.
         template <typename Pixel> subtexture get_or_load(texture_source<Pixel>& src) {
-            std::unique_lock lock { mtx };
+            std::unique_lock lock { *mtx };
 
             const std::string name = src.name();
             if (auto tex = get_if_exists(name); tex) return *tex;
@@ -42,7 +42,7 @@ namespace ve::gfx {
         // Same as above, but guarantees that all subtextures will be part of the same texture.
         // If the combination of images is too large to fit on a single texture, this method throws.
         template <typename Pixel> std::vector<subtexture> get_or_load_to_common_texture(const std::vector<texture_source<Pixel>*>& sources) {
-            std::unique_lock lock { mtx };
+            std::unique_lock lock { *mtx };
 
             auto names = sources | views::indirect | views::transform(&texture_source<Pixel>::name);
             if (auto textures = get_if_exists_common_texture(names); !textures.empty()) return textures;
@@ -76,7 +76,7 @@ namespace ve::gfx {
 
 
         void remove_texture(std::string_view name) {
-            std::unique_lock lock { mtx };
+            std::unique_lock lock { *mtx };
 
             auto it = subtextures.find(name);
             if (it == subtextures.end()) return;
@@ -87,7 +87,7 @@ namespace ve::gfx {
 
 
         bool is_loaded(std::string_view name) const {
-            std::shared_lock lock { mtx };
+            std::shared_lock lock { *mtx };
             return subtextures.contains(name);
         }
 
@@ -108,7 +108,8 @@ namespace ve::gfx {
         // main thread to do anything graphics related anyway.
         // Worst case scenario a broken texture is observed for a single frame until the main thread patches it.
         // TODO: This is not ideal and a better implementation should be found later.
-        mutable std::shared_mutex mtx;
+        // The mutex is shared with the tasks that fill the reserved storage on the main thread, so they can outlive the manager.
+        shared<std::shared_mutex> mtx = make_shared<std::shared_mutex>();
 
 
         // Note: calling method is responsible for acquiring lock.
@@ -193,13 +194,30 @@ namespace ve::gfx {
 
             // Actual graphics API actions are performed on the main thread since some APIs (notably OpenGL)
             // don't support calls from different threads, even if they are not ran in parallel.
-            thread_pool::instance().invoke_on_main_or_run([&] {
-                std::unique_lock lock { mtx };
+            // Rather than waiting for the main thread, other threads hand the images to a task that stores them once the main thread gets to it.
+            if (thread_pool::instance().is_main_thread()) {
+                std::unique_lock lock { *mtx };
                 atlas->store_all_at(images | views::values | ranges::to<std::vector>, result);
-            });
+            } else {
+                spawn(store_on_main(
+                    atlas,
+                    mtx,
+                    images | views::values | views::indirect | ranges::to<std::vector>,
+                    result
+                ));
+            }
 
 
             return result;
         }
+
+
+        // Images are passed by value, since their sources are released as soon as load_to_common_texture returns.
+        static task<> store_on_main(shared<Atlas> atlas, shared<std::shared_mutex> mtx, std::vector<image_rgba8> images, std::vector<subtexture> where) {
+            co_await resume_on_main();
+
+            std::unique_lock lock { *mtx };
+            atlas->store_all_at(images | views::transform([] (const image_rgba8& img) { return &img; }) | ranges::to<std::vector>, where);
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/ecs/system/system_spatial_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+
+using namespace ve::defs;
+
+
+test_result test_main(void) {
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    // Every client observes the cells around the origin. With a cell size of 10 and a range of 1, this is [-10, 20) on every axis.
+    auto rule = [] (const ve::registry& owner, const ve::message_handler* connection) {
+        return std::optional<vec3f> { vec3f { 0 } };
+    };
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_spatial_visibility { rule, 10.0f, 1 });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<ve::transform_component>> { visibility_system });
+
+
+    entt::entity near_entity         = server.create_entity();
+    entt::entity far_entity          = server.create_entity();
+    entt::entity positionless_entity = server.create_entity();
+
+    server.set_component(near_entity, ve::transform_component { .position = vec3f { 5, 5, 5 } });
+    server.set_component(far_entity,  ve::transform_component { .position = vec3f { 100, 0, 0 } });
+
+
+    auto check_visibility = [&] (entt::entity entity, bool expected, std::string_view name) -> test_result {
+        if (client.get_storage().valid(entity) != expected) {
+            return VE_TEST_FAIL("Entity ", name, " should ", expected ? "" : "not ", "be visible on the client.");
+        }
+
+        return VE_TEST_SUCCESS;
+    };
+
+
+    server.update(1ns);
+    client.update(1ns);
+
+    test_result result = VE_TEST_SUCCESS;
+    result |= check_visibility(near_entity, true, "near");
+    result |= check_visibility(far_entity, false, "far");
+    result |= check_visibility(positionless_entity, true, "positionless");
+
+    if (!visibility_system.became_visible_for_remote(client.get_id()).contains(near_entity)) {
+        result |= VE_TEST_FAIL("Entity near should be in the became-visible view after it was first synchronized.");
+    }
+
+
+    // Moving entities across cells should update their visibility.
+    server.get_component<ve::transform_component>(near_entity).position = vec3f { -50, 0, 0 };
+    server.get_component<ve::transform_component>(far_entity).position  = vec3f { 0, 0, 15 };
+
+    server.update(1ns);
+    client.update(1ns);
+
+    result |= check_visibility(near_entity, false, "near");
+    result |= check_visibility(far_entity, true, "far");
+
+    if (!visibility_system.became_invisible_for_remote(client.get_id()).contains(near_entity)) {
+        result |= VE_TEST_FAIL("Entity near should be in the became-invisible view after it left the observed cells.");
+    }
+
+
+    // Destroyed entities should be removed from the client.
+    server.destroy_entity(far_entity);
+
+    server.update(1ns);
+    client.update(1ns);
+
+    result |= check_visibility(far_entity, false, "far");
+
+
+    return result;
+}
\ No newline at end of file
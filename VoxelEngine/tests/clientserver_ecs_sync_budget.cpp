@@ -0,0 +1,104 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+
+using namespace ve::defs;
+
+
+struct test_component {
+    i32 x, y;
+};
+
+
+test_result test_main(void) {
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<test_component>> { visibility_system });
+
+
+    constexpr i32 num_entities = 10;
+
+    std::vector<entt::entity> entities;
+    entities.reserve(num_entities);
+
+    for (i32 i = 0; i < num_entities; ++i) {
+        entt::entity e = server.create_entity();
+        server.set_component(e, test_component { i, 2 * i });
+
+        entities.push_back(e);
+    }
+
+
+    // Entities with a higher index have a higher priority, so they should be synchronized first.
+    sync_system.set_bandwidth_budget(64);
+    sync_system.set_sync_rate<test_component>(0ns);
+    sync_system.set_sync_priority_function([&] (const ve::registry& owner, entt::entity entity, const ve::message_handler* connection) {
+        return (f32) (1 + owner.get_component<test_component>(entity).x);
+    });
+
+
+    auto num_synchronized = [&] {
+        return ranges::count_if(entities, [&] (auto e) {
+            return
+                client.get_storage().valid(e) &&
+                client.has_component<test_component>(e) &&
+                client.get_component<test_component>(e).y == server.get_component<test_component>(e).y;
+        });
+    };
+
+
+    // Entities that just became visible are always sent in full, regardless of the budget.
+    server.update(1ns);
+    client.update(1ns);
+
+    if (auto count = num_synchronized(); count != num_entities) {
+        return VE_TEST_FAIL("Newly visible entities were deferred by the bandwidth budget (Got ", count, ").");
+    }
+
+
+    // Changes to entities that are already visible are subject to the budget.
+    for (auto e : entities) server.get_component<test_component>(e).y += 1;
+
+    server.update(1ns);
+    client.update(1ns);
+
+    auto synchronized_after_first = num_synchronized();
+
+    if (synchronized_after_first == 0 || synchronized_after_first == num_entities) {
+        return VE_TEST_FAIL("Expected the bandwidth budget to limit synchronization to some but not all entities (Got ", synchronized_after_first, ").");
+    }
+
+    if (client.get_component<test_component>(entities.back()).y != server.get_component<test_component>(entities.back()).y) {
+        return VE_TEST_FAIL("Entity with the highest priority was not synchronized first.");
+    }
+
+
+    // Deferred changes should eventually be sent.
+    for (i32 i = 0; i < num_entities; ++i) {
+        server.update(1ns);
+        client.update(1ns);
+    }
+
+    if (auto count = num_synchronized(); count != num_entities) {
+        return VE_TEST_FAIL("Not all entities were synchronized after the budget allowed for it (Got ", count, ").");
+    }
+
+
+    for (i32 i = 0; i < num_entities; ++i) {
+        const auto& component = client.get_component<test_component>(entities[i]);
+
+        if (component.x != i || component.y != 2 * i + 1) {
+            return VE_TEST_FAIL("Entity ", entities[i], " has an incorrect value for test_component.");
+        }
+    }
+
+
+    return VE_TEST_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+#include <VoxelEngine/utility/io/serialize/delta_serializer.hpp>
+
+using namespace ve::defs;
+
+
+// Same layout as transform_component, but with quantization hints for delta encoding.
+struct quantized_transform {
+    constexpr static f32 delta_vec3_precision = 1.0f / 1024.0f;
+    using delta_quantize_quaternions_tag = void;
+
+    vec3f position = vec3f { 0 };
+    vec3f scale    = vec3f { 1 };
+    quatf rotation = glm::identity<quatf>();
+};
+
+
+// Test round-trip delta encoding for both field-wise and blob-encoded types.
+test_result test_delta_serializer(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+
+    ve::transform_component old_transform, new_transform;
+    new_transform.position = vec3f { 1, 2, 3 };
+
+    std::vector<u8> delta;
+    ve::serialize::delta_to_bytes(old_transform, new_transform, delta);
+
+    std::span<const u8> delta_span { delta.begin(), delta.end() };
+    ve::serialize::apply_delta(old_transform, delta_span);
+
+    if (old_transform.position != new_transform.position || !delta_span.empty()) {
+        result |= VE_TEST_FAIL("Field-wise delta did not reconstruct transform correctly.");
+    }
+
+    if (delta.size() >= ve::serialize::to_bytes(new_transform).size()) {
+        result |= VE_TEST_FAIL("Field-wise delta for a single changed field should be smaller than the full value.");
+    }
+
+
+    std::string old_string = "Lorem ipsum dolor sit amet, consectetur adipiscing elit.";
+    std::string new_string = "Lorem ipsum dolor sit amet, consectetur adipiscing elif.";
+
+    delta.clear();
+    ve::serialize::delta_to_bytes(old_string, new_string, delta);
+
+    delta_span = std::span<const u8> { delta.begin(), delta.end() };
+    ve::serialize::apply_delta(old_string, delta_span);
+
+    if (old_string != new_string || !delta_span.empty()) {
+        result |= VE_TEST_FAIL("Blob delta did not reconstruct string correctly.");
+    }
+
+
+    quantized_transform old_quantized, new_quantized;
+    new_quantized.rotation = glm::normalize(quatf { 0.3f, -0.5f, 0.1f, 0.8f });
+
+    delta.clear();
+    ve::serialize::delta_to_bytes(old_quantized, new_quantized, delta);
+
+    delta_span = std::span<const u8> { delta.begin(), delta.end() };
+    ve::serialize::apply_delta(old_quantized, delta_span);
+
+    if (std::abs(glm::dot(old_quantized.rotation, new_quantized.rotation)) < 0.999f) {
+        result |= VE_TEST_FAIL("Smallest-three encoding did not reconstruct rotation within tolerance.");
+    }
+
+
+    // A baseline advanced by the sender should match the quantized value decoded by the receiver exactly.
+    quantized_transform sender_baseline, receiver_value;
+
+    for (i32 i = 0; i < 10; ++i) {
+        new_quantized.position += vec3f { 0.1234f, -0.0001f, 3.3333f };
+        new_quantized.rotation  = glm::normalize(new_quantized.rotation * quatf { 0.99f, 0.01f, 0.1f, 0.0f });
+
+        delta.clear();
+        ve::serialize::delta_to_bytes_and_advance(sender_baseline, new_quantized, delta);
+
+        delta_span = std::span<const u8> { delta.begin(), delta.end() };
+        ve::serialize::apply_delta(receiver_value, delta_span);
+
+        if (ve::serialize::to_bytes(sender_baseline) != ve::serialize::to_bytes(receiver_value)) {
+            result |= VE_TEST_FAIL("Advanced delta baseline does not match the value decoded by the receiver.");
+            break;
+        }
+    }
+
+
+    return result;
+}
+
+
+// Synchronizes moving transforms, checks that the client receives them correctly and returns the number of bytes sent.
+template <typename Transform> std::size_t synchronize_transforms(bool use_delta, test_result& result) {
+    constexpr std::size_t num_entities = 100;
+    constexpr std::size_t num_ticks    = 10;
+
+
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<Transform>> { visibility_system });
+
+    sync_system.template set_sync_rate<Transform>(0ns);
+    sync_system.template set_delta_encoding<Transform>(use_delta);
+
+
+    std::vector<entt::entity> entities;
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        entt::entity e = server.create_entity();
+        server.set_component(e, Transform { .position = vec3f { (f32) i, 0, 0 } });
+
+        entities.push_back(e);
+    }
+
+    // First update sends every component in full, so don't count it.
+    server.update(1ns);
+    client.update(1ns);
+
+
+    std::size_t bytes = 0;
+    client.get_server_connection()->add_handler(
+        ve::core_message_types::MSG_COMPOUND_V2,
+        [&] (const ve::compound_message_v2& msg) { bytes += msg.data.size(); }
+    );
+
+
+    for (std::size_t tick = 0; tick < num_ticks; ++tick) {
+        for (auto e : entities) server.template get_component<Transform>(e).position.y += 0.25f;
+
+        server.update(1ns);
+        client.update(1ns);
+    }
+
+
+    for (auto e : entities) {
+        const auto& expected = server.template get_component<Transform>(e);
+        const auto* actual   = client.template try_get_component<Transform>(e);
+
+        if (!actual || glm::distance(actual->position, expected.position) > 0.01f) {
+            result |= VE_TEST_FAIL("Transform of entity ", e, " was not synchronized correctly (", ctti::nameof<Transform>(), ", delta: ", use_delta, ").");
+            break;
+        }
+    }
+
+
+    return bytes;
+}
+
+
+// If the client changes its copy of a component, deltas from the server no longer apply to it,
+// so the client should reject them and receive the full value instead.
+test_result test_baseline_mismatch(void) {
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<ve::transform_component>> { visibility_system });
+
+    sync_system.template set_sync_rate<ve::transform_component>(0ns);
+    sync_system.template set_delta_encoding<ve::transform_component>(true);
+
+
+    entt::entity e = server.create_entity();
+    server.set_component(e, ve::transform_component { .position = vec3f { 1, 2, 3 } });
+
+    server.update(1ns);
+    client.update(1ns);
+
+    client.get_component<ve::transform_component>(e).position.x = 1000.0f;
+
+
+    // The first update sends a delta, which the client rejects, the second one sends the full value.
+    for (u32 i = 0; i < 2; ++i) {
+        server.get_component<ve::transform_component>(e).position.y += 1.0f;
+
+        server.update(1ns);
+        client.update(1ns);
+    }
+
+
+    const auto& expected = server.get_component<ve::transform_component>(e);
+    const auto* actual   = client.try_get_component<ve::transform_component>(e);
+
+    if (!actual || actual->position != expected.position) {
+        return VE_TEST_FAIL("Client did not receive the full value after rejecting a delta against a different baseline.");
+    }
+
+    return VE_TEST_SUCCESS;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+    result |= test_delta_serializer();
+    result |= test_baseline_mismatch();
+
+
+    // Only one field changes every tick, so delta encoding should always send fewer bytes than sending the full value.
+    // (See the system_synchronizer benchmarks for the actual number of bytes per transform.)
+    const auto full_bytes  = synchronize_transforms<ve::transform_component>(false, result);
+    const auto delta_bytes = synchronize_transforms<ve::transform_component>(true, result);
+    synchronize_transforms<quantized_transform>(true, result);
+
+
+    if (delta_bytes >= full_bytes) {
+        result |= VE_TEST_FAIL("Delta encoding did not reduce the number of bytes sent per transform.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
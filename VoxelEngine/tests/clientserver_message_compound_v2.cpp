@@ -0,0 +1,216 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/clientserver/core_messages/msg_compound.hpp>
+
+
+using namespace ve::defs;
+
+
+struct text_message {
+    std::string text;
+};
+
+
+// Similar to set_component_message, which makes up the bulk of compound messages sent by the synchronizer.
+struct update_message {
+    std::vector<u8> data;
+    u64 type;
+    u32 entity;
+};
+
+
+// Checks that messages are received in the order they were added, including runs long enough to require multi-byte counts,
+// and messages large enough to require multi-byte lengths.
+test_result test_ordering(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    std::vector<std::string> received;
+
+    client.get_server_connection()->add_handler(
+        "ve.test.text_message",
+        [&] (const text_message& msg) { received.push_back(msg.text); }
+    );
+
+    client.get_server_connection()->add_handler(
+        "ve.test.update_message",
+        [&] (const update_message& msg) { received.push_back(ve::cat("update ", msg.entity, " ", msg.data.size())); }
+    );
+
+
+    auto connection = server.get_connections().front();
+
+    ve::compound_message_v2 msg;
+    std::vector<std::string> expected;
+
+    auto push_text = [&] (std::string text) {
+        msg.push_message("ve.test.text_message", text_message { text }, connection.get());
+        expected.push_back(std::move(text));
+    };
+
+    auto push_update = [&] (u32 entity, std::size_t size) {
+        msg.push_message("ve.test.update_message", update_message { std::vector<u8>(size, 0xAB), 0, entity }, connection.get());
+        expected.push_back(ve::cat("update ", entity, " ", size));
+    };
+
+
+    push_text("First message.");
+    push_text("Second message.");
+    for (u32 i = 0; i < 200; ++i) push_update(i, 16);
+    push_text(std::string(300, 'x'));
+    push_update(200, 20'000);
+    push_text("Last message.");
+
+    connection->send_message(ve::core_message_types::MSG_COMPOUND_V2, msg);
+
+
+    if (received != expected) {
+        result |= VE_TEST_FAIL("Messages in compound message were not received in order (", received.size(), " / ", expected.size(), " received).");
+    }
+
+
+    // Also check the serialized form, which is used when the message arrives over a socket.
+    received.clear();
+
+    auto serialized = ve::serialize::to_bytes(msg);
+    auto view       = std::span<const u8> { serialized.begin(), serialized.end() };
+
+    ve::on_msg_compound_v2_view_received(client, *client.get_server_connection(), view);
+
+    if (received != expected) {
+        result |= VE_TEST_FAIL("Messages in serialized compound message were not received in order.");
+    }
+
+
+    return result;
+}
+
+
+// Checks that malformed compound messages from a remote are rejected as a whole, rather than being read out of bounds.
+test_result test_malformed(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    std::size_t received = 0;
+
+    client.get_server_connection()->add_handler(
+        "ve.test.text_message",
+        [&] (const text_message& msg) { ++received; }
+    );
+
+
+    auto connection = server.get_connections().front();
+
+    ve::compound_message_v2 valid;
+    valid.push_message("ve.test.text_message", text_message { "First message." }, connection.get());
+    valid.push_message("ve.test.text_message", text_message { "Second message." }, connection.get());
+
+
+    auto check_rejected = [&] (std::string_view name, std::vector<u8> data) {
+        received = 0;
+
+        ve::compound_message_v2 msg;
+        msg.data = std::move(data);
+
+        auto serialized = ve::serialize::to_bytes(msg);
+        auto view       = std::span<const u8> { serialized.begin(), serialized.end() };
+
+        ve::on_msg_compound_v2_view_received(client, *client.get_server_connection(), view);
+
+        if (received != 0) {
+            result |= VE_TEST_FAIL("Compound message with ", name, " was not rejected (", received, " messages received).");
+        }
+    };
+
+
+    // Last message is longer than the remaining data.
+    check_rejected("truncated message", std::vector<u8> { valid.data.begin(), valid.data.end() - 1 });
+
+    // Data ends in the middle of the header of a run.
+    auto partial_header = valid.data;
+    partial_header.push_back(0);
+    check_rejected("partial run header", std::move(partial_header));
+
+    // Length does not fit in a u64.
+    check_rejected("overlong length", std::vector<u8>(11, 0xFF));
+
+
+    // Outer length of the serialized message is longer than the message itself.
+    received = 0;
+
+    auto serialized = ve::serialize::to_bytes(valid);
+    auto view       = std::span<const u8> { serialized.begin(), serialized.end() };
+    ve::on_msg_compound_v2_view_received(client, *client.get_server_connection(), view.subspan(1));
+
+    if (received != 0) {
+        result |= VE_TEST_FAIL("Compound message with truncated data was not rejected (", received, " messages received).");
+    }
+
+
+    return result;
+}
+
+
+// Sends many update messages in a single compound message, checks that they are all received and returns the size of the compound message.
+template <typename Message> test_result test_update_messages(std::string_view msg_name, std::size_t& bytes) {
+    constexpr std::size_t num_messages = 5000;
+
+    ve::client client;
+    ve::server server;
+    ve::connect_local(client, server);
+
+
+    std::size_t received = 0;
+
+    client.get_server_connection()->add_handler(
+        "ve.test.update_message",
+        [&] (const update_message& msg) { ++received; }
+    );
+
+
+    auto connection = server.get_connections().front();
+    Message msg;
+
+    for (u32 i = 0; i < num_messages; ++i) {
+        msg.push_message("ve.test.update_message", update_message { std::vector<u8>(40, u8(i)), 0xDEADBEEF, i }, connection.get());
+    }
+
+    connection->send_message(msg_name, msg);
+    bytes = msg.data.size();
+
+
+    if (received != num_messages) {
+        return VE_TEST_FAIL("Not all messages in compound message were received (", received, " / ", num_messages, ").");
+    }
+
+    return VE_TEST_SUCCESS;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+    result |= test_ordering();
+    result |= test_malformed();
+
+
+    std::size_t v1_bytes = 0, v2_bytes = 0;
+    result |= test_update_messages<ve::compound_message>(ve::core_message_types::MSG_COMPOUND, v1_bytes);
+    result |= test_update_messages<ve::compound_message_v2>(ve::core_message_types::MSG_COMPOUND_V2, v2_bytes);
+
+    if (v2_bytes >= v1_bytes) {
+        result |= VE_TEST_FAIL("Compact compound message framing was not smaller than the original framing.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#define VE_TEST_HEADLESS
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/voxel/space/voxel_space.hpp>
+#include <VoxelEngine/voxel/chunk/generator/generator.hpp>
+#include <VoxelEngine/voxel/chunk/loader/loader.hpp>
+#include <VoxelEngine/voxel/tile/tiles.hpp>
+
+#include <SDL.h>
+
+using namespace ve::defs;
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+
+    if (!ve::engine::is_headless()) {
+        return VE_TEST_FAIL("Engine was not started in headless mode.");
+    }
+
+    if (SDL_WasInit(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
+        result |= VE_TEST_FAIL("SDL video or events were initialized in headless mode.");
+    }
+
+
+    // Voxel spaces without meshing should be usable without a graphics context.
+    ve::voxel::world_layers layers;
+    layers.set_sky(ve::voxel::tiles::TILE_AIR);
+    layers.add_layer(0, ve::voxel::tiles::TILE_UNKNOWN);
+
+    auto space = ve::voxel::voxel_space::create(ve::make_shared<ve::voxel::flatland_generator>(std::move(layers)), false);
+    space->add_chunk_loader(ve::make_shared<ve::voxel::point_loader<>>(ve::voxel::tilepos { 0 }, ve::voxel::tilepos { 1 }));
+    space->update(1ns);
+
+
+    // The loader loads a 3x3x3 cube of chunks around the origin.
+    if (!space->is_loaded(ve::voxel::tilepos { 0 }) || space->get_chunks().size() != 27) {
+        result |= VE_TEST_FAIL("Voxel space loaded ", space->get_chunks().size(), " chunks but expected 27.");
+    }
+
+    if (space->get_vertex_buffer() != nullptr) {
+        result |= VE_TEST_FAIL("Voxel space created a vertex buffer while meshing was disabled.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
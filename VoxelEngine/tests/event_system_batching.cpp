@@ -0,0 +1,103 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/event/event_system.hpp>
+
+using namespace ve::defs;
+
+
+// Handlers of both kinds are invoked in order of priority, and batch handlers receive all events dispatched together.
+template <typename Dispatcher> test_result test_ordering(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    Dispatcher d;
+    std::string log;
+    std::vector<std::size_t> batch_sizes;
+
+    auto low   = d.template add_handler<int>([&] (const int& i) { log += ve::cat("L", i); }, 0);
+    auto batch = d.template add_batch_handler<int>([&] (std::span<const int> events) {
+        batch_sizes.push_back(events.size());
+        for (int i : events) log += ve::cat("B", i);
+    }, 1);
+    auto high  = d.template add_handler<int>([&] (const int& i) { log += ve::cat("H", i); }, 2);
+    auto once  = d.template add_one_time_handler<int>([&] (const int& i) { log += ve::cat("O", i); }, 3);
+
+
+    const std::array events { 1, 2, 3 };
+
+    if constexpr (requires { typename Dispatcher::simple_event_dispatcher_tag; }) {
+        d.template dispatch_events<int>(events);
+    } else {
+        for (int i : events) d.add_event(i);
+        d.dispatch_events();
+    }
+
+
+    if (log != "O1H1H2H3B1B2B3L1L2L3") {
+        result |= VE_TEST_FAIL("Incorrect handler invocation order for ", ctti::nameof<Dispatcher>(), ": ", log, ".");
+    }
+
+    if (batch_sizes != std::vector<std::size_t> { 3 }) {
+        result |= VE_TEST_FAIL("Batch handler for ", ctti::nameof<Dispatcher>(), " did not receive all events as a single batch.");
+    }
+
+    return result;
+}
+
+
+// Handlers removed or added while a batch is dispatched stop or start receiving events from the next event onwards,
+// as if the events were dispatched one at a time.
+// If direct is true, events are passed to a delayed dispatcher directly, rather than being added to it first.
+template <typename Dispatcher, bool Direct = false> test_result test_changes_during_batch(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    Dispatcher d;
+    std::string log;
+
+    ve::event_handler_id_t removed_id;
+    removed_id = d.template add_raw_handler<int>([&] (const int& i) {
+        log += ve::cat("R", i);
+        d.template remove_handler<int>(removed_id);
+    }, 2);
+
+    d.template add_raw_handler<int>([&, added = false] (const int& i) mutable {
+        log += ve::cat("A", i);
+
+        if (!std::exchange(added, true)) {
+            d.template add_raw_handler<int>([&] (const int& j) { log += ve::cat("N", j); }, 0);
+        }
+    }, 1);
+
+
+    const std::array events { 1, 2, 3 };
+
+    if constexpr (Direct || requires { typename Dispatcher::simple_event_dispatcher_tag; }) {
+        d.template dispatch_events<int>(events);
+    } else {
+        for (int i : events) d.add_event(i);
+        d.dispatch_events();
+    }
+
+
+    if (log != "R1A1A2N2A3N3") {
+        result |= VE_TEST_FAIL("Handlers changed during a batch for ", ctti::nameof<Dispatcher>(), " received incorrect events: ", log, ".");
+    }
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_ordering<ve::simple_event_dispatcher<false, false, u16>>();
+    result |= test_ordering<ve::simple_event_dispatcher<true,  false, u16>>();
+    result |= test_ordering<ve::delayed_event_dispatcher<false, false, u16>>();
+    result |= test_ordering<ve::delayed_event_dispatcher<true,  false, u16>>();
+
+    result |= test_changes_during_batch<ve::simple_event_dispatcher<false, false, u16>>();
+    result |= test_changes_during_batch<ve::simple_event_dispatcher<true,  false, u16>>();
+    result |= test_changes_during_batch<ve::delayed_event_dispatcher<false, false, u16>>();
+    result |= test_changes_during_batch<ve::delayed_event_dispatcher<true,  false, u16>>();
+    result |= test_changes_during_batch<ve::delayed_event_dispatcher<true,  false, u16>, true>();
+
+    return result;
+}
\ No newline at end of file
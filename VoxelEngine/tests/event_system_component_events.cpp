@@ -0,0 +1,51 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/ecs/ecs.hpp>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_entities = 10'000;
+
+
+struct test_component {
+    u64 value;
+};
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    ve::registry registry;
+    std::vector<entt::entity> entities;
+
+    entities.reserve(num_entities);
+    for (std::size_t i = 0; i < num_entities; ++i) entities.push_back(registry.create_entity());
+
+
+    // Components set without any handlers should not be observed by handlers added later.
+    for (auto entity : entities) registry.set_component(entity, test_component { u64(entity) });
+    for (auto entity : entities) registry.remove_component<test_component>(entity);
+
+
+    std::size_t num_received = 0;
+    u64 checksum = 0;
+
+    auto handler = registry.add_handler([&] (const ve::component_created_event<test_component>& e) {
+        ++num_received;
+        checksum += e.component->value;
+    });
+
+    for (auto entity : entities) registry.set_component(entity, test_component { u64(entity) });
+    for (auto entity : entities) registry.remove_component<test_component>(entity);
+
+
+    u64 expected_checksum = 0;
+    for (auto entity : entities) expected_checksum += u64(entity);
+
+    if (num_received != num_entities || checksum != expected_checksum) {
+        result |= VE_TEST_FAIL("Handler received ", num_received, " out of ", num_entities, " component_created_events, or received incorrect events.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
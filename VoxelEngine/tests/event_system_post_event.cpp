@@ -0,0 +1,63 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/event/delayed_event_dispatcher.hpp>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_producers          = 8;
+constexpr std::size_t num_events_per_thread  = 25'000;
+
+
+struct sequenced_event {
+    u32 producer;
+    u32 sequence;
+};
+
+
+// Producers add events from their own threads while the main thread keeps dispatching them, similar to socket I/O threads.
+// Checks that every event is dispatched and that events from the same producer are dispatched in order.
+template <bool Post> test_result test_producers(void) {
+    ve::delayed_event_dispatcher<true> dispatcher;
+
+    std::vector<u32> last_sequence(num_producers, 0);
+    std::size_t received = 0;
+    bool in_order = true;
+
+    auto handler = dispatcher.add_handler<sequenced_event>([&] (const sequenced_event& e) {
+        in_order &= (e.sequence == last_sequence[e.producer] + 1);
+        last_sequence[e.producer] = e.sequence;
+
+        ++received;
+    });
+
+
+    std::vector<std::thread> producers;
+    for (u32 i = 0; i < num_producers; ++i) {
+        producers.emplace_back([&, i] {
+            for (u32 j = 1; j <= num_events_per_thread; ++j) {
+                if constexpr (Post) dispatcher.post_event(sequenced_event { i, j });
+                else dispatcher.add_event(sequenced_event { i, j });
+            }
+        });
+    }
+
+    while (received < num_producers * num_events_per_thread) dispatcher.dispatch_events();
+    for (auto& producer : producers) producer.join();
+
+
+    test_result result = VE_TEST_SUCCESS;
+    if (!in_order) result |= VE_TEST_FAIL("Events from the same producer were dispatched out of order.");
+    if (dispatcher.has_pending_events()) result |= VE_TEST_FAIL("Dispatcher has pending events after all events were dispatched.");
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_producers<false>();
+    result |= test_producers<true>();
+
+    return result;
+}
\ No newline at end of file
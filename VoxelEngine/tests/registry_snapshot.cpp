@@ -0,0 +1,72 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/ecs/ecs.hpp>
+
+using namespace ve::defs;
+
+
+// Not trivially copyable, so it is stored element-by-element rather than as raw bytes.
+struct named_value_component {
+    std::string name;
+    i32 value;
+};
+
+
+// Empty types have no component storage, so only the entities that have them are stored.
+struct tag_component {};
+
+
+test_result test_main(void) {
+    constexpr std::size_t num_entities = 10'000;
+
+    ve::registry source;
+    std::vector<entt::entity> entities;
+
+
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        auto entity = source.create_entity();
+        source.set_component(entity, ve::transform_component { .position = vec3f { (f32) i, 0, 0 } });
+
+        if (i % 3 == 0) source.set_component(entity, named_value_component { ve::cat("entity ", i), (i32) i });
+        if (i % 5 == 0) source.set_component(entity, tag_component { });
+        entities.push_back(entity);
+    }
+
+    // Destroy some entities so the snapshot contains gaps in the entity IDs.
+    for (std::size_t i = 0; i < num_entities; i += 7) source.destroy_entity(entities[i]);
+
+
+    auto bytes = ve::serialize::to_bytes(source.take_snapshot());
+
+    ve::registry target;
+    target.restore_snapshot(ve::serialize::from_bytes<ve::registry_snapshot>(bytes));
+
+
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        auto entity = entities[i];
+
+        if (source.get_storage().valid(entity) != target.get_storage().valid(entity)) {
+            return VE_TEST_FAIL("Entity ", entity, " does not have the same validity after restoring snapshot.");
+        }
+
+        if (!source.get_storage().valid(entity)) continue;
+
+
+        if (target.get_component<ve::transform_component>(entity).position != source.get_component<ve::transform_component>(entity).position) {
+            return VE_TEST_FAIL("Trivially copyable component of entity ", entity, " was not restored correctly.");
+        }
+
+        const auto* expected = source.try_get_component<named_value_component>(entity);
+        const auto* actual   = target.try_get_component<named_value_component>(entity);
+
+        if (bool(expected) != bool(actual) || (expected && (expected->name != actual->name || expected->value != actual->value))) {
+            return VE_TEST_FAIL("Serialized component of entity ", entity, " was not restored correctly.");
+        }
+
+        if (source.has_component<tag_component>(entity) != target.has_component<tag_component>(entity)) {
+            return VE_TEST_FAIL("Tag component of entity ", entity, " was not restored correctly.");
+        }
+    }
+
+
+    return VE_TEST_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/socket/socket_client.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+
+using namespace ve::defs;
+
+
+constexpr u16 port = 12002;
+constexpr std::size_t num_ticks = 20;
+constexpr std::size_t messages_per_tick = 200;
+
+
+// Sends many small messages per tick from the client to the server, and checks that they are received in order.
+// If manual flushing is enabled, messages should only be sent once the client is updated.
+test_result test_batching(bool manual_flush, std::string_view name) {
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+
+    auto session = client->get_session();
+    session->set_manual_flush(manual_flush);
+
+    std::size_t received = 0;
+    test_result result = VE_TEST_SUCCESS;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.size() != 64 || e.message[0] != u8(received % 256)) {
+            result |= VE_TEST_FAIL("Message ", received, " was received out of order or contained incorrect data (", name, ").");
+        }
+
+        ++received;
+    });
+
+
+    auto write_tick = [&] (std::size_t tick) {
+        for (std::size_t i = 0; i < messages_per_tick; ++i) {
+            std::vector<u8> message(64, 0x00);
+            message[0] = u8((tick * messages_per_tick + i) % 256);
+
+            session->write(std::move(message));
+        }
+    };
+
+
+    // Messages of a manually flushed session are held back until the session is flushed by the client's update.
+    if (manual_flush) {
+        const u64 writes_before = session->get_num_writes();
+        write_tick(0);
+
+        auto start = steady_clock::now();
+        while (ve::time_since(start) < milliseconds(50)) server->update();
+
+        if (received > 0 || session->get_num_writes() != writes_before) {
+            result |= VE_TEST_FAIL("Manually flushed session sent messages before it was flushed.");
+        }
+
+        client->update();
+        server->update();
+    }
+
+
+    auto start = steady_clock::now();
+
+    for (std::size_t tick = (manual_flush ? 1 : 0); tick < num_ticks; ++tick) {
+        write_tick(tick);
+
+        client->update();
+        server->update();
+    }
+
+
+    constexpr std::size_t total_messages = num_ticks * messages_per_tick;
+
+    while (received < total_messages && ve::time_since(start) < seconds(30)) {
+        client->update();
+        server->update();
+    }
+
+    if (received != total_messages) {
+        return VE_TEST_FAIL("Not all messages were received (", name, ", ", received, " / ", total_messages, ").");
+    }
+
+
+    client->stop();
+    server->stop();
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_batching(false, "flush on write");
+    result |= test_batching(true, "flush at end of tick");
+
+    return result;
+}
\ No newline at end of file
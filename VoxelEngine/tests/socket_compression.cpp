@@ -0,0 +1,113 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/socket/socket_client.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+using namespace ve::defs;
+
+
+constexpr u16 port = 12001;
+constexpr std::size_t num_round_trips = 100;
+constexpr std::size_t num_bulk_messages = 100;
+
+
+// Creates a message that compresses about as well as a typical serialized component update.
+std::vector<u8> make_message(std::size_t size) {
+    std::vector<u8> result(size, 0x00);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result[i] = (i % 16 < 12) ? u8(i % 7) : (u8) ve::cheaprand::random_int(0, 255);
+    }
+
+    return result;
+}
+
+
+// Echoes small messages and sends large messages, with the given compression threshold on both sides,
+// and checks that every message is received intact.
+test_result test_transfer(std::size_t threshold, std::string_view name) {
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    auto wait_for = [&] (auto condition) {
+        auto start = steady_clock::now();
+
+        while (!condition() && ve::time_since(start) < seconds(30)) {
+            server->update();
+            client->update();
+        }
+
+        return condition();
+    };
+
+    if (!wait_for([&] { return !server->get_sessions().empty(); })) {
+        return VE_TEST_FAIL("Client failed to connect to server.");
+    }
+
+    auto server_session = server->get_sessions().begin()->second;
+    auto client_session = client->get_session();
+
+    server_session->set_compression_threshold(threshold);
+    client_session->set_compression_threshold(threshold);
+
+
+    // Small messages are echoed back by the server.
+    const auto small_message = make_message(32);
+    std::size_t round_trips  = 0;
+    test_result result       = VE_TEST_SUCCESS;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.size() == small_message.size()) server_session->write(e.message.get());
+    });
+
+    client->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message != small_message) result |= VE_TEST_FAIL("Echoed message contained incorrect data (", name, ").");
+        if (++round_trips < num_round_trips) client_session->write(small_message);
+    });
+
+
+    client_session->write(small_message);
+
+    if (!wait_for([&] { return round_trips == num_round_trips; })) {
+        return VE_TEST_FAIL("Not all round trips completed (", name, ", ", round_trips, " / ", num_round_trips, ").");
+    }
+
+
+    // Large messages are sent from the client to the server.
+    const auto large_message = make_message(16 * 1024);
+    std::size_t received     = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.size() != large_message.size()) return;
+
+        if (e.message != large_message) result |= VE_TEST_FAIL("Bulk message contained incorrect data (", name, ").");
+        ++received;
+    });
+
+
+    for (std::size_t i = 0; i < num_bulk_messages; ++i) client_session->write(large_message);
+
+    if (!wait_for([&] { return received == num_bulk_messages; })) {
+        return VE_TEST_FAIL("Not all bulk messages were received (", name, ", ", received, " / ", num_bulk_messages, ").");
+    }
+
+
+    client->stop();
+    server->stop();
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_transfer(ve::max_value<std::size_t>, "uncompressed");
+    result |= test_transfer(ve::connection::default_compression_threshold, "adaptive");
+    result |= test_transfer(0, "always compressed");
+
+    return result;
+}
\ No newline at end of file
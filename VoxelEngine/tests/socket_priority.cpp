@@ -0,0 +1,101 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/socket/socket_client.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+#include <VoxelEngine/utility/random.hpp>
+
+using namespace ve::defs;
+
+
+constexpr u16 port = 12006;
+constexpr std::size_t num_inputs = 50;
+constexpr std::size_t bulk_message_size = 128 * 1024;
+constexpr std::size_t max_bulk_in_flight = 16;
+
+
+// Sends small input messages from the client to the server while a bulk transfer is running on the same connection,
+// and checks that all messages arrive intact, with messages of the same priority arriving in order.
+test_result test_priority(ve::message_priority input_priority, ve::message_priority bulk_priority, std::string_view name) {
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    auto session = client->get_session();
+    // Random data does not compress well, so don't waste time trying.
+    session->set_compression_threshold(ve::max_value<std::size_t>);
+
+
+    std::size_t inputs_sent = 0, inputs_received = 0;
+    std::size_t bulk_sent = 0, bulk_received = 0;
+    test_result result = VE_TEST_SUCCESS;
+
+    std::vector<u8> bulk_message(bulk_message_size);
+    for (auto& byte : bulk_message) byte = (u8) ve::cheaprand::random_int(0, 255);
+
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.size() == bulk_message_size) {
+            if (e.message != bulk_message) result |= VE_TEST_FAIL("Bulk message contained incorrect data (", name, ").");
+            ++bulk_received;
+
+            return;
+        }
+
+
+        u32 index;
+        std::memcpy(&index, e.message.span().data(), sizeof(index));
+
+        // Messages of the same priority must arrive in order.
+        if (index != inputs_received) {
+            result |= VE_TEST_FAIL("Input message ", index, " arrived out of order (", name, ").");
+            return;
+        }
+
+        ++inputs_received;
+    });
+
+
+    auto start = steady_clock::now();
+
+    while (inputs_received < num_inputs && ve::time_since(start) < seconds(60)) {
+        // Keep the connection saturated with bulk data.
+        while (bulk_sent - bulk_received < max_bulk_in_flight) {
+            session->write(bulk_message, bulk_priority);
+            ++bulk_sent;
+        }
+
+        // Send a new input once the previous one has arrived, like a client sending input every tick.
+        if (inputs_sent == inputs_received && inputs_sent < num_inputs) {
+            std::vector<u8> input(16, 0x00);
+            u32 index = (u32) inputs_sent++;
+            std::memcpy(input.data(), &index, sizeof(index));
+
+            session->write(std::move(input), input_priority);
+        }
+
+        client->update();
+        server->update();
+    }
+
+
+    if (inputs_received != num_inputs) {
+        return VE_TEST_FAIL("Not all input messages were received (", name, ", ", inputs_received, " / ", num_inputs, ").");
+    }
+
+
+    client->stop();
+    server->stop();
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_priority(ve::message_priority::NORMAL, ve::message_priority::NORMAL, "single stream");
+    result |= test_priority(ve::message_priority::HIGH, ve::message_priority::BULK, "prioritized");
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/socket/socket_client.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+
+using namespace ve::defs;
+
+
+constexpr u16 port = 12003;
+constexpr std::size_t num_warmup_messages = 1000;
+constexpr std::size_t num_messages = 2000;
+
+
+// Sends many messages of varying sizes from the client to the server, and checks that they are received intact and in order,
+// both while the buffer pool is warming up and after it has been warmed up.
+// (See the socket benchmarks for the number of buffer allocations per received message.)
+test_result test_main(void) {
+    auto server = ve::connection::socket_server::create(1);
+    server->start(port);
+
+    auto client = ve::connection::socket_client::create();
+    client->start("127.0.0.1", port);
+
+    auto session = client->get_session();
+    // Don't compress the messages, so the buffers used for receiving have the same sizes as the messages.
+    session->set_compression_threshold(ve::max_value<std::size_t>);
+
+
+    std::size_t received = 0;
+    test_result result = VE_TEST_SUCCESS;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        if (e.message.empty() || e.message[0] != u8(received % 256)) {
+            result |= VE_TEST_FAIL("Message ", received, " was received out of order or contained incorrect data.");
+        }
+
+        ++received;
+    });
+
+
+    auto send_and_wait = [&] (std::size_t count) {
+        const std::size_t target = received + count;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            std::vector<u8> message(32 + (i % 64) * 16, 0x00);
+            message[0] = u8((received + i) % 256);
+
+            session->write(std::move(message));
+        }
+
+
+        auto start = steady_clock::now();
+
+        while (received < target && ve::time_since(start) < seconds(30)) {
+            client->update();
+            server->update();
+        }
+
+        return received == target;
+    };
+
+
+    if (!send_and_wait(num_warmup_messages)) {
+        return VE_TEST_FAIL("Not all warmup messages were received (", received, " / ", num_warmup_messages, ").");
+    }
+
+
+    if (!send_and_wait(num_messages)) {
+        return VE_TEST_FAIL("Not all messages were received.");
+    }
+
+
+    client->stop();
+    server->stop();
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/socket/socket_server.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+
+using namespace ve::defs;
+namespace asio = ve::connection::asio;
+
+
+constexpr u16 port = 12008;
+constexpr std::size_t num_sessions = 100;
+constexpr std::size_t num_ticks = 20;
+constexpr std::size_t messages_per_tick = 4;
+
+
+// Constructs a single-frame message in the wire format of socket_session, so remotes can be simulated with plain sockets.
+std::vector<u8> make_frame(u64 value) {
+    auto message = ve::serialize::to_bytes(value);
+    message.push_back((u8) ve::connection::message_codec::RAW);
+
+    std::vector<u8> frame;
+    ve::serialize::encode_variable_length((u64(message.size()) << 3) | 1, frame);
+    std::reverse(frame.begin(), frame.end());
+
+    frame.insert(frame.end(), message.begin(), message.end());
+    return frame;
+}
+
+
+// Sends messages from many sessions at once, and checks that every message is received with the payload produced by the receive hook.
+test_result test_main(void) {
+    auto server = ve::connection::socket_server::create(4);
+
+    // Messages are deserialized on the I/O threads, so the main thread only has to take the payload.
+    server->set_receive_hook([] (ve::connection::message_received_event& e) {
+        auto span = e.message.span();
+        e.payload = ve::serialize::from_bytes<u64>(span);
+    });
+
+    server->start(port);
+
+
+    asio::io_context ctx;
+    std::vector<asio::ip::tcp::socket> sockets;
+    sockets.reserve(num_sessions);
+
+    const auto endpoint = asio::ip::tcp::endpoint { asio::ip::make_address("127.0.0.1"), port };
+
+    for (std::size_t i = 0; i < num_sessions; ++i) {
+        sockets.emplace_back(ctx).connect(endpoint);
+    }
+
+
+    auto wait_for = [&] (auto condition) {
+        auto start = steady_clock::now();
+        while (!condition() && ve::time_since(start) < seconds(30)) server->update();
+
+        return condition();
+    };
+
+    if (!wait_for([&] { return server->get_sessions().size() == num_sessions; })) {
+        return VE_TEST_FAIL("Only ", server->get_sessions().size(), " of ", num_sessions, " sessions connected.");
+    }
+
+
+    test_result result   = VE_TEST_SUCCESS;
+    std::size_t received = 0;
+    u64 checksum         = 0;
+
+    server->add_raw_handler([&] (const ve::connection::message_received_event& e) {
+        ++received;
+
+        if (!e.payload.has_value()) {
+            result |= VE_TEST_FAIL("Receive hook was not invoked for message.");
+            return;
+        }
+
+        checksum += std::any_cast<u64>(e.payload);
+    });
+
+
+    u64 expected_checksum = 0;
+
+    for (std::size_t tick = 0; tick < num_ticks; ++tick) {
+        for (auto& socket : sockets) {
+            for (std::size_t i = 0; i < messages_per_tick; ++i) {
+                const u64 value = tick * messages_per_tick + i;
+
+                asio::write(socket, asio::buffer(make_frame(value)));
+                expected_checksum += value;
+            }
+        }
+
+        server->update();
+    }
+
+
+    const std::size_t expected = num_sessions * num_ticks * messages_per_tick;
+
+    if (!wait_for([&] { return received == expected; })) {
+        return VE_TEST_FAIL("Not all messages were received (", received, " / ", expected, ").");
+    }
+
+    if (checksum != expected_checksum) {
+        result |= VE_TEST_FAIL("Received messages contained incorrect data.");
+    }
+
+
+    for (auto& socket : sockets) socket.close();
+    server->stop();
+
+    return result;
+}
\ No newline at end of file
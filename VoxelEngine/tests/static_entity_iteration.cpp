@@ -0,0 +1,90 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/ecs/ecs.hpp>
+
+using namespace ve::defs;
+
+
+// Entity with the same layout as the Howlees from the demo game.
+struct test_howlee : public ve::static_entity {
+    struct test_howlee_tag {
+        enum { NORMAL, BUILDER, EMISSIVE } type;
+    };
+
+
+    explicit test_howlee(ve::registry& registry, f32 speed) : ve::static_entity(registry), speed(speed) {}
+    ve_rt_move_only(test_howlee);
+
+
+    ve::transform_component VE_COMPONENT(transform) = ve::transform_component { };
+    ve::motion_component VE_COMPONENT(motion) = ve::motion_component { };
+    test_howlee_tag VE_COMPONENT(tag) = test_howlee_tag { .type = test_howlee_tag::NORMAL };
+
+    f32 speed;
+    f32 distance_walked = 0.0f;
+    void* world = nullptr;
+};
+
+
+test_result test_main(void) {
+    constexpr std::size_t num_entities = 10'000;
+    constexpr std::size_t num_repeats  = 20;
+    constexpr f32 dt = 0.01f;
+
+    test_result result = VE_TEST_SUCCESS;
+
+
+    // Static entities are stored in per-type pools within the registry.
+    ve::registry pooled_registry;
+    std::vector<entt::entity> ids;
+
+    for (std::size_t i = 0; i < num_entities; ++i) {
+        auto& e = pooled_registry.store_static_entity(test_howlee { pooled_registry, f32(i % 10) });
+        ids.push_back(e.get_id());
+    }
+
+
+    for (std::size_t i = 0; i < num_repeats; ++i) {
+        pooled_registry.for_each_static_entity<test_howlee>([&] (test_howlee& e) { e.distance_walked += e.speed * dt; });
+    }
+
+
+    // Every entity should have been visited exactly once per iteration.
+    for (auto id : ids) {
+        const auto* e = pooled_registry.try_get_static_entity<test_howlee>(id);
+
+        if (!e) {
+            result |= VE_TEST_FAIL("Static entity ", id, " could not be found in the registry.");
+            break;
+        }
+
+        if (std::abs(e->distance_walked - e->speed * dt * num_repeats) > 0.001f) {
+            result |= VE_TEST_FAIL("Static entity ", id, " was not visited the correct number of times.");
+            break;
+        }
+    }
+
+
+    // Destroyed entities should no longer be reachable, and new entities should be able to reuse their storage.
+    for (std::size_t i = 0; i < num_entities; i += 2) pooled_registry.destroy_entity(ids[i]);
+
+    if (pooled_registry.try_get_static_entity<test_howlee>(ids[0])) {
+        result |= VE_TEST_FAIL("Destroyed static entity could still be found in the registry.");
+    }
+
+    auto& reused = pooled_registry.store_static_entity(test_howlee { pooled_registry, 1.0f });
+
+    if (&reused != pooled_registry.try_get_static_entity<test_howlee>(reused.get_id()) || reused.transform.position != vec3f { 0 }) {
+        result |= VE_TEST_FAIL("Static entity stored in reused slot was not stored correctly.");
+    }
+
+
+    std::size_t count = 0;
+    pooled_registry.for_each_static_entity<test_howlee>([&] (test_howlee& e) { ++count; });
+
+    if (count != (num_entities / 2) + 1) {
+        result |= VE_TEST_FAIL("Expected ", (num_entities / 2) + 1, " static entities after destruction, got ", count, ".");
+    }
+
+
+    return result;
+}
\ No newline at end of file
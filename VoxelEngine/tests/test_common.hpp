@@ -48,11 +48,18 @@ extern test_result test_main(void);
 
 
 namespace ve::game_callbacks {
-    void pre_init(void)  { }
     void post_init(void) { }
     void post_loop(void) { }
     void pre_exit(void)  { }
     void post_exit(void) { }
+
+
+    // Tests that define VE_TEST_HEADLESS before including this file run without SDL video and input, so they don't require a display or GPU.
+    void pre_init(void) {
+        #ifdef VE_TEST_HEADLESS
+            engine::set_headless(true);
+        #endif
+    }
     
     
     void pre_loop(void) {
@@ -0,0 +1,101 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/core/trace_profiler.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_threads       = 4;
+constexpr std::size_t num_events        = 10'000;
+constexpr std::size_t events_per_thread = 256;
+
+
+std::size_t count_occurrences(std::string_view text, std::string_view pattern) {
+    std::size_t count = 0;
+
+    for (auto pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+
+    return count;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+    auto& profiler = ve::trace_profiler::instance();
+
+
+    // Events are not recorded while the profiler is inactive.
+    { ve::trace_scope scope { "Unrecorded Event" }; }
+
+
+    profiler.set_events_per_thread(events_per_thread);
+    profiler.start();
+
+    const auto start = steady_clock::now();
+    std::atomic_bool done = false;
+
+
+    // Threads record more events than fit in their buffers, while the main thread repeatedly writes the trace.
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&] {
+            profiler.set_thread_name("Test Thread");
+            for (std::size_t j = 0; j < num_events; ++j) ve::trace_scope scope { "Test \"Event\"" };
+        });
+    }
+
+    std::thread writer { [&] {
+        while (!done) {
+            std::stringstream stream;
+            profiler.write(stream, start, steady_clock::now());
+        }
+    } };
+
+    for (auto& thread : threads) thread.join();
+    done = true;
+    writer.join();
+
+
+    std::stringstream stream;
+    profiler.write(stream, start, steady_clock::now());
+    profiler.stop();
+
+    const auto trace = stream.str();
+
+
+    if (count_occurrences(trace, "Unrecorded Event") != 0) {
+        result |= VE_TEST_FAIL("Event was recorded while the profiler was inactive.");
+    }
+
+    if (auto n = count_occurrences(trace, R"("name":"Test \"Event\"")"); n != num_threads * events_per_thread) {
+        result |= VE_TEST_FAIL("Trace contains ", n, " events but expected the last ", events_per_thread, " events of each thread.");
+    }
+
+    if (auto n = count_occurrences(trace, R"("args":{"name":"Test Thread"})"); n != num_threads) {
+        result |= VE_TEST_FAIL("Trace contains ", n, " thread names but expected ", num_threads, ".");
+    }
+
+    if (!trace.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[)") || !trace.ends_with("]}\n")) {
+        result |= VE_TEST_FAIL("Trace is not a valid Chrome Trace Event file.");
+    }
+
+
+    // The buffers of the exited threads are freed once the recording has ended, so they are not part of the next recording.
+    profiler.start();
+
+    std::stringstream next_stream;
+    profiler.write(next_stream, start, steady_clock::now());
+    profiler.stop();
+
+    if (auto n = count_occurrences(next_stream.str(), R"("args":{"name":"Test Thread"})"); n != 0) {
+        result |= VE_TEST_FAIL("Buffers of ", n, " exited threads were kept after the recording ended.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
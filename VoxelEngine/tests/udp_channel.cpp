@@ -0,0 +1,204 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/clientserver/client.hpp>
+#include <VoxelEngine/clientserver/server.hpp>
+#include <VoxelEngine/clientserver/connect.hpp>
+#include <VoxelEngine/clientserver/socket/udp_channel.hpp>
+#include <VoxelEngine/ecs/system/system_entity_visibility.hpp>
+#include <VoxelEngine/ecs/system/system_synchronizer.hpp>
+
+using namespace ve::defs;
+
+
+struct test_position {
+    i32 x, y;
+};
+
+
+std::vector<u8> make_message(std::size_t size, u32 index) {
+    std::vector<u8> result(size, 0x00);
+    for (std::size_t i = 0; i < size; ++i) result[i] = u8((i + index) % 251);
+
+    std::memcpy(result.data(), &index, sizeof(index));
+    return result;
+}
+
+
+// Sends messages of various sizes directly between two channels and checks that they arrive intact and in order.
+test_result test_channel(void) {
+    constexpr u16 port = 12004;
+    constexpr u32 num_messages = 500;
+
+    const auto server_id = ve::random_uuid(), client_id = ve::random_uuid();
+
+    const auto bind_secret = ve::connection::udp_channel::create_bind_secret();
+
+    auto server = ve::connection::udp_channel::create(server_id);
+    server->start(port);
+    server->expect_peer(client_id, bind_secret);
+
+    auto client = ve::connection::udp_channel::create(client_id);
+    client->start(server_id, "127.0.0.1", port, bind_secret);
+
+
+    auto wait_for = [&] (auto condition) {
+        auto start = steady_clock::now();
+
+        while (!condition() && ve::time_since(start) < seconds(10)) {
+            server->update();
+            client->update();
+        }
+
+        return condition();
+    };
+
+    if (!wait_for([&] { return server->is_bound(client_id) && client->is_bound(server_id); })) {
+        return VE_TEST_FAIL("Client failed to bind to server.");
+    }
+
+
+    test_result result = VE_TEST_SUCCESS;
+    std::size_t received = 0;
+    std::optional<u32> last_index;
+
+    server->add_raw_handler([&] (const ve::connection::datagram_received_event& e) {
+        if (e.sender != client_id || e.message.size() < sizeof(u32)) {
+            result |= VE_TEST_FAIL("Received datagram from incorrect sender or with incorrect size.");
+            return;
+        }
+
+        u32 index;
+        std::memcpy(&index, e.message.span().data(), sizeof(index));
+
+        if (last_index && index <= *last_index) result |= VE_TEST_FAIL("Message ", index, " was delivered after message ", *last_index, ".");
+        if (e.message != make_message(e.message.size(), index)) result |= VE_TEST_FAIL("Message ", index, " contained incorrect data.");
+
+        last_index = index;
+        ++received;
+    });
+
+
+    // Mix single-datagram and fragmented messages, without updating in between so many datagrams are in flight at once.
+    for (u32 i = 0; i < num_messages; ++i) {
+        std::size_t size = (i % 10 == 0) ? 10 * ve::connection::max_datagram_payload + 17 : 64;
+
+        if (!client->send(server_id, make_message(size, i))) {
+            return VE_TEST_FAIL("Failed to send message over bound channel.");
+        }
+    }
+
+    // Messages may be lost, but the last message in the stream is never superseded, so wait for it.
+    wait_for([&] { return last_index == num_messages - 1; });
+
+
+    if (received == 0) result |= VE_TEST_FAIL("No messages were received over loopback.");
+
+
+    client->stop();
+    server->stop();
+
+    return result;
+}
+
+
+// Checks that a host that knows a peer's instance ID but not its bind secret cannot bind in its place.
+test_result test_bind_secret(void) {
+    constexpr u16 port = 12006;
+
+    const auto server_id = ve::random_uuid(), client_id = ve::random_uuid();
+    const auto bind_secret = ve::connection::udp_channel::create_bind_secret();
+
+    auto server = ve::connection::udp_channel::create(server_id);
+    server->start(port);
+    server->expect_peer(client_id, bind_secret);
+
+    auto impostor = ve::connection::udp_channel::create(client_id);
+    impostor->start(server_id, "127.0.0.1", port, bind_secret + 1);
+
+
+    auto start = steady_clock::now();
+
+    while (ve::time_since(start) < 4 * ve::connection::bind_retry_interval) {
+        server->update();
+        impostor->update();
+    }
+
+
+    test_result result = VE_TEST_SUCCESS;
+
+    if (server->is_bound(client_id) || impostor->is_bound(server_id)) {
+        result |= VE_TEST_FAIL("Channel accepted a bind with an incorrect secret.");
+    }
+
+    impostor->stop();
+    server->stop();
+
+    return result;
+}
+
+
+// Synchronizes a component over the unreliable channel between a remote server and client.
+test_result test_synchronization(void) {
+    constexpr u16 port = 12005;
+
+    ve::server server;
+    ve::host_server(server, port);
+
+    ve::client client;
+    ve::connect_remote(client, "127.0.0.1", port);
+
+
+    auto [vis_id, visibility_system] = server.add_system(ve::system_entity_visibility { });
+    auto [sync_id, sync_system] = server.add_system(ve::system_synchronizer<ve::meta::pack<test_position>> { visibility_system });
+
+    sync_system.set_message_channel<test_position>(ve::message_channel::UNRELIABLE_LATEST);
+
+
+    entt::entity entity = server.create_entity();
+    server.set_component(entity, test_position { 0, 0 });
+
+    auto channel = client.template get_object<ve::shared<ve::connection::udp_channel>>("ve.connection.udp");
+    auto start   = steady_clock::now();
+    i32 tick     = 0;
+
+    while (ve::time_since(start) < seconds(10)) {
+        server.set_component(entity, test_position { tick, 2 * tick });
+        ++tick;
+
+        server.update(seconds(1) / 60);
+        client.update(seconds(1) / 60);
+
+        // Keep going for a while after binding, so that updates are actually sent over the channel.
+        if (channel->is_bound(server.get_id()) && tick > 120) break;
+    }
+
+
+    if (!channel->is_bound(server.get_id())) {
+        return VE_TEST_FAIL("UDP channel was not bound through the connection handshake.");
+    }
+
+
+    // Stop changing the value, so the client will catch up with the final value.
+    const auto expected = server.get_component<test_position>(entity);
+    start = steady_clock::now();
+
+    while (ve::time_since(start) < seconds(2)) {
+        server.update(seconds(1) / 60);
+        client.update(seconds(1) / 60);
+
+        const auto* value = client.try_get_component<test_position>(entity);
+        if (value && value->x == expected.x && value->y == expected.y) return VE_TEST_SUCCESS;
+    }
+
+    return VE_TEST_FAIL("Component synchronized over unreliable channel did not reach its final value.");
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_channel();
+    result |= test_bind_secret();
+    result |= test_synchronization();
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/utility/thread/thread_pool.hpp>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_tasks = 10'000;
+constexpr nanoseconds task_duration = 20us;
+constexpr nanoseconds tick_budget   = 2ms;
+
+
+// Each task busy-waits for at least task_duration, so no more than this many tasks can start before the deadline of a tick.
+// Note: this is an upper bound only, since the number of tasks that do fit within the budget depends on scheduling.
+constexpr std::size_t max_tasks_per_tick = std::size_t(tick_budget / task_duration) + 1;
+
+
+// Executes a synthetic burst of tasks (e.g. many meshes finishing at once) with a time budget,
+// and checks that tasks are executed in order of priority and carried over to the next tick if the budget is used up.
+test_result test_budgeted_burst(void) {
+    test_result result = VE_TEST_SUCCESS;
+    ve::main_thread_executor executor;
+
+
+    // Each task busy-waits to simulate an upload.
+    std::vector<ve::job_priority> execution_order;
+    execution_order.reserve(num_tasks);
+
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        const auto priority = ve::job_priority(i % ve::num_job_priorities);
+
+        executor.post([&, priority] {
+            auto start = steady_clock::now();
+            while (steady_clock::now() - start < task_duration) ;
+
+            execution_order.push_back(priority);
+        }, priority);
+    }
+
+
+    std::size_t num_ticks = 0;
+
+    while (executor.size() > 0) {
+        const std::size_t size_before = executor.size();
+
+        executor.execute(tick_budget);
+        auto stats = executor.get_statistics();
+
+        ++num_ticks;
+
+        if (stats.num_executed == 0) {
+            result |= VE_TEST_FAIL("Executor made no progress during tick ", num_ticks, ".");
+            break;
+        }
+
+        if (stats.num_executed > max_tasks_per_tick) {
+            result |= VE_TEST_FAIL("Tick ", num_ticks, " executed ", stats.num_executed, " tasks, but at most ", max_tasks_per_tick, " fit within the budget.");
+        }
+
+        // Tasks that were not executed remain queued for the next tick.
+        const std::size_t queued = std::accumulate(stats.queue_depth.begin(), stats.queue_depth.end(), std::size_t { 0 });
+
+        if (queued != size_before - stats.num_executed || executor.size() != queued) {
+            result |= VE_TEST_FAIL("Tick ", num_ticks, " left ", queued, " tasks queued, expected ", size_before - stats.num_executed, ".");
+        }
+    }
+
+
+    if (execution_order.size() != num_tasks) {
+        result |= VE_TEST_FAIL("Only ", execution_order.size(), " out of ", num_tasks, " tasks were executed.");
+    }
+
+    if (!std::ranges::is_sorted(execution_order)) {
+        result |= VE_TEST_FAIL("Tasks were not executed in order of priority.");
+    }
+
+    if (num_ticks < num_tasks / max_tasks_per_tick) {
+        result |= VE_TEST_FAIL("Burst was executed in ", num_ticks, " ticks, but needs at least ", num_tasks / max_tasks_per_tick, ".");
+    }
+
+
+    return result;
+}
+
+
+// With a budget of zero, exactly one task is executed per tick, and a higher priority task posted in between is executed first.
+test_result test_zero_budget(void) {
+    test_result result = VE_TEST_SUCCESS;
+    ve::main_thread_executor executor;
+
+    std::vector<i32> execution_order;
+
+    for (i32 i = 0; i < 3; ++i) {
+        executor.post([&, i] { execution_order.push_back(i); }, ve::job_priority(ve::num_job_priorities - 1));
+    }
+
+
+    executor.execute(0ns);
+
+    if (executor.get_statistics().num_executed != 1 || executor.size() != 2) {
+        result |= VE_TEST_FAIL("Executor with a budget of zero did not execute exactly one task.");
+    }
+
+
+    executor.post([&] { execution_order.push_back(-1); }, ve::job_priority(0));
+
+    executor.execute(0ns);
+    executor.execute(0ns);
+    executor.execute(0ns);
+
+    if (execution_order != std::vector<i32> { 0, -1, 1, 2 } || executor.size() != 0) {
+        result |= VE_TEST_FAIL("Carried over tasks were not executed in order of priority.");
+    }
+
+
+    return result;
+}
+
+
+// Without a budget, tasks queued by other tasks are executed during the same call.
+test_result test_unbounded_budget(void) {
+    ve::main_thread_executor executor;
+    bool executed_nested = false;
+
+    executor.post([&] { executor.post([&] { executed_nested = true; }); });
+    executor.execute();
+
+    if (!executed_nested || executor.get_statistics().num_executed != 2) {
+        return VE_TEST_FAIL("Task queued during execution was not executed in the same call.");
+    }
+
+    return VE_TEST_SUCCESS;
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+    result |= test_budgeted_burst();
+    result |= test_zero_budget();
+    result |= test_unbounded_budget();
+
+    return result;
+}
\ No newline at end of file
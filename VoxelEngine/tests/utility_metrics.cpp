@@ -0,0 +1,85 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace ve::defs;
+
+
+constexpr std::size_t num_threads = 8;
+constexpr std::size_t num_updates = 100'000;
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+    auto& registry = ve::metrics::registry::instance();
+
+
+    auto& counter   = registry.get_counter("test_events_total", "Number of test events.");
+    auto& gauge     = registry.get_gauge("test_queue_depth");
+    auto& histogram = registry.get_histogram("test_latency_seconds", "", std::vector<f64> { 0.1, 1.0 });
+
+    if (&registry.get_counter("test_events_total") != &counter) {
+        result |= VE_TEST_FAIL("Looking up an existing counter created a new counter.");
+    }
+
+
+    // Every thread accumulates into its own shard. Threads exit before the values are read, so their values must be kept after their shards are freed.
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t j = 0; j < num_updates; ++j) {
+                counter.add();
+                histogram.observe(f64(j % 4) * 0.5);
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+
+    if (counter.value() != num_threads * num_updates) {
+        result |= VE_TEST_FAIL("Counter has value ", counter.value(), " but expected ", num_threads * num_updates, ".");
+    }
+
+
+    // Observed values are 0.0, 0.5, 1.0 and 1.5, so the buckets are <= 0.1, <= 1.0 and +Inf.
+    const auto snapshot = histogram.value();
+    const auto quarter  = u64(num_threads * num_updates / 4);
+
+    if (snapshot.bucket_counts != std::vector<u64> { quarter, 2 * quarter, quarter }) {
+        result |= VE_TEST_FAIL("Histogram values were not stored in the correct buckets.");
+    }
+
+    if (snapshot.count != num_threads * num_updates || std::abs(snapshot.sum - f64(quarter) * 3.0) > 1e-6) {
+        result |= VE_TEST_FAIL("Histogram has incorrect count ", snapshot.count, " or sum ", snapshot.sum, ".");
+    }
+
+
+    gauge.set(5.0);
+    gauge.add(-2.0);
+
+    if (gauge.value() != 3.0) result |= VE_TEST_FAIL("Gauge has value ", gauge.value(), " but expected 3.");
+
+
+    std::stringstream stream;
+    registry.write(stream);
+    const auto text = stream.str();
+
+    const std::array expected_lines {
+        ve::cat("# HELP test_events_total Number of test events.\n# TYPE test_events_total counter\ntest_events_total ", num_threads * num_updates, "\n"),
+        std::string { "# TYPE test_queue_depth gauge\ntest_queue_depth 3\n" },
+        ve::cat("test_latency_seconds_bucket{le=\"1\"} ", 3 * quarter, "\n"),
+        ve::cat("test_latency_seconds_bucket{le=\"+Inf\"} ", 4 * quarter, "\n"),
+        ve::cat("test_latency_seconds_count ", 4 * quarter, "\n")
+    };
+
+    for (const auto& line : expected_lines) {
+        if (text.find(line) == std::string::npos) result |= VE_TEST_FAIL("Exported metrics did not contain expected output:\n", line, "\nGot:\n", text);
+    }
+
+
+    return result;
+}
\ No newline at end of file
@@ -130,6 +130,35 @@ test_result test_main(void) {
     A new_object = ve::serialize::from_bytes<A>(span);
     
     
-    if (object == new_object) return VE_TEST_SUCCESS;
-    else return VE_TEST_FAIL("Deserialized object does not compare equal to original object.");
+    test_result result = VE_TEST_SUCCESS;
+    if (object != new_object) result |= VE_TEST_FAIL("Deserialized object does not compare equal to original object.");
+    
+    
+    if (ve::serialize::serialized_size(object) != bytes.size()) {
+        result |= VE_TEST_FAIL("Calculated serialized size (", ve::serialize::serialized_size(object), ") does not match actual size (", bytes.size(), ").");
+    }
+    
+    
+    // Serialize into an external buffer.
+    std::vector<u8> buffer(bytes.size());
+    ve::serialize::span_sink sink { buffer };
+    ve::serialize::to_bytes(object, sink);
+    
+    if (!std::ranges::equal(sink.written(), bytes)) {
+        result |= VE_TEST_FAIL("Object serialized into span_sink does not match object serialized into vector.");
+    }
+    
+    
+    // Deserialize from non-contiguous buffers.
+    ve::serialize::segmented_source source;
+    for (std::size_t i = 0; i < bytes.size(); i += 5) {
+        source.add_segment(std::span<const u8> { bytes.begin() + i, bytes.begin() + std::min(i + 5, bytes.size()) });
+    }
+    
+    if (object != ve::serialize::from_bytes<A>(source)) {
+        result |= VE_TEST_FAIL("Object deserialized from segmented_source does not compare equal to original object.");
+    }
+    
+    
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/ecs/component/transform_component.hpp>
+#include <VoxelEngine/voxel/chunk/chunk.hpp>
+
+using namespace ve::defs;
+
+
+struct nested {
+    ve::transform_component transform;
+    u32 id = 0;
+    bool active = true;
+
+    ve_make_decomposable(nested, transform, id, active);
+};
+
+
+// Same layout as voxel_component::chunk_load_message.
+struct chunk_load_message {
+    ve::voxel::tilepos where;
+    typename ve::voxel::chunk::data_t data;
+};
+
+
+static_assert(ve::serialize::is_fixed_layout_v<ve::transform_component>);
+static_assert(ve::serialize::is_fixed_layout_v<nested>);
+static_assert(ve::serialize::is_fixed_layout_v<chunk_load_message>);
+static_assert(!ve::serialize::is_fixed_layout_v<std::vector<u32>>);
+static_assert(ve::serialize::fixed_layout_size_v<ve::transform_component> == 2 * sizeof(vec3f) + sizeof(quatf));
+
+
+// The fixed layout serializer must produce the same bytes as the decomposable serializer.
+test_result test_equivalence(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+
+    nested value;
+    value.transform.position = vec3f { 1, 2, 3 };
+    value.transform.rotation = glm::normalize(quatf { 0.3f, -0.5f, 0.1f, 0.8f });
+    value.id = 42;
+
+    std::vector<u8> expected;
+    ve::serialize::decomposable_to_bytes(value, expected);
+
+    auto bytes = ve::serialize::to_bytes(value);
+
+    if (bytes != expected) {
+        result |= VE_TEST_FAIL("Fixed layout serializer did not produce the same bytes as the decomposable serializer.");
+    }
+
+
+    auto span    = std::span<const u8> { bytes.begin(), bytes.end() };
+    auto decoded = ve::serialize::from_bytes<nested>(span);
+
+    if (
+        decoded.transform.position != value.transform.position ||
+        decoded.transform.rotation != value.transform.rotation ||
+        decoded.transform.scale    != value.transform.scale    ||
+        decoded.id                 != value.id                 ||
+        decoded.active             != value.active             ||
+        !span.empty()
+    ) {
+        result |= VE_TEST_FAIL("Fixed layout serializer did not reconstruct the original value.");
+    }
+
+
+    std::vector<ve::transform_component> transforms(10);
+    for (std::size_t i = 0; i < transforms.size(); ++i) transforms[i].position = vec3f { (f32) i };
+
+    auto vector_bytes   = ve::serialize::to_bytes(transforms);
+    auto vector_span    = std::span<const u8> { vector_bytes.begin(), vector_bytes.end() };
+    auto vector_decoded = ve::serialize::from_bytes<std::vector<ve::transform_component>>(vector_span);
+
+    if (
+        vector_decoded.size() != transforms.size() ||
+        !std::ranges::equal(vector_decoded, transforms, [] (const auto& a, const auto& b) { return a.position == b.position; })
+    ) {
+        result |= VE_TEST_FAIL("Container of fixed layout types was not reconstructed correctly.");
+    }
+
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    return test_equivalence();
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/utility/thread/task.hpp>
+
+using namespace ve::defs;
+
+
+ve::task<i32> double_on_worker(i32 value) {
+    co_await ve::resume_on_worker(ve::job_priority::MESH);
+    co_return value * 2;
+}
+
+
+ve::task<std::string> chained_task(i32 value) {
+    i32 a = co_await double_on_worker(value);
+    i32 b = co_await double_on_worker(a);
+
+    co_return ve::to_string(b);
+}
+
+
+ve::task<i32> throwing_task(void) {
+    co_await ve::resume_on_worker();
+    throw std::runtime_error { "Expected exception." };
+}
+
+
+ve::task<> cancelled_task(ve::cancellation_token token, bool& reached_end) {
+    co_await ve::resume_on_worker();
+
+    token.cancel();
+    co_await ve::yield_if_cancelled();
+
+    reached_end = true;
+}
+
+
+ve::task<i32> awaiting_job(void) {
+    i32 result = co_await ve::thread_pool::instance().submit([] { return 5; });
+    co_return result;
+}
+
+
+ve::task<bool> main_thread_task(void) {
+    // Already on the main thread, so this should not suspend.
+    co_await ve::resume_on_main();
+    co_return ve::thread_pool::instance().is_main_thread();
+}
+
+
+test_result test_main(void) {
+    test_result result = VE_TEST_SUCCESS;
+
+
+    if (auto value = ve::spawn(chained_task(5)).get(); value != "20") {
+        result |= VE_TEST_FAIL("Chained task produced incorrect result ", value, ".");
+    }
+
+
+    try {
+        ve::spawn(throwing_task()).get();
+        result |= VE_TEST_FAIL("Exception was not propagated from task.");
+    } catch (const std::runtime_error&) {}
+
+
+    ve::cancellation_token token;
+    bool reached_end = false;
+
+    try {
+        ve::spawn(cancelled_task(token, reached_end).with_cancellation(token)).get();
+        result |= VE_TEST_FAIL("Cancelled task did not throw task_cancelled.");
+    } catch (const ve::task_cancelled&) {}
+
+    if (reached_end) result |= VE_TEST_FAIL("Cancelled task continued after yield_if_cancelled.");
+
+
+    if (auto value = ve::spawn(awaiting_job()).get(); value != 5) {
+        result |= VE_TEST_FAIL("Awaiting job handle produced incorrect result ", value, ".");
+    }
+
+
+    if (!ve::spawn(main_thread_task()).get()) {
+        result |= VE_TEST_FAIL("Task on main thread was moved to a different thread.");
+    }
+
+
+    return result;
+}
\ No newline at end of file
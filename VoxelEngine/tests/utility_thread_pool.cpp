@@ -0,0 +1,68 @@
+#include <VoxelEngine/tests/test_common.hpp>
+#include <VoxelEngine/utility/thread/thread_pool.hpp>
+
+using namespace ve::defs;
+
+
+test_result test_functionality(void) {
+    auto& pool = ve::thread_pool::instance();
+    test_result result = VE_TEST_SUCCESS;
+
+
+    // Continuations receive the result of the previous job.
+    auto chained = pool.submit([] { return 21; })
+        .then([] (int x) { return x * 2; })
+        .then([] (int x) { return ve::to_string(x); });
+
+    if (chained.get() != "42") result |= VE_TEST_FAIL("Continuation chain produced incorrect result ", chained.get(), ".");
+
+
+    // Exceptions skip continuations and are rethrown from get.
+    auto throwing = pool.submit([] () -> int { throw std::runtime_error { "Expected exception." }; })
+        .then([] (int x) { return x; });
+
+    try {
+        throwing.get();
+        result |= VE_TEST_FAIL("Exception was not propagated to continuation.");
+    } catch (const std::runtime_error&) {}
+
+
+    // when_all completes after all jobs of all priorities.
+    std::vector<ve::job_handle<void>> jobs;
+    std::atomic<std::size_t> sum = 0;
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        jobs.push_back(pool.submit([&, i] { sum += i; }, ve::job_priority(i % ve::num_job_priorities)));
+    }
+
+    ve::when_all(jobs).wait();
+    if (sum != 999 * 1000 / 2) result |= VE_TEST_FAIL("when_all completed before all jobs had completed.");
+
+
+    // Jobs that wait for other jobs must not deadlock the pool, even if every worker is waiting.
+    std::vector<ve::job_handle<std::size_t>> outer;
+
+    for (std::size_t i = 0; i < 4 * pool.get_num_workers(); ++i) {
+        outer.push_back(pool.submit([&] {
+            std::vector<ve::job_handle<std::size_t>> inner;
+            for (std::size_t j = 0; j < 64; ++j) inner.push_back(pool.submit([j] { return j; }));
+
+            std::size_t inner_sum = 0;
+            for (const auto& job : inner) inner_sum += job.get();
+
+            return inner_sum;
+        }));
+    }
+
+    for (const auto& job : outer) {
+        if (job.get() != 63 * 64 / 2) result |= VE_TEST_FAIL("Nested job produced incorrect result.");
+    }
+
+
+    return result;
+}
+
+
+test_result test_main(void) {
+    return test_functionality();
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include <VoxelEngine/utility/buffer_pool.hpp>
+
+
+namespace ve {
+    buffer_pool& buffer_pool::instance(void) {
+        static buffer_pool i { };
+        return i;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/bit.hpp>
+
+#include <atomic>
+#include <mutex>
+
+
+namespace ve {
+    class buffer_pool;
+
+
+    namespace detail {
+        struct pooled_buffer_node {
+            std::vector<u8> data;
+            std::atomic<u32> references = 0;
+        };
+    }
+
+
+    // Reference counted handle to a byte buffer from a buffer_pool.
+    // The buffer is returned to the pool once the last handle to it is destroyed.
+    // Copying a handle does not copy the buffer, so modifying the buffer through one handle is visible through all other handles.
+    class pooled_buffer {
+    public:
+        pooled_buffer(void) = default;
+
+        pooled_buffer(const pooled_buffer& other) : node(other.node) {
+            if (node) node->references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        pooled_buffer(pooled_buffer&& other) noexcept : node(std::exchange(other.node, nullptr)) {}
+
+        pooled_buffer& operator=(pooled_buffer other) noexcept {
+            std::swap(node, other.node);
+            return *this;
+        }
+
+        ~pooled_buffer(void) { release(); }
+
+
+        std::vector<u8>& get(void) { return node->data; }
+        const std::vector<u8>& get(void) const { return node->data; }
+
+        std::span<const u8> span(void) const { return { node->data.begin(), node->data.end() }; }
+        operator std::span<const u8>(void) const { return span(); }
+
+        const u8& operator[](std::size_t index) const { return node->data[index]; }
+
+        std::size_t size(void) const { return node ? node->data.size() : 0; }
+        bool empty(void) const { return size() == 0; }
+        explicit operator bool(void) const { return node != nullptr; }
+
+
+        friend bool operator==(const pooled_buffer& lhs, std::span<const u8> rhs) {
+            return std::ranges::equal(lhs.span(), rhs);
+        }
+    private:
+        friend class buffer_pool;
+
+        detail::pooled_buffer_node* node = nullptr;
+
+
+        explicit pooled_buffer(detail::pooled_buffer_node* node) : node(node) {
+            node->references.store(1, std::memory_order_relaxed);
+        }
+
+        inline void release(void);
+    };
+
+
+    // Threadsafe pool of byte buffers, which are recycled rather than freed once they are no longer used.
+    // Buffers are grouped into size classes of powers of two, so a recycled buffer never has to grow to fit a message of the same size class.
+    class buffer_pool {
+    public:
+        constexpr static u8 min_size_class  = 8;  // 256 bytes.
+        constexpr static u8 max_size_class  = 27; // 128 MiB.
+        constexpr static std::size_t max_free_buffers_per_class = 64;
+
+
+        static buffer_pool& instance(void);
+
+
+        buffer_pool(void) = default;
+        ve_immovable(buffer_pool);
+
+        ~buffer_pool(void) {
+            for (auto& nodes : free_nodes) {
+                for (auto* node : nodes) delete node;
+            }
+        }
+
+
+        // Returns an empty buffer with a capacity of at least the given number of bytes.
+        pooled_buffer acquire(std::size_t capacity) {
+            const u8 size_class = size_class_for(capacity);
+
+            if (size_class <= max_size_class) {
+                std::lock_guard lock { mtx };
+                auto& nodes = free_nodes[size_class - min_size_class];
+
+                if (!nodes.empty()) {
+                    auto* node = nodes.back();
+                    nodes.pop_back();
+
+                    return pooled_buffer { node };
+                }
+            }
+
+
+            ++num_allocations;
+
+            auto* node = new detail::pooled_buffer_node { };
+            node->data.reserve(size_class <= max_size_class ? (1ull << size_class) : capacity);
+
+            return pooled_buffer { node };
+        }
+
+
+        // Returns the total number of buffers allocated by this pool, i.e. the number of times a buffer could not be recycled.
+        u64 get_num_allocations(void) const {
+            return num_allocations;
+        }
+    private:
+        friend class pooled_buffer;
+
+        std::mutex mtx;
+        std::array<std::vector<detail::pooled_buffer_node*>, max_size_class - min_size_class + 1> free_nodes;
+        std::atomic<u64> num_allocations = 0;
+
+
+        static u8 size_class_for(std::size_t capacity) {
+            return std::max(min_size_class, capacity > 1 ? msb(capacity - 1) : u8(0));
+        }
+
+
+        void recycle(detail::pooled_buffer_node* node) {
+            // The buffer may have grown while it was in use, so base its size class on its current capacity.
+            // Since the capacity is always at least the size of the class, round down.
+            const std::size_t capacity = node->data.capacity();
+            const u8 size_class = capacity > 0 ? u8(msb(capacity) - 1) : u8(0);
+
+            if (size_class >= min_size_class && size_class <= max_size_class) {
+                std::lock_guard lock { mtx };
+                auto& nodes = free_nodes[size_class - min_size_class];
+
+                if (nodes.size() < max_free_buffers_per_class) {
+                    node->data.clear();
+                    nodes.push_back(node);
+
+                    return;
+                }
+            }
+
+            delete node;
+        }
+    };
+
+
+    inline void pooled_buffer::release(void) {
+        if (node && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            buffer_pool::instance().recycle(node);
+        }
+
+        node = nullptr;
+    }
+}
\ No newline at end of file
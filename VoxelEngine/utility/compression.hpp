@@ -144,4 +144,111 @@ namespace ve {
         dest.resize(stream.total_out);
         return dest;
     }
+
+
+    // Deflate stream that is kept alive between messages, so that the cost of initializing ZLib is only paid once,
+    // and so that later messages can refer back to data from earlier messages.
+    // Messages compressed with this stream can only be decompressed by an inflate_stream, in the same order they were compressed.
+    class deflate_stream {
+    public:
+        explicit deflate_stream(compression_mode mode = compression_mode::BEST_PERFORMANCE) {
+            stream.zalloc = Z_NULL;
+            stream.zfree  = Z_NULL;
+            stream.opaque = Z_NULL;
+
+            // Use a raw deflate stream (negative window bits), since the ZLib header and checksum are redundant for in-order messages.
+            if (auto status = deflateInit2(&stream, (int) mode, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY); status != Z_OK) [[unlikely]] {
+                throw std::runtime_error { detail::stream_error_message(stream, status) };
+            }
+        }
+
+        ~deflate_stream(void) { deflateEnd(&stream); }
+        ve_immovable(deflate_stream);
+
+
+        // Compresses src and appends the result to dest.
+        void compress(std::span<const u8> src, std::vector<u8>& dest) {
+            stream.avail_in = src.size();
+            stream.next_in  = (const Bytef*) src.data();
+
+            const std::size_t old_size = dest.size();
+            std::size_t written = 0;
+
+            // Note: the output is only complete once deflate returns with space left in the output buffer.
+            do {
+                dest.resize(old_size + written + std::max<std::size_t>(src.size() / 2 + 64, 256), 0x00);
+
+                stream.avail_out = dest.size() - old_size - written;
+                stream.next_out  = dest.data() + old_size + written;
+
+                auto status = deflate(&stream, Z_SYNC_FLUSH);
+                if (!one_of(status, Z_OK, Z_BUF_ERROR)) [[unlikely]] throw std::runtime_error { detail::stream_error_message(stream, status) };
+
+                written = dest.size() - old_size - stream.avail_out;
+            } while (stream.avail_out == 0);
+
+
+            // A sync flush always ends with the same 4 bytes (00 00 FF FF), so there is no need to send them.
+            dest.resize(old_size + written - 4);
+        }
+    private:
+        z_stream stream;
+    };
+
+
+    // Counterpart to deflate_stream.
+    class inflate_stream {
+    public:
+        inflate_stream(void) {
+            stream.zalloc   = Z_NULL;
+            stream.zfree    = Z_NULL;
+            stream.opaque   = Z_NULL;
+            stream.avail_in = 0;
+            stream.next_in  = Z_NULL;
+
+            if (auto status = inflateInit2(&stream, -15); status != Z_OK) [[unlikely]] {
+                throw std::runtime_error { detail::stream_error_message(stream, status) };
+            }
+        }
+
+        ~inflate_stream(void) { inflateEnd(&stream); }
+        ve_immovable(inflate_stream);
+
+
+        // Decompresses src and appends the result to dest.
+        // Throws if the decompressed data would be larger than max_size, which can be used to reject untrusted data that expands too much.
+        void decompress(std::span<const u8> src, std::vector<u8>& dest, u32 block_size = 64_kib, std::size_t max_size = max_value<std::size_t>) {
+            constexpr std::array<u8, 4> sync_flush_marker { 0x00, 0x00, 0xFF, 0xFF };
+
+            const std::size_t old_size = dest.size();
+            std::size_t written = 0;
+
+
+            // Re-add the trailer removed by deflate_stream::compress.
+            for (std::span<const u8> input : { src, std::span<const u8> { sync_flush_marker } }) {
+                stream.avail_in = input.size();
+                stream.next_in  = (const Bytef*) input.data();
+
+                do {
+                    if (old_size + written == dest.size()) {
+                        dest.resize(dest.size() + std::min<std::size_t>(std::max<std::size_t>(src.size() * 4, 256), block_size), 0x00);
+                    }
+
+                    stream.avail_out = dest.size() - old_size - written;
+                    stream.next_out  = dest.data() + old_size + written;
+
+                    auto status = inflate(&stream, Z_SYNC_FLUSH);
+                    if (!one_of(status, Z_OK, Z_BUF_ERROR)) [[unlikely]] throw std::runtime_error { detail::stream_error_message(stream, status) };
+
+                    written = dest.size() - old_size - stream.avail_out;
+                    if (written > max_size) [[unlikely]] throw std::length_error { "Decompressed data exceeds the maximum size." };
+                } while (stream.avail_in > 0 || stream.avail_out == 0);
+            }
+
+
+            dest.resize(old_size + written);
+        }
+    private:
+        z_stream stream;
+    };
 }
\ No newline at end of file
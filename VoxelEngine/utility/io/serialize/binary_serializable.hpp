@@ -1,10 +1,12 @@
 #pragma once
 
 #include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 #include <VoxelEngine/utility/io/serialize/overloadable_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/push_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/variable_length_encoder.hpp>
 #include <VoxelEngine/utility/io/serialize/decomposable_serializer.hpp>
+#include <VoxelEngine/utility/io/serialize/fixed_layout_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/container_serializer.hpp>
 #include <VoxelEngine/utility/traits/always_false.hpp>
 #include <VoxelEngine/utility/traits/pack/pack.hpp>
@@ -30,7 +32,7 @@ namespace ve::serialize {
 
 
 
-    template <typename T> void to_bytes(const T& value, std::vector<u8>& dest) {
+    template <typename T, byte_sink Sink> void to_bytes(const T& value, Sink& dest) {
         // If T is const, use the same serializer as non-const T.
         if constexpr (std::is_const_v<T>) {
             to_bytes<std::remove_const_t<T>>(value, dest);
@@ -38,7 +40,16 @@ namespace ve::serialize {
 
         // If T has a custom serializer, use it.
         else if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) {
-            binary_serializer<T>::to_bytes(value, dest);
+            if constexpr (requires { binary_serializer<T>::to_bytes(value, dest); }) {
+                binary_serializer<T>::to_bytes(value, dest);
+            } else {
+                // Serializer does not support this sink, so go through a vector instead.
+                std::vector<u8> buffer;
+                binary_serializer<T>::to_bytes(value, buffer);
+
+                push_serializer ser { dest };
+                ser.push_bytes(buffer);
+            }
         }
 
         // If T is trivial, just copy its bytes.
@@ -52,6 +63,12 @@ namespace ve::serialize {
             container_to_bytes(value, dest);
         }
 
+        // If T is decomposable and all its members are trivial (recursively), its size is known at compile time,
+        // so it can be serialized as a single block rather than member by member.
+        else if constexpr (is_fixed_layout_v<T>) {
+            fixed_layout_to_bytes(value, dest);
+        }
+
         // If T is decomposable (i.e. it is possible to extract its members through some method like PFR or std::get) serialize each member.
         else if constexpr (is_decomposable_v<T> && ve_eval_if_valid(meta::create_pack::from_decomposable<T>::all([] <typename M> () { return is_serializable<M>; }))) {
             decomposable_to_bytes(value, dest);
@@ -68,12 +85,91 @@ namespace ve::serialize {
     // Overload for automatically constructing the destination vector.
     template <typename T> std::vector<u8> to_bytes(const T& value) {
         std::vector<u8> dest;
+        if constexpr (is_fixed_layout_v<T>) dest.reserve(fixed_layout_size_v<T>);
+
         to_bytes<T>(value, dest);
         return dest;
     }
 
 
-    template <typename T> T from_bytes(std::span<const u8>& src) {
+    namespace detail {
+        template <typename T> constexpr bool has_serialized_size(void) {
+            if constexpr (std::is_const_v<T>) {
+                return has_serialized_size<std::remove_const_t<T>>();
+            }
+
+            else if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) {
+                return requires (const T& value) { binary_serializer<T>::serialized_size(value); };
+            }
+
+            else if constexpr (std::is_trivial_v<T> || is_fixed_layout_v<T>) {
+                return true;
+            }
+
+            else if constexpr (supports_container_serialization_v<T>) {
+                return has_serialized_size<container_element_t<T>>();
+            }
+
+            else if constexpr (is_decomposable_v<T>) {
+                return meta::create_pack::from_decomposable<T>::all([] <typename M> () {
+                    return has_serialized_size<std::remove_cvref_t<M>>();
+                });
+            }
+
+            else return false;
+        }
+    }
+
+
+    // Can the serialized size of T be calculated without serializing it?
+    // This is the case unless T contains a type with a custom serializer which does not provide a serialized_size method.
+    template <typename T> constexpr inline bool has_serialized_size_v = detail::has_serialized_size<T>();
+
+
+    // Returns the number of bytes to_bytes will write for the given value, e.g. to pre-size the destination buffer.
+    template <typename T> std::size_t serialized_size(const T& value) {
+        // If T is const, use the same serializer as non-const T.
+        if constexpr (std::is_const_v<T>) {
+            return serialized_size<std::remove_const_t<T>>(value);
+        }
+
+        // If T has a custom serializer, use its size method if it has one, otherwise just serialize the value.
+        else if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) {
+            if constexpr (requires { binary_serializer<T>::serialized_size(value); }) {
+                return binary_serializer<T>::serialized_size(value);
+            } else {
+                std::vector<u8> buffer;
+                binary_serializer<T>::to_bytes(value, buffer);
+
+                return buffer.size();
+            }
+        }
+
+        else if constexpr (std::is_trivial_v<T>) {
+            return sizeof(T);
+        }
+
+        else if constexpr (detail::supports_container_serialization_v<T>) {
+            return container_serialized_size(value);
+        }
+
+        else if constexpr (is_fixed_layout_v<T>) {
+            return fixed_layout_size_v<T>;
+        }
+
+        else if constexpr (is_decomposable_v<T> && ve_eval_if_valid(meta::create_pack::from_decomposable<T>::all([] <typename M> () { return is_serializable<M>; }))) {
+            return decomposable_serialized_size(value);
+        }
+
+        else static_assert(
+            meta::always_false_v<T>,
+            "No known method exists to serialize this type. "
+            "To fix this error, please specialize ve::serialize::binary_serializer for your type."
+        );
+    }
+
+
+    template <typename T, byte_source Source> T from_bytes(Source& src) {
         // If T is const, use the same serializer as non-const T.
         if constexpr (std::is_const_v<T>) {
             return from_bytes<std::remove_const_t<T>>(src);
@@ -81,7 +177,12 @@ namespace ve::serialize {
 
         // If T has a custom serializer, use it.
         else if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) {
-            return binary_serializer<T>::from_bytes(src);
+            if constexpr (requires { binary_serializer<T>::from_bytes(src); }) {
+                return binary_serializer<T>::from_bytes(src);
+            } else {
+                // Serializer does not support this source, so make its data contiguous first.
+                return binary_serializer<T>::from_bytes(linearize(src));
+            }
         }
 
         // If T is trivial, just copy its bytes.
@@ -95,6 +196,11 @@ namespace ve::serialize {
             return container_from_bytes<T>(src);
         }
 
+        // If T is decomposable and all its members are trivial (recursively), deserialize it as a single block.
+        else if constexpr (is_fixed_layout_v<T>) {
+            return fixed_layout_from_bytes<T>(src);
+        }
+
         // If T is decomposable (i.e. it is possible to extract its members through some method like PFR or std::get) serialize each member.
         else if constexpr (is_decomposable_v<T> && ve_eval_if_valid(meta::create_pack::from_decomposable<T>::all([] <typename M> () { return is_serializable<M>; }))) {
             return decomposable_from_bytes<T>(src);
@@ -109,7 +215,7 @@ namespace ve::serialize {
 
 
     // Overload for non-span containers.
-    template <typename T, typename Ctr> requires (!std::is_same_v<Ctr, std::span<const u8>>)
+    template <typename T, typename Ctr> requires (!byte_source<Ctr>)
     T from_bytes(const Ctr& ctr) {
         std::span<const u8> s { ctr.begin(), ctr.end() };
         return from_bytes<T>(s);
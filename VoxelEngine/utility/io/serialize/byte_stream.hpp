@@ -0,0 +1,160 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/assert.hpp>
+
+
+namespace ve::serialize {
+    // Contiguous sources can always be read from directly.
+    inline std::span<const u8>& linearize(std::span<const u8>& source) {
+        return source;
+    }
+
+
+    // Destination for serialized data. Serialized data is appended to the end of the sink.
+    // std::vector<u8> is the default sink, but any type providing the same interface can be used,
+    // e.g. span_sink to serialize directly into an existing buffer.
+    template <typename T> concept byte_sink = requires (T& sink, const T& const_sink, std::size_t n, u8 byte) {
+        { const_sink.size() } -> std::convertible_to<std::size_t>;
+        { sink.data() } -> std::same_as<u8*>;
+        sink.resize(n);
+        sink.push_back(byte);
+    };
+
+
+    // Source of serialized data. Data is read from the end of the source.
+    // std::span<const u8> is the default source, but any type for which the following methods are defined can be used,
+    // e.g. segmented_source to deserialize from non-contiguous buffers.
+    //
+    // take_back_n(source, n): removes n bytes from the end of the source and returns them as a contiguous span.
+    // take_back(source): removes a single byte from the end of the source and returns it.
+    // linearize(source): returns the remaining data as a single contiguous span, reading from which also consumes the source.
+    template <typename T> concept byte_source = requires (T& source, const T& const_source, std::size_t n) {
+        { const_source.size() } -> std::convertible_to<std::size_t>;
+        { take_back_n(source, n) } -> std::convertible_to<std::span<const u8>>;
+        { take_back(source) } -> std::convertible_to<u8>;
+        { linearize(source) } -> std::same_as<std::span<const u8>&>;
+    };
+
+
+    // Sink that writes into an externally owned buffer, like a socket buffer or a memory mapped file.
+    // The buffer is not resized, so it should be large enough to contain the serialized data. (See serialized_size.)
+    class span_sink {
+    public:
+        explicit span_sink(std::span<u8> buffer) : buffer(buffer) {}
+
+
+        void resize(std::size_t new_size) {
+            VE_ASSERT(new_size <= buffer.size(), "Attempt to write ", new_size, " bytes into a span_sink with a capacity of ", buffer.size(), " bytes.");
+            used = new_size;
+        }
+
+
+        void push_back(u8 byte) {
+            resize(used + 1);
+            buffer[used - 1] = byte;
+        }
+
+
+        std::span<u8> written(void) const { return buffer.first(used); }
+
+        u8* data(void) { return buffer.data(); }
+        std::size_t size(void) const { return used; }
+        std::size_t capacity(void) const { return buffer.size(); }
+    private:
+        std::span<u8> buffer;
+        std::size_t used = 0;
+    };
+
+
+    // Source that reads from a sequence of non-contiguous buffers, like a chain of received packets.
+    // Reads that cross the boundary between two buffers are copied into an internal buffer,
+    // so spans returned by take_back_n remain valid only until the next call to take_back_n.
+    class segmented_source {
+    public:
+        segmented_source(void) = default;
+
+        explicit segmented_source(std::vector<std::span<const u8>> segments) {
+            for (auto segment : segments) add_segment(segment);
+        }
+
+
+        // Appends a segment to the end of the source. Since data is read from the end, this segment will be read first.
+        void add_segment(std::span<const u8> segment) {
+            if (!segment.empty()) segments.push_back(segment);
+        }
+
+
+        std::size_t size(void) const {
+            std::size_t result = 0;
+            for (const auto& segment : segments) result += segment.size();
+
+            return result;
+        }
+
+
+        bool empty(void) const {
+            return size() == 0;
+        }
+
+
+        friend std::span<const u8> take_back_n(segmented_source& source, std::size_t n) {
+            source.drop_empty_segments();
+
+            if (source.segments.empty() || source.segments.back().size() >= n) {
+                VE_ASSERT(n == 0 || !source.segments.empty(), "Attempt to read past the start of a segmented_source.");
+                return n == 0 ? std::span<const u8> { } : ve::take_back_n(source.segments.back(), n);
+            }
+
+
+            source.scratch.resize(n);
+            std::size_t remaining = n;
+
+            while (remaining > 0) {
+                source.drop_empty_segments();
+                VE_ASSERT(!source.segments.empty(), "Attempt to read past the start of a segmented_source.");
+
+                auto& segment = source.segments.back();
+                std::size_t count = std::min(remaining, segment.size());
+
+                remaining -= count;
+                memcpy(source.scratch.data() + remaining, ve::take_back_n(segment, count).data(), count);
+            }
+
+            return { source.scratch.begin(), source.scratch.end() };
+        }
+
+
+        friend u8 take_back(segmented_source& source) {
+            return take_back_n(source, 1)[0];
+        }
+
+
+        // Merges all remaining segments into a single one, so the source can be passed to methods that require contiguous data.
+        friend std::span<const u8>& linearize(segmented_source& source) {
+            source.drop_empty_segments();
+
+            if (source.segments.size() > 1) {
+                std::vector<u8> merged;
+                merged.reserve(source.size());
+
+                for (const auto& segment : source.segments) merged.insert(merged.end(), segment.begin(), segment.end());
+
+                source.linear = std::move(merged);
+                source.segments = { std::span<const u8> { source.linear.begin(), source.linear.end() } };
+            }
+
+            if (source.segments.empty()) source.segments.emplace_back();
+            return source.segments.back();
+        }
+    private:
+        std::vector<std::span<const u8>> segments;
+        std::vector<u8> scratch, linear;
+
+
+        void drop_empty_segments(void) {
+            while (!segments.empty() && segments.back().empty()) segments.pop_back();
+        }
+    };
+}
\ No newline at end of file
@@ -5,12 +5,15 @@
 #include <VoxelEngine/utility/traits/pick.hpp>
 #include <VoxelEngine/utility/traits/evaluate_if_valid.hpp>
 #include <VoxelEngine/utility/traits/is_std_array.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 #include <VoxelEngine/utility/io/serialize/variable_length_encoder.hpp>
+#include <VoxelEngine/utility/io/serialize/fixed_layout_serializer.hpp>
 
 
 namespace ve::serialize {
-    template <typename T> void to_bytes(const T&, std::vector<u8>&);
-    template <typename T> T from_bytes(std::span<const u8>&);
+    template <typename T, byte_sink Sink> void to_bytes(const T&, Sink&);
+    template <typename T, byte_source Source> T from_bytes(Source&);
+    template <typename T> std::size_t serialized_size(const T&);
 
 
     // If a container cannot be inserted into with any of the default methods,
@@ -101,20 +104,20 @@ namespace ve::serialize {
     }
 
 
-    template <typename T> requires detail::supports_trivial_container_serialization_v<T>
-    inline void trivial_container_to_bytes(const T& value, std::vector<u8>& dest) {
+    template <typename T, byte_sink Sink> requires detail::supports_trivial_container_serialization_v<T>
+    inline void trivial_container_to_bytes(const T& value, Sink& dest) {
         std::span s { std::cbegin(value), std::cend(value) };
 
         std::size_t old_size = dest.size();
         dest.resize(dest.size() + s.size());
 
-        memcpy(&dest[old_size], s.data(), s.size());
+        memcpy(dest.data() + old_size, s.data(), s.size());
         encode_variable_length(dest.size() - old_size, dest);
     }
 
 
-    template <typename T> requires detail::supports_trivial_container_serialization_v<T>
-    inline T trivial_container_from_bytes(std::span<const u8>& src) {
+    template <typename T, byte_source Source> requires detail::supports_trivial_container_serialization_v<T>
+    inline T trivial_container_from_bytes(Source& src) {
         std::size_t count = decode_variable_length(src);
 
         T result { };
@@ -127,8 +130,8 @@ namespace ve::serialize {
     }
 
 
-    template <typename T> requires detail::supports_container_serialization_v<T>
-    inline void container_to_bytes(const T& value, std::vector<u8>& dest) {
+    template <typename T, byte_sink Sink> requires detail::supports_container_serialization_v<T>
+    inline void container_to_bytes(const T& value, Sink& dest) {
         // Faster alternative for trivially copyable data.
         if constexpr (detail::supports_trivial_container_serialization_v<T>) {
             trivial_container_to_bytes(value, dest);
@@ -137,10 +140,29 @@ namespace ve::serialize {
 
 
         auto view = meta::pick<detail::insert_reversed<T>()>(views::reverse, views::all);
+        using element_t = detail::container_element_t<T>;
+
+
+        // If the size of every element is known in advance, resize the destination once and write the elements directly into it.
+        if constexpr (std::ranges::sized_range<const T> && is_fixed_layout_v<element_t>) {
+            const std::size_t count = std::ranges::size(value);
+
+            std::size_t offset = dest.size();
+            dest.resize(offset + count * fixed_layout_size_v<element_t>);
+
+            for (const auto& elem : value | view) {
+                fixed_layout_write<element_t>(elem, dest.data() + offset);
+                offset += fixed_layout_size_v<element_t>;
+            }
+
+            encode_variable_length(count, dest);
+            return;
+        }
+
 
         std::size_t count = 0;
         for (const auto& elem : value | view) {
-            to_bytes<detail::container_element_t<T>>(elem, dest);
+            to_bytes<element_t>(elem, dest);
             ++count;
         }
 
@@ -148,8 +170,8 @@ namespace ve::serialize {
     }
 
 
-    template <typename T> requires detail::supports_container_serialization_v<T>
-    inline T container_from_bytes(std::span<const u8>& src) {
+    template <typename T, byte_source Source> requires detail::supports_container_serialization_v<T>
+    inline T container_from_bytes(Source& src) {
         // Faster alternative for trivially copyable data.
         if constexpr (detail::supports_trivial_container_serialization_v<T>) {
             return trivial_container_from_bytes<T>(src);
@@ -165,4 +187,30 @@ namespace ve::serialize {
 
         return result;
     }
+
+
+    template <typename T> requires detail::supports_container_serialization_v<T>
+    inline std::size_t container_serialized_size(const T& value) {
+        if constexpr (detail::supports_trivial_container_serialization_v<T>) {
+            const std::size_t size = std::span { std::cbegin(value), std::cend(value) }.size();
+            return size + variable_length_size(size);
+        }
+
+
+        using element_t = detail::container_element_t<T>;
+
+        if constexpr (std::ranges::sized_range<const T> && is_fixed_layout_v<element_t>) {
+            const std::size_t count = std::ranges::size(value);
+            return count * fixed_layout_size_v<element_t> + variable_length_size(count);
+        }
+
+
+        std::size_t count = 0, size = 0;
+        for (const auto& elem : value) {
+            size += serialized_size<element_t>(elem);
+            ++count;
+        }
+
+        return size + variable_length_size(count);
+    }
 }
\ No newline at end of file
@@ -6,13 +6,15 @@
 #include <VoxelEngine/utility/traits/bind.hpp>
 #include <VoxelEngine/utility/traits/pick.hpp>
 #include <VoxelEngine/utility/traits/evaluate_if_valid.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 
 #include <boost/pfr.hpp>
 
 
 namespace ve::serialize {
-    template <typename T> void to_bytes(const T&, std::vector<u8>&);
-    template <typename T> T from_bytes(std::span<const u8>&);
+    template <typename T, byte_sink Sink> void to_bytes(const T&, Sink&);
+    template <typename T, byte_source Source> T from_bytes(Source&);
+    template <typename T> std::size_t serialized_size(const T&);
 
 
     namespace detail {
@@ -36,8 +38,8 @@ namespace ve::serialize {
     }
 
 
-    template <typename T> requires is_decomposable_v<T>
-    inline void decomposable_to_bytes(const T& value, std::vector<u8>& dest) {
+    template <typename T, byte_sink Sink> requires is_decomposable_v<T>
+    inline void decomposable_to_bytes(const T& value, Sink& dest) {
         // We want to pop in the reverse order we pushed, since the last element will be at the end of the array.
         // Since its easier to push in reverse than to pop in reverse, just flip the element order here.
         using member_types = typename meta::create_pack::from_decomposable<T>::reverse;
@@ -52,8 +54,8 @@ namespace ve::serialize {
     }
 
 
-    template <typename T> requires is_decomposable_v<T>
-    inline T decomposable_from_bytes(std::span<const u8>& src) {
+    template <typename T, byte_source Source> requires is_decomposable_v<T>
+    inline T decomposable_from_bytes(Source& src) {
         using member_types = typename meta::create_pack::from_decomposable<T>
             ::template expand_outside<std::remove_const_t>;
 
@@ -74,4 +76,17 @@ namespace ve::serialize {
             } (std::make_index_sequence<member_types::size>());
         }
     }
+
+
+    template <typename T> requires is_decomposable_v<T>
+    inline std::size_t decomposable_serialized_size(const T& value) {
+        using member_types = typename meta::create_pack::from_decomposable<T>;
+        std::size_t result = 0;
+
+        member_types::foreach_indexed([&] <typename E, std::size_t I> {
+            result += serialized_size<E>(decomposer_for<T>::template get<I>(value));
+        });
+
+        return result;
+    }
 }
\ No newline at end of file
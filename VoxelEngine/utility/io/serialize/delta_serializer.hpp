@@ -0,0 +1,307 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/bit.hpp>
+#include <VoxelEngine/utility/decompose.hpp>
+#include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+
+#include <xxhash.h>
+
+
+namespace ve::serialize {
+    // Types can provide the following hints to control how their fields are delta-encoded:
+    // - constexpr static f32 delta_vec3_precision: vec3f fields are encoded as fixed-point integers with the given precision.
+    // - using delta_quantize_quaternions_tag = void: quatf fields are encoded in 32 bits using smallest-three encoding.
+    // Note that these hints only apply to fields sent as part of a delta, and that both of them are lossy.
+    // Use delta_to_bytes_and_advance to keep a baseline that matches the quantized value the receiver holds.
+    template <typename T> struct delta_hints {
+        constexpr static f32 vec3_precision = [] {
+            if constexpr (requires { T::delta_vec3_precision; }) return (f32) T::delta_vec3_precision;
+            else return 0.0f;
+        } ();
+
+        constexpr static bool quantize_quaternions = requires { typename T::delta_quantize_quaternions_tag; };
+    };
+
+
+    namespace detail {
+        inline u64 zigzag_encode(i64 value) { return (u64(value) << 1) ^ u64(value >> 63); }
+        inline i64 zigzag_decode(u64 value) { return i64(value >> 1) ^ -i64(value & 1); }
+
+
+        // Encodes a normalized quaternion as the index of its largest component (2 bits) and its three remaining components (10 bits each).
+        // Since the quaternion is normalized, the largest component can be reconstructed from the other three.
+        // Since q and -q represent the same rotation, the largest component is always made positive.
+        inline u32 encode_smallest_three(const quatf& q) {
+            constexpr f32 range = 0.70710678f; // 1 / sqrt(2), the largest possible value of any non-largest component.
+
+            u32 largest = 0;
+            for (u32 i = 1; i < 4; ++i) {
+                if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+            }
+
+            f32 sign   = q[largest] < 0.0f ? -1.0f : 1.0f;
+            u32 result = largest << 30;
+            u32 shift  = 20;
+
+            for (u32 i = 0; i < 4; ++i) {
+                if (i == largest) continue;
+
+                f32 normalized = std::clamp((sign * q[i] + range) / (2.0f * range), 0.0f, 1.0f);
+                result |= u32(std::lround(normalized * 1023.0f)) << shift;
+                shift -= 10;
+            }
+
+            return result;
+        }
+
+
+        inline quatf decode_smallest_three(u32 encoded) {
+            constexpr f32 range = 0.70710678f; // 1 / sqrt(2), the largest possible value of any non-largest component.
+
+            quatf result;
+            u32 largest = encoded >> 30;
+            u32 shift   = 20;
+            f32 sum_sq  = 0.0f;
+
+            for (u32 i = 0; i < 4; ++i) {
+                if (i == largest) continue;
+
+                result[i] = (f32((encoded >> shift) & 0x3FF) / 1023.0f) * (2.0f * range) - range;
+                sum_sq   += result[i] * result[i];
+                shift    -= 10;
+            }
+
+            result[largest] = std::sqrt(std::max(0.0f, 1.0f - sum_sq));
+            return result;
+        }
+
+
+        template <typename Hints, typename F> inline void delta_field_to_bytes(const F& value, std::vector<u8>& dest) {
+            if constexpr (std::is_same_v<F, vec3f> && Hints::vec3_precision > 0.0f) {
+                for (std::size_t i = 0; i < 3; ++i) {
+                    encode_variable_length(zigzag_encode((i64) std::llround(value[i] / Hints::vec3_precision)), dest);
+                }
+            }
+
+            else if constexpr (std::is_same_v<F, quatf> && Hints::quantize_quaternions) {
+                push_serializer ser { dest };
+                ser.push(encode_smallest_three(value));
+            }
+
+            else to_bytes(value, dest);
+        }
+
+
+        template <typename Hints, typename F> inline F delta_field_from_bytes(std::span<const u8>& src) {
+            if constexpr (std::is_same_v<F, vec3f> && Hints::vec3_precision > 0.0f) {
+                vec3f result;
+
+                for (std::size_t i = 3; i-- > 0;) {
+                    result[i] = f32(zigzag_decode(decode_variable_length(src))) * Hints::vec3_precision;
+                }
+
+                return result;
+            }
+
+            else if constexpr (std::is_same_v<F, quatf> && Hints::quantize_quaternions) {
+                pop_deserializer ser { take_back_n(src, sizeof(u32)) };
+                return decode_smallest_three(ser.pop<u32>());
+            }
+
+            else return from_bytes<F>(src);
+        }
+
+
+        template <typename Hints, typename F> constexpr inline bool is_lossy_delta_field_v =
+            (std::is_same_v<F, vec3f> && Hints::vec3_precision > 0.0f) ||
+            (std::is_same_v<F, quatf> && Hints::quantize_quaternions);
+
+
+        // Returns the value the receiver will decode for the given field, which may differ from the field itself if it is encoded lossily.
+        template <typename Hints, typename F> inline F delta_field_decoded_value(const F& value) {
+            if constexpr (std::is_same_v<F, vec3f> && Hints::vec3_precision > 0.0f) {
+                vec3f result;
+                for (std::size_t i = 0; i < 3; ++i) result[i] = f32(std::llround(value[i] / Hints::vec3_precision)) * Hints::vec3_precision;
+
+                return result;
+            }
+
+            else if constexpr (std::is_same_v<F, quatf> && Hints::quantize_quaternions) {
+                return decode_smallest_three(encode_smallest_three(value));
+            }
+
+            else return value;
+        }
+
+
+        template <typename F> inline bool delta_fields_equal(const F& a, const F& b) {
+            if constexpr (std::equality_comparable<F>) return a == b;
+            else return to_bytes(a) == to_bytes(b);
+        }
+
+
+        // Types are delta-encoded per field if they are decomposable and don't have a custom serializer.
+        // A custom serializer may store data other than the fields of the object, so those types are delta-encoded as a blob instead.
+        template <typename T> constexpr inline bool supports_fieldwise_delta_v = [] {
+            if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) return false;
+            else if constexpr (std::is_scalar_v<T> || !is_decomposable_v<T>) return false;
+            else return decomposer_for<T>::size <= 64;
+        } ();
+
+
+        enum delta_blob_mode : u8 { BLOB_FULL = 0, BLOB_XOR = 1 };
+        constexpr inline std::size_t delta_block_size = 8;
+
+
+        // If decoded is not null, it is updated to the value the receiver will hold after applying the delta to baseline.
+        // decoded may alias baseline.
+        template <typename T> inline void delta_to_bytes_impl(const T& baseline, const T& value, std::vector<u8>& dest, T* decoded) {
+            if constexpr (supports_fieldwise_delta_v<T>) {
+                using decomposer = decomposer_for<T>;
+                using hints      = delta_hints<T>;
+
+                u64 changed = 0;
+
+                // Push fields in reverse, so they can be popped in order.
+                [&] <std::size_t... Is> (std::index_sequence<Is...>) {
+                    ([&] <std::size_t I> () {
+                        constexpr std::size_t EI = decomposer::size - I - 1;
+
+                        const auto& old_field = decomposer::template get<EI>(baseline);
+                        const auto& new_field = decomposer::template get<EI>(value);
+
+                        using field_t = std::remove_cvref_t<decltype(new_field)>;
+
+                        // For lossily encoded fields, compare against the value the receiver would decode,
+                        // so changes smaller than the precision of the encoding aren't sent.
+                        bool equal;
+                        if constexpr (is_lossy_delta_field_v<hints, field_t>) equal = delta_fields_equal(old_field, delta_field_decoded_value<hints>(new_field));
+                        else equal = delta_fields_equal(old_field, new_field);
+
+                        if (!equal) {
+                            changed |= nth_bit(EI);
+                            delta_field_to_bytes<hints>(new_field, dest);
+
+                            if (decoded) decomposer::template get<EI>(*decoded) = delta_field_decoded_value<hints>(new_field);
+                        }
+                    }.template operator()<Is>(), ...);
+                } (std::make_index_sequence<decomposer::size>());
+
+                encode_variable_length(changed, dest);
+            } else {
+                auto old_bytes = to_bytes(baseline);
+                auto new_bytes = to_bytes(value);
+
+                if (old_bytes.size() != new_bytes.size()) {
+                    push_serializer ser { dest };
+                    ser.push_bytes(new_bytes);
+
+                    encode_variable_length(new_bytes.size(), dest);
+                    dest.push_back(BLOB_FULL);
+
+                    if (decoded) *decoded = value;
+                    return;
+                }
+
+
+                const std::size_t num_blocks = (new_bytes.size() + delta_block_size - 1) / delta_block_size;
+                std::vector<u8> mask((num_blocks + 7) / 8, 0);
+
+                for (std::size_t block = 0; block < num_blocks; ++block) {
+                    std::size_t begin = block * delta_block_size;
+                    std::size_t end   = std::min(begin + delta_block_size, new_bytes.size());
+
+                    if (std::equal(old_bytes.begin() + begin, old_bytes.begin() + end, new_bytes.begin() + begin)) continue;
+
+                    mask[block / 8] |= u8(1 << (block % 8));
+                    for (std::size_t i = begin; i < end; ++i) dest.push_back(old_bytes[i] ^ new_bytes[i]);
+                }
+
+                push_serializer ser { dest };
+                ser.push_bytes(mask);
+
+                dest.push_back(BLOB_XOR);
+
+                // Blobs are not encoded lossily, so the receiver will hold the exact value.
+                if (decoded) *decoded = value;
+            }
+        }
+    }
+
+
+    // Appends an encoding of the difference between baseline and value to dest, which can be applied with apply_delta.
+    // Decomposable types write only the fields that differ from the baseline, together with a bitmask of changed fields.
+    // Other types are serialized and XOR-ed with the serialized baseline in blocks of 8 bytes, and only non-zero blocks are written.
+    // If the serialized size of the value changed, the full value is written instead.
+    template <typename T> inline void delta_to_bytes(const T& baseline, const T& value, std::vector<u8>& dest) {
+        detail::delta_to_bytes_impl(baseline, value, dest, (T*) nullptr);
+    }
+
+
+    // Equivalent to delta_to_bytes, but also updates baseline to the value the receiver will hold after applying the delta.
+    // If the type has lossy delta hints, this is the quantized value rather than value itself,
+    // so baselines updated this way stay identical on both ends.
+    template <typename T> inline void delta_to_bytes_and_advance(T& baseline, const T& value, std::vector<u8>& dest) {
+        detail::delta_to_bytes_impl(baseline, value, dest, &baseline);
+    }
+
+
+    // Returns a hash of the serialized form of the given value. Deltas carry the hash of the baseline they were created against,
+    // so the receiver can detect that it holds a different value, e.g. because it changed the value itself, and request the full value instead.
+    template <typename T> inline u64 baseline_hash(const T& value) {
+        auto bytes = to_bytes(value);
+        return XXH64(bytes.data(), bytes.size(), 0);
+    }
+
+
+    // Applies a delta created by delta_to_bytes to the given value, and pops the delta from src.
+    // Fields that were not changed keep the value they have in the given object.
+    // For types encoded as a blob, the value must serialize to the same bytes as the baseline the delta was created from.
+    template <typename T> inline void apply_delta(T& value, std::span<const u8>& src) {
+        if constexpr (detail::supports_fieldwise_delta_v<T>) {
+            using decomposer = decomposer_for<T>;
+            using hints      = delta_hints<T>;
+
+            u64 changed = decode_variable_length(src);
+
+            [&] <std::size_t... Is> (std::index_sequence<Is...>) {
+                ([&] <std::size_t I> () {
+                    if (changed & nth_bit(I)) {
+                        auto& field = decomposer::template get<I>(value);
+                        field = detail::delta_field_from_bytes<hints, std::remove_cvref_t<decltype(field)>>(src);
+                    }
+                }.template operator()<Is>(), ...);
+            } (std::make_index_sequence<decomposer::size>());
+        } else {
+            u8 mode = take_back(src);
+
+            if (mode == detail::BLOB_FULL) {
+                auto size  = decode_variable_length(src);
+                auto bytes = take_back_n(src, size);
+
+                value = from_bytes<T>(bytes);
+                return;
+            }
+
+
+            auto bytes = to_bytes(value);
+
+            const std::size_t num_blocks = (bytes.size() + detail::delta_block_size - 1) / detail::delta_block_size;
+            auto mask = take_back_n(src, (num_blocks + 7) / 8);
+
+            for (std::size_t block = num_blocks; block-- > 0;) {
+                if (!(mask[block / 8] & (1 << (block % 8)))) continue;
+
+                std::size_t begin = block * detail::delta_block_size;
+                std::size_t end   = std::min(begin + detail::delta_block_size, bytes.size());
+
+                auto patch = take_back_n(src, end - begin);
+                for (std::size_t i = begin; i < end; ++i) bytes[i] ^= patch[i - begin];
+            }
+
+            value = from_bytes<T>(bytes);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/decompose.hpp>
+#include <VoxelEngine/utility/traits/pack/pack.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
+#include <VoxelEngine/utility/io/serialize/overloadable_serializer.hpp>
+#include <VoxelEngine/utility/io/serialize/decomposable_serializer.hpp>
+
+
+namespace ve::serialize {
+    namespace detail {
+        template <typename T, std::size_t I> using fixed_layout_member_t =
+            std::remove_cvref_t<typename meta::create_pack::from_decomposable<T>::template get<I>>;
+
+
+        template <typename T> consteval bool is_fixed_layout(void) {
+            if constexpr (std::is_const_v<T>) return is_fixed_layout<std::remove_const_t<T>>();
+            else if constexpr (!requires { typename binary_serializer<T>::non_overloaded_tag; }) return false;
+            else if constexpr (std::is_trivial_v<T>) return true;
+            // Containers are never fixed layout, since their serialized form includes their size.
+            else if constexpr (requires (const T& t) { std::cbegin(t); }) return false;
+            else if constexpr (is_decomposable_v<T>) {
+                return meta::create_pack::from_decomposable<T>::all([] <typename M> () {
+                    return is_fixed_layout<std::remove_cvref_t<M>>();
+                });
+            }
+            else return false;
+        }
+    }
+
+
+    // A type has a fixed layout if it is trivial, or if it is decomposable and all its members have a fixed layout.
+    // The serialized size of such types is known at compile time, so they can be serialized without resizing the destination per member,
+    // and without any bounds checks per member when deserializing.
+    // Note: the serialized form is identical to the one produced by the decomposable serializer, so this is purely an optimization.
+    template <typename T> constexpr inline bool is_fixed_layout_v = detail::is_fixed_layout<T>();
+
+
+    namespace detail {
+        template <typename T> consteval std::size_t fixed_layout_size(void) {
+            if constexpr (std::is_trivial_v<T>) return sizeof(T);
+            else return [] <std::size_t... Is> (std::index_sequence<Is...>) {
+                return (fixed_layout_size<fixed_layout_member_t<T, Is>>() + ... + 0);
+            } (std::make_index_sequence<meta::create_pack::from_decomposable<T>::size>());
+        }
+
+
+        // Members are serialized in reverse order, so the first member is at the end of the serialized data.
+        template <typename T, std::size_t I> consteval std::size_t fixed_layout_offset(void) {
+            return fixed_layout_size<T>() - [] <std::size_t... Is> (std::index_sequence<Is...>) {
+                return (fixed_layout_size<fixed_layout_member_t<T, Is>>() + ... + 0);
+            } (std::make_index_sequence<I + 1>());
+        }
+    }
+
+
+    // Number of bytes in the serialized form of a fixed layout type.
+    template <typename T> requires is_fixed_layout_v<T>
+    constexpr inline std::size_t fixed_layout_size_v = detail::fixed_layout_size<std::remove_const_t<T>>();
+
+
+    // Writes exactly fixed_layout_size_v<T> bytes to dest.
+    template <typename T> requires is_fixed_layout_v<T>
+    inline void fixed_layout_write(const T& value, u8* dest) {
+        if constexpr (std::is_trivial_v<T>) {
+            memcpy(dest, &value, sizeof(T));
+        } else {
+            [&] <std::size_t... Is> (std::index_sequence<Is...>) {
+                (fixed_layout_write<detail::fixed_layout_member_t<T, Is>>(
+                    decomposer_for<T>::template get<Is>(value),
+                    dest + detail::fixed_layout_offset<T, Is>()
+                ), ...);
+            } (std::make_index_sequence<meta::create_pack::from_decomposable<T>::size>());
+        }
+    }
+
+
+    // Reads exactly fixed_layout_size_v<T> bytes from src.
+    template <typename T> requires is_fixed_layout_v<T>
+    inline T fixed_layout_read(const u8* src) {
+        if constexpr (std::is_trivial_v<T>) {
+            T result;
+            memcpy(&result, src, sizeof(T));
+            return result;
+        } else {
+            constexpr std::size_t num_members = meta::create_pack::from_decomposable<T>::size;
+
+            if constexpr (detail::supports_member_assignment_v<T>) {
+                T result { };
+
+                [&] <std::size_t... Is> (std::index_sequence<Is...>) {
+                    ((decomposer_for<T>::template get<Is>(result) = fixed_layout_read<detail::fixed_layout_member_t<T, Is>>(
+                        src + detail::fixed_layout_offset<T, Is>()
+                    )), ...);
+                } (std::make_index_sequence<num_members>());
+
+                return result;
+            } else {
+                return [&] <std::size_t... Is> (std::index_sequence<Is...>) {
+                    return T { fixed_layout_read<detail::fixed_layout_member_t<T, Is>>(src + detail::fixed_layout_offset<T, Is>())... };
+                } (std::make_index_sequence<num_members>());
+            }
+        }
+    }
+
+
+    template <typename T, byte_sink Sink> requires is_fixed_layout_v<T>
+    inline void fixed_layout_to_bytes(const T& value, Sink& dest) {
+        std::size_t old_size = dest.size();
+        dest.resize(old_size + fixed_layout_size_v<T>);
+
+        fixed_layout_write(value, dest.data() + old_size);
+    }
+
+
+    template <typename T, byte_source Source> requires is_fixed_layout_v<T>
+    inline T fixed_layout_from_bytes(Source& src) {
+        return fixed_layout_read<T>(take_back_n(src, fixed_layout_size_v<T>).data());
+    }
+}
\ No newline at end of file
@@ -13,6 +13,15 @@ namespace ve::serialize {
     // to_bytes should append its result to the end of the vector.
     // from_bytes should construct the given object from the end of the span,
     // and reduce the size of the span to remove the bytes that were used for deserialization.
+    //
+    // Optionally, specializations may also implement the following methods:
+    //
+    // template <byte_sink Sink> static void to_bytes(const T& value, Sink& dest)
+    // template <byte_source Source> static T from_bytes(Source& src)
+    // static std::size_t serialized_size(const T& value)
+    //
+    // If the first two methods are not templated, serializing to other sinks or from other sources than vectors and spans
+    // will go through an intermediate buffer. If serialized_size is not provided, calculating the size of T requires serializing it.
     template <typename T> struct binary_serializer {
         using non_overloaded_tag = void;
     };
@@ -23,12 +32,18 @@ namespace ve::serialize {
         { t.to_bytes(dst)    } -> std::same_as<void>;
         { T::from_bytes(src) } -> std::same_as<T>;
     } struct binary_serializer<T> {
-        static void to_bytes(const T& value, std::vector<u8>& dest) {
+        template <typename Sink> requires requires (const T& value, Sink& dest) { value.to_bytes(dest); }
+        static void to_bytes(const T& value, Sink& dest) {
             value.to_bytes(dest);
         }
 
-        static T from_bytes(std::span<const u8>& src) {
+        template <typename Source> requires requires (Source& src) { T::from_bytes(src); }
+        static T from_bytes(Source& src) {
             return T::from_bytes(src);
         }
+
+        static std::size_t serialized_size(const T& value) requires requires (const T& v) { { v.serialized_size() } -> std::convertible_to<std::size_t>; } {
+            return value.serialized_size();
+        }
     };
 }
\ No newline at end of file
@@ -2,11 +2,12 @@
 
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 
 
 namespace ve::serialize {
-    struct push_serializer {
-        std::vector<u8>& bytes;
+    template <byte_sink Sink = std::vector<u8>> struct push_serializer {
+        Sink& bytes;
 
 
         template <typename T> requires std::is_trivial_v<T>
@@ -14,7 +15,7 @@ namespace ve::serialize {
             std::size_t old_size = bytes.size();
             bytes.resize(bytes.size() + sizeof(T));
 
-            memcpy(&bytes[old_size], &object, sizeof(T));
+            memcpy(bytes.data() + old_size, &object, sizeof(T));
         }
 
 
@@ -23,7 +24,7 @@ namespace ve::serialize {
             std::size_t old_size = bytes.size();
             bytes.resize(bytes.size() + ctr.size());
 
-            std::copy(ctr.begin(), ctr.end(), bytes.begin() + old_size);
+            std::copy(ctr.begin(), ctr.end(), bytes.data() + old_size);
         }
 
 
@@ -32,10 +33,12 @@ namespace ve::serialize {
         }
 
         bool empty(void) const {
-            return bytes.empty();
+            return bytes.size() == 0;
         }
     };
 
+    template <byte_sink Sink> push_serializer(Sink&) -> push_serializer<Sink>;
+
 
     struct pop_deserializer {
         std::span<const u8> bytes;
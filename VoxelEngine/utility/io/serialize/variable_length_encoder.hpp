@@ -2,6 +2,7 @@
 
 #include <VoxelEngine/core/core.hpp>
 #include <VoxelEngine/utility/algorithm.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 
 
 namespace ve::serialize {
@@ -9,7 +10,7 @@ namespace ve::serialize {
     // The most significant bit in every byte is set to zero, except for the first one, which is set to one.
     // This is similar to how multi-byte encodings like UTF-8 work,
     // except in reverse since the decode method pops from the end of the array.
-    inline void encode_variable_length(u64 length, std::vector<u8>& dest) {
+    template <byte_sink Sink> inline void encode_variable_length(u64 length, Sink& dest) {
         u64 remaining = length;
 
         while (true) {
@@ -25,7 +26,7 @@ namespace ve::serialize {
 
     // Decodes a length encoded by encode_variable_length at the end of the source array,
     // and pops the read bytes from that array.
-    inline u64 decode_variable_length(std::span<const u8>& source) {
+    template <byte_source Source> inline u64 decode_variable_length(Source& source) {
         u64 result = 0;
 
         while (true) {
@@ -41,6 +42,82 @@ namespace ve::serialize {
     }
 
 
+    // Variant of decode_variable_length for untrusted data, which returns std::nullopt if the source ends before the length does,
+    // or if the length does not fit in a u64. The source is left in an unspecified state in that case.
+    inline std::optional<u64> try_decode_variable_length(std::span<const u8>& source) {
+        u64 result = 0;
+
+        while (true) {
+            if (source.empty() || (result >> (64 - 7)) != 0) [[unlikely]] return std::nullopt;
+            u8 current = take_back(source);
+
+            result <<= 7;
+            result |= current & 0b0111'1111;
+
+            if (current & 0b1000'0000) break;
+        }
+
+        return result;
+    }
+
+
+    // Returns the number of bytes used to encode the given length, for both the normal and the forward-readable encoding.
+    inline std::size_t variable_length_size(u64 length) {
+        std::size_t result = 1;
+        while (length >>= 7) ++result;
+
+        return result;
+    }
+
+
+    // Forward-readable variant of the above methods: the most significant bit in every byte is set to one, except for the last one.
+    // This allows the length to be read from the start of an array, so data can be parsed in the order it was written.
+    // Writes length in forward-readable form to dest, which must have room for variable_length_size(length) bytes.
+    inline void write_variable_length_forward(u64 length, u8* dest) {
+        while (length >= 0b1000'0000) {
+            *(dest++) = u8(length) | 0b1000'0000;
+            length >>= 7;
+        }
+
+        *dest = u8(length);
+    }
+
+
+    inline void encode_variable_length_forward(u64 length, std::vector<u8>& dest) {
+        std::size_t offset = dest.size();
+        dest.resize(offset + variable_length_size(length));
+
+        write_variable_length_forward(length, dest.data() + offset);
+    }
+
+
+    // Decodes a length encoded by encode_variable_length_forward at the start of the source array,
+    // and pops the read bytes from that array.
+    // Since this is used to parse untrusted data, std::nullopt is returned if the source ends before the length does,
+    // or if the length does not fit in a u64. The source is left in an unspecified state in that case.
+    inline std::optional<u64> decode_variable_length_forward(std::span<const u8>& source) {
+        u64 result = 0;
+        u8 shift   = 0;
+
+        while (true) {
+            if (source.empty() || shift >= 64) [[unlikely]] return std::nullopt;
+
+            u8 current = take_front(source);
+            u64 bits   = current & 0b0111'1111;
+
+            // The last byte of a u64 only has room for a single bit.
+            if (shift > 0 && (bits >> (64 - shift)) != 0) [[unlikely]] return std::nullopt;
+
+            result |= bits << shift;
+            shift  += 7;
+
+            if (!(current & 0b1000'0000)) break;
+        }
+
+        return result;
+    }
+
+
     // Used with boost asio to check if a message containing a variable length integer has been fully transferred.
     // Note: variable lengths are transmitted in reverse so the last byte has its msb set, rather than the first one.
     template <typename Ctr> struct transfer_variable_length_t {
@@ -0,0 +1,256 @@
+#include <VoxelEngine/utility/metrics/metrics.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
+
+namespace ve::metrics {
+    namespace detail {
+        thread_shard::block* thread_shard::allocate_block(std::size_t index) {
+            auto& result = owned_blocks.emplace_back(make_unique<block>());
+            blocks[index].store(result.get(), std::memory_order_release);
+
+            return result.get();
+        }
+
+
+        // Thread-local handle to the shard of a thread, which retires the shard when the thread exits.
+        struct shard_owner {
+            thread_shard* shard = nullptr;
+
+            ~shard_owner(void) {
+                if (shard) registry::instance().retire_shard(shard);
+            }
+        };
+
+
+        thread_shard& local_shard(void) {
+            thread_local shard_owner owner;
+
+            if (!owner.shard) [[unlikely]] owner.shard = registry::instance().create_shard();
+            return *owner.shard;
+        }
+
+
+        // Prometheus requires +Inf, -Inf and NaN to be written in this exact form.
+        static void write_value(std::ostream& stream, f64 value) {
+            if (std::isnan(value)) stream << "NaN";
+            else if (std::isinf(value)) stream << (value > 0 ? "+Inf" : "-Inf");
+            else {
+                std::array<char, 32> buffer;
+                auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+                stream << std::string_view { buffer.data(), end };
+            }
+        }
+
+
+        static void write_header(std::ostream& stream, std::string_view name, std::string_view help, std::string_view type) {
+            if (!help.empty()) stream << "# HELP " << name << " " << help << "\n";
+            stream << "# TYPE " << name << " " << type << "\n";
+        }
+    }
+
+
+    u64 counter::value(void) const {
+        return registry::instance().read_slot(slot);
+    }
+
+
+    histogram::snapshot histogram::value(void) const {
+        auto& r = registry::instance();
+        snapshot result;
+
+        for (u32 i = 0; i < bounds.size() + 1; ++i) {
+            result.bucket_counts.push_back(r.read_slot(first_slot + i));
+            result.count += result.bucket_counts.back();
+        }
+
+        result.sum = r.read_slot_f64(sum_slot());
+        return result;
+    }
+
+
+    registry& registry::instance(void) {
+        // The registry is never destroyed, since threads that are joined during static destruction (e.g. the thread pool)
+        // may still record metrics or retire their shard after a function-local static registry would have been destroyed.
+        static registry* i = new registry();
+        return *i;
+    }
+
+
+    counter& registry::get_counter(std::string_view name, std::string_view help) {
+        std::lock_guard lock { mtx };
+
+        if (auto it = counters.find(name); it != counters.end()) return *it->second;
+        check_name_unused(name);
+
+        auto metric = make_unique<counter>(std::string { name }, std::string { help }, allocate_slots(1));
+        return *counters.emplace(std::string { name }, std::move(metric)).first->second;
+    }
+
+
+    gauge& registry::get_gauge(std::string_view name, std::string_view help) {
+        std::lock_guard lock { mtx };
+
+        if (auto it = gauges.find(name); it != gauges.end()) return *it->second;
+        check_name_unused(name);
+
+        auto metric = make_unique<gauge>(std::string { name }, std::string { help });
+        return *gauges.emplace(std::string { name }, std::move(metric)).first->second;
+    }
+
+
+    histogram& registry::get_histogram(std::string_view name, std::string_view help, std::vector<f64> bounds) {
+        std::lock_guard lock { mtx };
+
+        if (auto it = histograms.find(name); it != histograms.end()) return *it->second;
+        check_name_unused(name);
+
+        // The last slot of a histogram stores the sum of all observed values.
+        const auto first_slot = allocate_slots(histogram::num_slots(bounds.size()), 1);
+        auto metric = make_unique<histogram>(std::string { name }, std::string { help }, std::move(bounds), first_slot);
+
+        return *histograms.emplace(std::string { name }, std::move(metric)).first->second;
+    }
+
+
+    void registry::write(std::ostream& stream) const {
+        // Reading a metric locks the registry itself, so only the list of metrics is collected while holding the lock.
+        std::vector<const counter*> counter_list;
+        std::vector<const gauge*> gauge_list;
+        std::vector<const histogram*> histogram_list;
+
+        {
+            std::lock_guard lock { mtx };
+
+            for (const auto& [name, metric] : counters) counter_list.push_back(metric.get());
+            for (const auto& [name, metric] : gauges) gauge_list.push_back(metric.get());
+            for (const auto& [name, metric] : histograms) histogram_list.push_back(metric.get());
+        }
+
+
+        for (const auto* metric : counter_list) {
+            detail::write_header(stream, metric->get_name(), metric->get_help(), "counter");
+            stream << metric->get_name() << " " << metric->value() << "\n";
+        }
+
+
+        for (const auto* metric : gauge_list) {
+            detail::write_header(stream, metric->get_name(), metric->get_help(), "gauge");
+            stream << metric->get_name() << " ";
+            detail::write_value(stream, metric->value());
+            stream << "\n";
+        }
+
+
+        for (const auto* metric : histogram_list) {
+            detail::write_header(stream, metric->get_name(), metric->get_help(), "histogram");
+
+            const auto snapshot = metric->value();
+            const auto& bounds  = metric->get_bounds();
+
+            // Prometheus buckets are cumulative.
+            u64 cumulative = 0;
+
+            for (std::size_t i = 0; i < snapshot.bucket_counts.size(); ++i) {
+                cumulative += snapshot.bucket_counts[i];
+
+                stream << metric->get_name() << "_bucket{le=\"";
+                detail::write_value(stream, i < bounds.size() ? bounds[i] : std::numeric_limits<f64>::infinity());
+                stream << "\"} " << cumulative << "\n";
+            }
+
+            stream << metric->get_name() << "_sum ";
+            detail::write_value(stream, snapshot.sum);
+            stream << "\n" << metric->get_name() << "_count " << snapshot.count << "\n";
+        }
+    }
+
+
+    void registry::export_to_file(const fs::path& path) const {
+        // Exports may be started from different threads, and they all use the same temporary file.
+        std::lock_guard lock { export_mtx };
+
+        auto temporary = path;
+        temporary += ".tmp";
+
+        {
+            std::ofstream stream { temporary, std::ios::trunc };
+            write(stream);
+
+            if (!stream) {
+                VE_LOG_WARN(cat("Failed to write metrics to ", temporary, "."));
+                return;
+            }
+        }
+
+        std::error_code error;
+        fs::rename(temporary, path, error);
+
+        if (error) VE_LOG_WARN(cat("Failed to write metrics to ", path, ": ", error.message()));
+    }
+
+
+    detail::thread_shard* registry::create_shard(void) {
+        std::lock_guard lock { mtx };
+        return shards.emplace_back(make_unique<detail::thread_shard>()).get();
+    }
+
+
+    void registry::retire_shard(detail::thread_shard* shard) {
+        std::lock_guard lock { mtx };
+
+        for (u32 slot = 0; slot < next_slot; ++slot) {
+            const u64 value = shard->read(slot);
+
+            if (float_slots[slot]) retired[slot] = std::bit_cast<u64>(std::bit_cast<f64>(retired[slot]) + std::bit_cast<f64>(value));
+            else retired[slot] += value;
+        }
+
+        std::erase_if(shards, [&] (const auto& s) { return s.get() == shard; });
+    }
+
+
+    u32 registry::allocate_slots(u32 count, u32 num_float_slots) {
+        VE_ASSERT(
+            next_slot + count <= detail::thread_shard::block_size * detail::thread_shard::max_blocks,
+            "Maximum number of metric slots exceeded."
+        );
+
+        retired.resize(next_slot + count, 0);
+        float_slots.resize(next_slot + count, false);
+        std::fill(float_slots.end() - num_float_slots, float_slots.end(), true);
+
+        return std::exchange(next_slot, next_slot + count);
+    }
+
+
+    u64 registry::read_slot(u32 slot) const {
+        std::lock_guard lock { mtx };
+
+        u64 result = retired[slot];
+        for (const auto& shard : shards) result += shard->read(slot);
+
+        return result;
+    }
+
+
+    f64 registry::read_slot_f64(u32 slot) const {
+        std::lock_guard lock { mtx };
+
+        f64 result = std::bit_cast<f64>(retired[slot]);
+        for (const auto& shard : shards) result += std::bit_cast<f64>(shard->read(slot));
+
+        return result;
+    }
+
+
+    void registry::check_name_unused(std::string_view name) const {
+        VE_ASSERT(
+            !counters.contains(name) && !gauges.contains(name) && !histograms.contains(name),
+            "A metric with the name ", name, " already exists with a different type."
+        );
+    }
+}
\ No newline at end of file
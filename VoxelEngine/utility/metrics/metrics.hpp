@@ -0,0 +1,250 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/assert.hpp>
+
+#include <atomic>
+#include <bit>
+#include <map>
+#include <mutex>
+#include <ostream>
+
+
+// Returns a reference to the metric with the given name, which is only looked up the first time the expression is evaluated.
+#define VE_IMPL_METRIC(Type, ...) \
+([] () -> ve::metrics::Type& { static auto& metric = ve::metrics::registry::instance().BOOST_PP_CAT(get_, Type)(__VA_ARGS__); return metric; }())
+
+#define VE_METRIC_COUNTER(...) VE_IMPL_METRIC(counter, __VA_ARGS__)
+#define VE_METRIC_GAUGE(...) VE_IMPL_METRIC(gauge, __VA_ARGS__)
+#define VE_METRIC_HISTOGRAM(...) VE_IMPL_METRIC(histogram, __VA_ARGS__)
+
+// Records the time until the end of the current scope in the histogram with the given name.
+#define VE_METRIC_TIMER(...) \
+ve::metrics::scoped_timer BOOST_PP_CAT(ve_impl_metric_timer_, __LINE__) { VE_METRIC_HISTOGRAM(__VA_ARGS__) }
+
+
+namespace ve::metrics {
+    namespace detail {
+        // Every thread accumulates into its own shard, so updating a metric never requires synchronization between threads.
+        // Slots are only written by the owning thread, and are read by the exporter.
+        // Blocks are allocated on first use, so the exporter can read them while the owning thread is still adding new blocks.
+        struct thread_shard {
+            constexpr static inline std::size_t block_size = 256;
+            constexpr static inline std::size_t max_blocks = 64;
+
+            using block = std::array<std::atomic<u64>, block_size>;
+
+            std::array<std::atomic<block*>, max_blocks> blocks { };
+            std::vector<unique<block>> owned_blocks;
+
+
+            std::atomic<u64>& get_slot(u32 slot) {
+                const auto index = slot / block_size;
+                VE_DEBUG_ASSERT(index < max_blocks, "Maximum number of metric slots exceeded.");
+
+                block* b = blocks[index].load(std::memory_order_acquire);
+                if (!b) [[unlikely]] b = allocate_block(index);
+
+                return (*b)[slot % block_size];
+            }
+
+
+            // There is only ever one writer, so a separate load and store is sufficient and avoids a locked instruction.
+            void add(u32 slot, u64 amount) {
+                auto& value = get_slot(slot);
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            void add(u32 slot, f64 amount) {
+                auto& value = get_slot(slot);
+                value.store(std::bit_cast<u64>(std::bit_cast<f64>(value.load(std::memory_order_relaxed)) + amount), std::memory_order_relaxed);
+            }
+
+
+            u64 read(u32 slot) const {
+                const block* b = blocks[slot / block_size].load(std::memory_order_acquire);
+                return b ? (*b)[slot % block_size].load(std::memory_order_relaxed) : 0;
+            }
+
+        private:
+            block* allocate_block(std::size_t index);
+        };
+
+
+        // Returns the shard of the current thread. The shard is merged into the registry and freed when the thread exits.
+        thread_shard& local_shard(void);
+        struct shard_owner;
+    }
+
+
+    // Monotonically increasing value, e.g. the number of bytes sent.
+    class counter {
+    public:
+        counter(std::string name, std::string help, u32 slot) : name(std::move(name)), help(std::move(help)), slot(slot) {}
+        ve_immovable(counter);
+
+
+        void add(u64 amount = 1) {
+            detail::local_shard().add(slot, amount);
+        }
+
+        u64 value(void) const;
+
+
+        VE_GET_CREF(name);
+        VE_GET_CREF(help);
+    private:
+        std::string name, help;
+        u32 slot;
+    };
+
+
+    // Value that can go up and down, e.g. the number of queued jobs.
+    // Gauges are usually set from a single place, so they are stored globally rather than per thread.
+    class gauge {
+    public:
+        gauge(std::string name, std::string help) : name(std::move(name)), help(std::move(help)) {}
+        ve_immovable(gauge);
+
+
+        void set(f64 v) { current.store(v, std::memory_order_relaxed); }
+        void add(f64 v) { current.fetch_add(v, std::memory_order_relaxed); }
+        f64 value(void) const { return current.load(std::memory_order_relaxed); }
+
+
+        VE_GET_CREF(name);
+        VE_GET_CREF(help);
+    private:
+        std::string name, help;
+        std::atomic<f64> current = 0.0;
+    };
+
+
+    // Distribution of observed values over a fixed set of buckets, e.g. the time taken to mesh a chunk.
+    // Bucket i counts values v where bounds[i - 1] < v <= bounds[i]. There is an additional bucket for values above the last bound.
+    class histogram {
+    public:
+        struct snapshot {
+            std::vector<u64> bucket_counts;
+            u64 count = 0;
+            f64 sum = 0.0;
+        };
+
+
+        histogram(std::string name, std::string help, std::vector<f64> bounds, u32 first_slot) :
+            name(std::move(name)), help(std::move(help)), bounds(std::move(bounds)), first_slot(first_slot)
+        {
+            VE_ASSERT(std::ranges::is_sorted(this->bounds), "Histogram bounds must be sorted.");
+        }
+
+        ve_immovable(histogram);
+
+
+        void observe(f64 v) {
+            const auto bucket = (u32) std::distance(bounds.begin(), std::ranges::lower_bound(bounds, v));
+
+            auto& shard = detail::local_shard();
+            shard.add(first_slot + bucket, u64(1));
+            shard.add(sum_slot(), v);
+        }
+
+        // Durations are stored in seconds.
+        void observe(nanoseconds duration) {
+            observe(std::chrono::duration<f64> { duration }.count());
+        }
+
+        snapshot value(void) const;
+
+
+        // Number of slots used by a histogram with the given number of bounds: one per bucket, plus one for the sum.
+        static u32 num_slots(std::size_t num_bounds) {
+            return u32(num_bounds + 2);
+        }
+
+
+        VE_GET_CREF(name);
+        VE_GET_CREF(help);
+        VE_GET_CREF(bounds);
+    private:
+        std::string name, help;
+        std::vector<f64> bounds;
+        u32 first_slot;
+
+        u32 sum_slot(void) const { return first_slot + u32(bounds.size() + 1); }
+    };
+
+
+    // Exponential buckets from 10us to ~10s, suitable for most latencies.
+    inline std::vector<f64> default_latency_bounds(void) {
+        std::vector<f64> result;
+        for (f64 bound = 1e-5; bound < 20.0; bound *= 2.0) result.push_back(bound);
+
+        return result;
+    }
+
+
+    // Records the time between its construction and destruction in the given histogram.
+    class scoped_timer {
+    public:
+        explicit scoped_timer(histogram& target) : target(&target), start(steady_clock::now()) {}
+        ~scoped_timer(void) { target->observe(steady_clock::now() - start); }
+
+        ve_immovable(scoped_timer);
+    private:
+        histogram* target;
+        steady_clock::time_point start;
+    };
+
+
+    // Engine-wide collection of metrics. Metrics are created on first use and live for the duration of the program,
+    // so references to them can be cached (see the VE_METRIC macros).
+    // Metric names should be valid Prometheus metric names, e.g. ve_chunk_mesh_seconds.
+    class registry {
+    public:
+        static registry& instance(void);
+
+
+        // Returns the metric with the given name, creating it if it does not exist yet.
+        // The help text and bounds are only used when the metric is created.
+        counter& get_counter(std::string_view name, std::string_view help = "");
+        gauge& get_gauge(std::string_view name, std::string_view help = "");
+        histogram& get_histogram(std::string_view name, std::string_view help = "", std::vector<f64> bounds = default_latency_bounds());
+
+
+        // Writes all metrics in the Prometheus text exposition format.
+        void write(std::ostream& stream) const;
+
+        // Writes all metrics to the given file. The file is replaced atomically, so readers never see a partially written file.
+        void export_to_file(const fs::path& path) const;
+    private:
+        friend class counter;
+        friend class histogram;
+        friend struct detail::shard_owner;
+
+
+        mutable std::mutex mtx, export_mtx;
+
+        std::map<std::string, unique<counter>, std::less<>> counters;
+        std::map<std::string, unique<gauge>, std::less<>> gauges;
+        std::map<std::string, unique<histogram>, std::less<>> histograms;
+
+        // When a thread exits, the values in its shard are added to the retired values and the shard is freed,
+        // so values reported by that thread are not lost while the number of shards stays bounded by the number of live threads.
+        std::vector<unique<detail::thread_shard>> shards;
+        std::vector<u64> retired;
+        std::vector<bool> float_slots;
+        u32 next_slot = 0;
+
+
+        registry(void) = default;
+
+        detail::thread_shard* create_shard(void);
+        void retire_shard(detail::thread_shard* shard);
+
+        // The last num_float_slots slots of the allocated range store f64 values rather than u64 values.
+        u32 allocate_slots(u32 count, u32 num_float_slots = 0);
+        u64 read_slot(u32 slot) const;
+        f64 read_slot_f64(u32 slot) const;
+        void check_name_unused(std::string_view name) const;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+
+#include <atomic>
+
+
+namespace ve {
+    // Unbounded lock-free queue for a single producer thread and a single consumer thread.
+    // Elements are stored in linked blocks of BlockSize elements, so pushing only allocates once every BlockSize elements.
+    // The last block released by the consumer is kept as a spare, so a queue that is drained regularly does not allocate at all.
+    // Note: it is not required that the producer and consumer are always the same thread,
+    // as long as there is a happens-before relation between consecutive calls on the same side (e.g. a chain of ASIO handlers).
+    template <typename T, std::size_t BlockSize = 64> class spsc_queue {
+    public:
+        spsc_queue(void) : head(new block), tail(head) {}
+
+        ~spsc_queue(void) {
+            while (try_pop()) ;
+
+            delete head;
+            delete spare.load(std::memory_order_acquire);
+        }
+
+        ve_immovable(spsc_queue);
+
+
+        // Producer only.
+        template <typename... Args> void emplace(Args&&... args) {
+            if (tail_index == BlockSize) {
+                block* next = spare.exchange(nullptr, std::memory_order_acquire);
+                if (!next) next = new block;
+
+                tail->next.store(next, std::memory_order_release);
+                tail       = next;
+                tail_index = 0;
+            }
+
+            new (tail->slot(tail_index)) T(fwd(args)...);
+            tail->written.store(++tail_index, std::memory_order_release);
+        }
+
+
+        void push(T value) {
+            emplace(std::move(value));
+        }
+
+
+        // Consumer only.
+        std::optional<T> try_pop(void) {
+            if (head_index == BlockSize) {
+                block* next = head->next.load(std::memory_order_acquire);
+                if (!next) return std::nullopt;
+
+                release_block(std::exchange(head, next));
+                head_index = 0;
+            }
+
+            if (head_index == head->written.load(std::memory_order_acquire)) return std::nullopt;
+
+
+            T* slot = head->slot(head_index++);
+
+            std::optional<T> result { std::move(*slot) };
+            slot->~T();
+
+            return result;
+        }
+
+
+        // Consumer only. Invokes the given function for every element currently in the queue and returns the number of elements popped.
+        template <typename F> std::size_t drain(F&& fn) {
+            std::size_t count = 0;
+
+            while (auto value = try_pop()) {
+                std::invoke(fn, std::move(*value));
+                ++count;
+            }
+
+            return count;
+        }
+
+
+        // Consumer only. Elements pushed concurrently may or may not be taken into account.
+        bool empty(void) const {
+            if (head_index == BlockSize) return head->next.load(std::memory_order_acquire) == nullptr;
+            return head_index == head->written.load(std::memory_order_acquire);
+        }
+    private:
+        struct block {
+            alignas(T) std::byte storage[BlockSize * sizeof(T)];
+            std::atomic<std::size_t> written = 0;
+            std::atomic<block*> next = nullptr;
+
+            T* slot(std::size_t index) { return std::launder(reinterpret_cast<T*>(storage + index * sizeof(T))); }
+        };
+
+
+        // Consumer and producer state are kept on separate cache lines, so the threads do not invalidate each other's cache.
+        alignas(64) block* head;
+        std::size_t head_index = 0;
+
+        alignas(64) block* tail;
+        std::size_t tail_index = 0;
+
+        alignas(64) std::atomic<block*> spare = nullptr;
+
+
+        void release_block(block* b) {
+            b->written.store(0, std::memory_order_relaxed);
+            b->next.store(nullptr, std::memory_order_relaxed);
+
+            if (b = spare.exchange(b, std::memory_order_release); b) delete b;
+        }
+    };
+}
\ No newline at end of file
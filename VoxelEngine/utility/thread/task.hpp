@@ -0,0 +1,267 @@
+#pragma once
+
+#include <VoxelEngine/core/core.hpp>
+#include <VoxelEngine/utility/thread/thread_pool.hpp>
+
+#include <coroutine>
+
+
+namespace ve {
+    template <typename T = void> class task;
+
+
+    // Thrown from co_await yield_if_cancelled() if the task has been cancelled.
+    struct task_cancelled : std::exception {
+        const char* what(void) const noexcept override { return "Task was cancelled."; }
+    };
+
+
+    // Shared flag used to cancel a task. Copies of a token refer to the same flag.
+    class cancellation_token {
+    public:
+        void cancel(void) { flag->store(true, std::memory_order_release); }
+        bool is_cancelled(void) const { return flag->load(std::memory_order_acquire); }
+    private:
+        shared<std::atomic_bool> flag = make_shared<std::atomic_bool>(false);
+    };
+
+
+    namespace detail {
+        struct task_promise_base {
+            std::coroutine_handle<> continuation = nullptr;
+            std::exception_ptr exception = nullptr;
+            std::optional<cancellation_token> token = std::nullopt;
+
+
+            // Tasks are lazy: they only start once they are awaited or spawned.
+            std::suspend_always initial_suspend(void) noexcept { return {}; }
+
+
+            // Once the task completes, control is transferred to the awaiting coroutine, if there is one.
+            struct final_awaiter {
+                bool await_ready(void) noexcept { return false; }
+                void await_resume(void) noexcept {}
+
+                template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    auto continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+            };
+
+            final_awaiter final_suspend(void) noexcept { return {}; }
+
+
+            void unhandled_exception(void) {
+                exception = std::current_exception();
+            }
+        };
+
+
+        template <typename T> struct task_promise : task_promise_base {
+            std::optional<T> value;
+
+            task<T> get_return_object(void);
+            template <typename U> void return_value(U&& result) { value.emplace(fwd(result)); }
+        };
+
+        template <> struct task_promise<void> : task_promise_base {
+            task<void> get_return_object(void);
+            void return_void(void) {}
+        };
+
+
+        // Eagerly started coroutine that destroys itself once it completes. Used to start tasks from non-coroutine code.
+        struct detached_coroutine {
+            struct promise_type {
+                detached_coroutine get_return_object(void) { return {}; }
+                std::suspend_never initial_suspend(void) noexcept { return {}; }
+                std::suspend_never final_suspend(void) noexcept { return {}; }
+                void return_void(void) {}
+                void unhandled_exception(void) { std::terminate(); }
+            };
+        };
+
+
+        template <typename T> struct task_awaiter {
+            std::coroutine_handle<task_promise<T>> handle;
+
+            bool await_ready(void) const noexcept { return false; }
+
+            template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+                auto& promise = handle.promise();
+                promise.continuation = awaiting;
+
+                if constexpr (requires { awaiting.promise().token; }) {
+                    if (!promise.token) promise.token = awaiting.promise().token;
+                }
+
+                return handle;
+            }
+
+            T await_resume(void) {
+                auto& promise = handle.promise();
+                if (promise.exception) std::rethrow_exception(promise.exception);
+
+                if constexpr (!std::is_void_v<T>) return std::move(*promise.value);
+            }
+        };
+
+
+        struct main_thread_awaiter {
+            job_priority priority;
+
+            bool await_ready(void) const noexcept {
+                return thread_pool::instance().is_main_thread();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) const {
+                thread_pool::instance().invoke_on_main([handle] { handle.resume(); }, priority);
+            }
+
+            void await_resume(void) const noexcept {}
+        };
+
+
+        struct worker_thread_awaiter {
+            job_priority priority;
+
+            bool await_ready(void) const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) const {
+                thread_pool::instance().invoke_on_thread([handle] { handle.resume(); }, priority);
+            }
+
+            void await_resume(void) const noexcept {}
+        };
+
+
+        struct cancellation_awaiter {
+            bool cancelled = false;
+
+            bool await_ready(void) const noexcept { return false; }
+
+            template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                const auto& token = handle.promise().token;
+                cancelled = token && token->is_cancelled();
+
+                // Returning false resumes the task immediately.
+                return false;
+            }
+
+            void await_resume(void) const {
+                if (cancelled) throw task_cancelled { };
+            }
+        };
+
+
+        template <typename T> struct job_awaiter {
+            job_handle<T> job;
+
+            bool await_ready(void) const { return job.is_done(); }
+
+            void await_suspend(std::coroutine_handle<> handle) const {
+                job.on_complete([handle] { handle.resume(); });
+            }
+
+            decltype(auto) await_resume(void) const {
+                return job.get();
+            }
+        };
+    }
+
+
+    // Lazily started coroutine producing a value of type T.
+    // Tasks can be awaited from other tasks, in which case the awaiting task is resumed on the thread that completes the task,
+    // or started from non-coroutine code with spawn.
+    // Tasks can move between threads using co_await resume_on_main() and co_await resume_on_worker(priority),
+    // so work that has to finish on the main thread does not block a worker while it waits.
+    template <typename T> class [[nodiscard]] task {
+    public:
+        using promise_type = detail::task_promise<T>;
+        using handle_type  = std::coroutine_handle<promise_type>;
+        using value_type   = T;
+
+
+        explicit task(handle_type handle) : handle(handle) {}
+        ve_swap_move_only(task, handle);
+
+        ~task(void) {
+            if (handle) handle.destroy();
+        }
+
+
+        // Tasks started with this token can be cancelled through it. Cancellation is checked with co_await yield_if_cancelled().
+        // Tasks awaited from a cancellable task inherit its token, unless they have one of their own.
+        task&& with_cancellation(cancellation_token token) && {
+            handle.promise().token = std::move(token);
+            return std::move(*this);
+        }
+
+
+        auto operator co_await(void) && noexcept {
+            return detail::task_awaiter<T> { handle };
+        }
+    private:
+        handle_type handle = nullptr;
+    };
+
+
+    namespace detail {
+        template <typename T> inline task<T> task_promise<T>::get_return_object(void) {
+            return task<T> { std::coroutine_handle<task_promise<T>>::from_promise(*this) };
+        }
+
+        inline task<void> task_promise<void>::get_return_object(void) {
+            return task<void> { std::coroutine_handle<task_promise<void>>::from_promise(*this) };
+        }
+
+
+        template <typename T> inline detached_coroutine run_detached(task<T> started, shared<job_state<T>> state) {
+            std::exception_ptr error = nullptr;
+
+            try {
+                if constexpr (std::is_void_v<T>) co_await std::move(started);
+                else state->value.emplace(co_await std::move(started));
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // Completion is kept outside of the try block, so an exception from a completion callback can't complete the state twice.
+            state->complete(error);
+        }
+    }
+
+
+    // Starts the given task on the calling thread and returns a handle that can be used to await it from non-coroutine code.
+    // The task runs on the calling thread until it first switches threads (e.g. through resume_on_worker).
+    template <typename T> inline job_handle<T> spawn(task<T> started) {
+        auto state = make_shared<detail::job_state<T>>(job_priority::GENERATION);
+        detail::run_detached(std::move(started), state);
+
+        return job_handle<T> { std::move(state) };
+    }
+
+
+    // Continues the current task on the main thread, using the given priority lane. Does not suspend if the task is already on the main thread.
+    inline detail::main_thread_awaiter resume_on_main(job_priority priority = job_priority::GENERATION) {
+        return { priority };
+    }
+
+
+    // Continues the current task on a worker thread, using the given priority lane.
+    inline detail::worker_thread_awaiter resume_on_worker(job_priority priority = job_priority::GENERATION) {
+        return { priority };
+    }
+
+
+    // Throws task_cancelled if the current task has been cancelled through its cancellation_token. Never suspends.
+    inline detail::cancellation_awaiter yield_if_cancelled(void) {
+        return { };
+    }
+
+
+    // Allows job handles to be awaited from tasks. The task is resumed on the thread that completes the job.
+    template <typename T> inline detail::job_awaiter<T> operator co_await(const job_handle<T>& job) {
+        return { job };
+    }
+}
\ No newline at end of file
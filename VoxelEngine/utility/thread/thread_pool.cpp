@@ -6,4 +6,176 @@ namespace ve {
         static thread_pool i;
         return i;
     }
+
+
+    thread_pool::thread_pool(std::size_t num_workers) {
+        worker_queues.reserve(num_workers);
+        for (std::size_t i = 0; i < num_workers; ++i) worker_queues.push_back(make_unique<job_queue>());
+
+        workers.reserve(num_workers);
+        for (std::size_t i = 0; i < num_workers; ++i) workers.emplace_back([this, i] { worker_main(i); });
+    }
+
+
+    thread_pool::~thread_pool(void) {
+        // Finish any remaining tasks.
+        exiting = true;
+        wake(true);
+
+        for (auto& worker : workers) worker.join();
+        main_executor.execute();
+    }
+
+
+    void thread_pool::push_job(detail::job_ptr job, job_priority priority) {
+        const auto lane = (std::size_t) priority;
+        auto& queue     = (worker_index < worker_queues.size()) ? *worker_queues[worker_index] : injection_queue;
+
+        {
+            std::lock_guard lock { queue.mtx };
+
+            queue.jobs[lane].push_back(std::move(job));
+            queue.sizes[lane].store(queue.jobs[lane].size(), std::memory_order_relaxed);
+        }
+
+        num_queued.fetch_add(1, std::memory_order_seq_cst);
+        wake(false);
+    }
+
+
+    detail::job_ptr thread_pool::take_job(void) {
+        if (num_queued.load(std::memory_order_acquire) == 0) return nullptr;
+
+
+        auto take = [&] (job_queue& queue, std::size_t lane, bool from_back) -> detail::job_ptr {
+            if (queue.sizes[lane].load(std::memory_order_relaxed) == 0) return nullptr;
+
+            std::lock_guard lock { queue.mtx };
+            auto& jobs = queue.jobs[lane];
+            if (jobs.empty()) return nullptr;
+
+            detail::job_ptr result;
+
+            if (from_back) {
+                result = std::move(jobs.back());
+                jobs.pop_back();
+            } else {
+                result = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            queue.sizes[lane].store(jobs.size(), std::memory_order_relaxed);
+            num_queued.fetch_sub(1, std::memory_order_relaxed);
+
+            return result;
+        };
+
+
+        const bool is_worker = worker_index < worker_queues.size();
+
+        for (std::size_t lane = 0; lane < num_job_priorities; ++lane) {
+            // Own jobs are taken from the back, since they are most likely to still be in cache.
+            if (is_worker) {
+                if (auto job = take(*worker_queues[worker_index], lane, true); job) return job;
+            }
+
+            if (auto job = take(injection_queue, lane, false); job) return job;
+
+            // Jobs are stolen from the front of other queues, starting at the next worker so not every thief targets the same queue.
+            const std::size_t first = is_worker ? worker_index + 1 : 0;
+
+            for (std::size_t i = 0; i < worker_queues.size(); ++i) {
+                auto& victim = *worker_queues[(first + i) % worker_queues.size()];
+                if (auto job = take(victim, lane, false); job) return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+
+    void thread_pool::run_job(detail::job_ptr job) {
+        num_running.fetch_add(1, std::memory_order_relaxed);
+        job->run();
+
+        // Workers can only exit once no more jobs are running, since a running job may submit new jobs.
+        if (num_running.fetch_sub(1, std::memory_order_acq_rel) == 1 && exiting) [[unlikely]] wake(true);
+    }
+
+
+    bool thread_pool::try_run_one(void) {
+        if (auto job = take_job(); job) {
+            run_job(std::move(job));
+            return true;
+        }
+
+        return false;
+    }
+
+
+    void thread_pool::worker_main(std::size_t index) {
+        worker_index = index;
+
+        while (true) {
+            if (try_run_one()) continue;
+
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            const u32 current_epoch = epoch.load(std::memory_order_seq_cst);
+
+            const bool has_jobs  = num_queued.load(std::memory_order_seq_cst) > 0;
+            const bool can_exit  = exiting && !has_jobs && num_running.load(std::memory_order_seq_cst) == 0;
+
+            if (!has_jobs && !can_exit) epoch.wait(current_epoch, std::memory_order_seq_cst);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+            if (can_exit) return;
+        }
+    }
+
+
+    void main_thread_executor::execute(nanoseconds budget) {
+        const auto start    = steady_clock::now();
+        const auto deadline = (budget >= steady_clock::time_point::max() - start) ? steady_clock::time_point::max() : start + budget;
+
+        statistics stats;
+        nanoseconds total_latency = 0ns;
+
+        auto now = start;
+
+        do {
+            auto task = take_task();
+            if (!task) break;
+
+            const auto latency = std::max(now - task->queued_at, nanoseconds { 0 });
+            total_latency += latency;
+            stats.max_latency = std::max(stats.max_latency, latency);
+            ++stats.num_executed;
+
+            task->job->run();
+            now = steady_clock::now();
+        } while (now < deadline);
+
+        stats.time_spent   = now - start;
+        stats.mean_latency = stats.num_executed ? total_latency / i64(stats.num_executed) : 0ns;
+        last_execution     = stats;
+    }
+
+
+    std::optional<main_thread_executor::queued_task> main_thread_executor::take_task(void) {
+        for (std::size_t lane = 0; lane < num_job_priorities; ++lane) {
+            if (sizes[lane].load(std::memory_order_relaxed) == 0) continue;
+
+            std::lock_guard lock { mtx };
+            auto& queue = tasks[lane];
+            if (queue.empty()) continue;
+
+            auto result = std::move(queue.front());
+            queue.pop_front();
+            sizes[lane].store(queue.size(), std::memory_order_relaxed);
+
+            return result;
+        }
+
+        return std::nullopt;
+    }
 }
\ No newline at end of file
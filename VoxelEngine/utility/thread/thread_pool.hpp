@@ -4,90 +4,500 @@
 #include <VoxelEngine/utility/assert.hpp>
 #include <VoxelEngine/utility/traits/function_traits.hpp>
 
-#include <boost/asio.hpp>
-#include <VoxelEngine/core/windows_header_cleanup.hpp>
-
 #include <thread>
 #include <mutex>
 #include <future>
-#include <condition_variable>
-#include <queue>
+#include <atomic>
+#include <deque>
 
 
 namespace ve {
+    class thread_pool;
+    template <typename T> class job_handle;
+
+
+    // Jobs are executed in order of priority: workers always take a job from the highest priority lane that has any jobs queued.
+    // Within a lane, workers execute their own jobs in LIFO order and steal jobs from other workers in FIFO order.
+    enum class job_priority : u8 { MESH, NETWORK, GENERATION, BACKGROUND_IO };
+    constexpr inline std::size_t num_job_priorities = 4;
+
+
+    namespace detail {
+        struct job_base {
+            virtual ~job_base(void) = default;
+            virtual void run(void) = 0;
+        };
+
+        template <typename F> struct job_impl final : job_base {
+            F fn;
+
+            explicit job_impl(F fn) : fn(std::move(fn)) {}
+            void run(void) override { std::invoke(fn); }
+        };
+
+
+        // Jobs are type-erased into a move-only wrapper, since tasks like std::packaged_task are not copyable.
+        using job_ptr = unique<job_base>;
+
+        template <typename F> inline job_ptr make_job(F&& fn) {
+            return make_unique<job_impl<std::decay_t<F>>>(fwd(fn));
+        }
+
+
+        // Shared state of a job_handle. Callbacks are invoked on the thread that completes the job, once it has completed.
+        struct job_state_base {
+            std::atomic_bool done = false;
+            std::atomic<u32> waiters = 0;
+            std::exception_ptr exception = nullptr;
+            job_priority priority;
+
+            std::mutex mtx;
+            std::vector<job_ptr> callbacks;
+
+
+            explicit job_state_base(job_priority priority) : priority(priority) {}
+
+
+            // Invokes the callback once the job is done, or immediately if it already is.
+            void add_callback(job_ptr callback) {
+                {
+                    std::lock_guard lock { mtx };
+
+                    if (!done.load(std::memory_order_relaxed)) {
+                        callbacks.push_back(std::move(callback));
+                        return;
+                    }
+                }
+
+                callback->run();
+            }
+
+
+            inline void complete(std::exception_ptr error = nullptr);
+        };
+
+
+        template <typename T> struct job_state : job_state_base {
+            using job_state_base::job_state_base;
+            std::optional<T> value;
+
+            // Completion is kept outside of the try block, so an exception from a callback can't complete the state twice.
+            template <typename F> void run(F&& fn) {
+                std::exception_ptr error = nullptr;
+
+                try {
+                    value.emplace(std::invoke(fn));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                complete(error);
+            }
+        };
+
+        template <> struct job_state<void> : job_state_base {
+            using job_state_base::job_state_base;
+
+            template <typename F> void run(F&& fn) {
+                std::exception_ptr error = nullptr;
+
+                try {
+                    std::invoke(fn);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                complete(error);
+            }
+        };
+
+
+        template <typename T, typename F> struct continuation_result { using type = std::invoke_result_t<F&, T&>; };
+        template <typename F> struct continuation_result<void, F> { using type = std::invoke_result_t<F&>; };
+    }
+
+
+    // Handle to a job submitted to the thread pool, which can be used to await the job, get its result or schedule continuations.
+    // Handles are cheap to copy and all copies refer to the same job.
+    template <typename T> class job_handle {
+    public:
+        using value_type = T;
+
+
+        job_handle(void) = default;
+        explicit job_handle(shared<detail::job_state<T>> state) : state(std::move(state)) {}
+
+
+        bool is_done(void) const {
+            return state->done.load(std::memory_order_acquire);
+        }
+
+
+        // Waits for the job to complete. While waiting, the calling thread executes other jobs from the pool,
+        // so awaiting a job from within another job never blocks a worker.
+        inline void wait(void) const;
+
+
+        // Waits for the job to complete and returns its result. If the job threw an exception, it is rethrown.
+        decltype(auto) get(void) const {
+            wait();
+            if (state->exception) std::rethrow_exception(state->exception);
+
+            if constexpr (!std::is_void_v<T>) return (*state->value);
+        }
+
+
+        // Schedules fn to be run once this job has completed, with the result of this job as its argument (if it has any).
+        // If this job threw an exception, the continuation is not invoked and the exception is propagated to the returned handle instead.
+        // By default, the continuation has the same priority as this job.
+        template <typename F> auto then(F&& fn) const {
+            return then(fwd(fn), state->priority);
+        }
+
+        template <typename F> inline auto then(F&& fn, job_priority priority) const;
+
+
+        // Invokes fn on the thread that completes the job once it has completed, or immediately if it already has.
+        // Unlike then, fn is not scheduled as a separate job, so it should be cheap.
+        template <typename F> void on_complete(F&& fn) const {
+            state->add_callback(detail::make_job(fwd(fn)));
+        }
+    private:
+        template <typename U> friend class job_handle;
+        template <typename... Ts> friend job_handle<void> when_all(const job_handle<Ts>&...);
+        template <typename U> friend job_handle<void> when_all(const std::vector<job_handle<U>>&);
+
+        shared<detail::job_state<T>> state;
+    };
+
+
+    // Queue of tasks that must run on the main thread. Tasks are executed in order of priority,
+    // and execution stops once the time budget for the current frame is used up, in which case the remaining tasks are carried over to the next frame.
+    // Tasks can be queued from any thread, but execute must only be called from the main thread.
+    class main_thread_executor {
+    public:
+        struct statistics {
+            // Number of tasks in each lane that are still queued.
+            std::array<std::size_t, num_job_priorities> queue_depth { };
+            // Number of tasks executed and time spent during the last call to execute.
+            std::size_t num_executed = 0;
+            nanoseconds time_spent   = 0ns;
+            // Time between queueing and executing, for the tasks executed during the last call to execute.
+            nanoseconds mean_latency = 0ns, max_latency = 0ns;
+        };
+
+
+        main_thread_executor(void) = default;
+        ve_immovable(main_thread_executor);
+
+
+        template <typename Task>
+        void post(Task&& task, job_priority priority = job_priority::GENERATION) {
+            const auto lane = (std::size_t) priority;
+            std::lock_guard lock { mtx };
+
+            tasks[lane].push_back(queued_task { detail::make_job(fwd(task)), steady_clock::now() });
+            sizes[lane].store(tasks[lane].size(), std::memory_order_relaxed);
+        }
+
+
+        // Executes queued tasks until there are none left or the budget is used up. Tasks queued while executing are executed as well.
+        // At least one task is executed if any are queued, so the queue makes progress even if a single task exceeds the budget.
+        void execute(nanoseconds budget = nanoseconds::max());
+
+
+        std::size_t size(void) const {
+            std::size_t result = 0;
+            for (const auto& size : sizes) result += size.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+
+        statistics get_statistics(void) const {
+            statistics result = last_execution;
+            for (std::size_t i = 0; i < num_job_priorities; ++i) result.queue_depth[i] = sizes[i].load(std::memory_order_relaxed);
+
+            return result;
+        }
+    private:
+        struct queued_task {
+            detail::job_ptr job;
+            steady_clock::time_point queued_at;
+        };
+
+        std::mutex mtx;
+        std::array<std::deque<queued_task>, num_job_priorities> tasks;
+        std::array<std::atomic<std::size_t>, num_job_priorities> sizes { };
+
+        statistics last_execution;
+
+
+        std::optional<queued_task> take_task(void);
+    };
+
+
+    // Work-stealing pool of worker threads, with a separate lane for tasks that must run on the main thread.
+    // There is one worker per hardware thread, minus one for the main thread.
     class thread_pool {
     public:
         static thread_pool& instance(void);
-        
-            
-        ~thread_pool(void) {
-            // Finish any remaining tasks.
-            pool.join();
-            main_thread_ctx.run();
-        }
-        
-        
+
+        ~thread_pool(void);
+        ve_immovable(thread_pool);
+
+
+        // Submits a job to the pool and returns a handle to it.
         template <typename Task>
-        void invoke_on_thread(Task&& task) {
-            boost::asio::post(pool, fwd(task));
+        auto submit(Task&& task, job_priority priority = job_priority::GENERATION) {
+            using result_t = std::invoke_result_t<std::decay_t<Task>&>;
+
+            auto state = make_shared<detail::job_state<result_t>>(priority);
+            push_job(detail::make_job([state, task = fwd(task)] () mutable { state->run(task); }), priority);
+
+            return job_handle<result_t> { std::move(state) };
         }
-    
+
+
+        template <typename Task>
+        void invoke_on_thread(Task&& task, job_priority priority = job_priority::GENERATION) {
+            push_job(detail::make_job(fwd(task)), priority);
+        }
+
         template <typename Task>
-        auto invoke_on_thread_with_future(Task&& task) {
+        auto invoke_on_thread_with_future(Task&& task, job_priority priority = job_priority::GENERATION) {
             using task_t = std::packaged_task<typename meta::function_traits<Task>::signature>;
-            return boost::asio::post(pool, task_t { fwd(task) });
+
+            task_t packaged { fwd(task) };
+            auto future = packaged.get_future();
+
+            invoke_on_thread(std::move(packaged), priority);
+            return future;
         }
-    
+
+        // Note: rather than blocking, the calling thread executes other jobs until the task is done.
         template <typename Task>
-        void invoke_on_thread_and_await(Task&& task) {
-            invoke_on_thread_with_future(fwd(task)).wait();
+        void invoke_on_thread_and_await(Task&& task, job_priority priority = job_priority::GENERATION) {
+            submit(fwd(task), priority).wait();
         }
-        
-    
+
+
+        // Main thread tasks are executed once per tick, in order of priority, for at most the main thread budget.
         template <typename Task>
-        void invoke_on_main(Task&& task) {
-            boost::asio::post(main_thread_ctx, fwd(task));
+        void invoke_on_main(Task&& task, job_priority priority = job_priority::GENERATION) {
+            main_executor.post(fwd(task), priority);
         }
-        
+
         template <typename Task>
-        auto invoke_on_main_with_future(Task&& task) {
+        auto invoke_on_main_with_future(Task&& task, job_priority priority = job_priority::GENERATION) {
             using task_t = std::packaged_task<typename meta::function_traits<Task>::signature>;
-            return boost::asio::post(main_thread_ctx, task_t { fwd(task) });
+
+            task_t packaged { fwd(task) };
+            auto future = packaged.get_future();
+
+            invoke_on_main(std::move(packaged), priority);
+            return future;
         }
-    
+
+        // Note: when called from a worker, the worker executes other jobs until the main thread has run the task.
         template <typename Task>
-        void invoke_on_main_and_await(Task&& task) {
+        void invoke_on_main_and_await(Task&& task, job_priority priority = job_priority::GENERATION) {
             VE_ASSERT(!is_main_thread(), "Cannot await main thread on main thread!");
-            invoke_on_main_with_future(fwd(task)).wait();
+
+            auto state = make_shared<detail::job_state<void>>(priority);
+            invoke_on_main([state, task = fwd(task)] () mutable { state->run(task); }, priority);
+
+            job_handle<void> { std::move(state) }.wait();
         }
 
         // Similar to above, but if we're already on the main thread, the task is executed immediately.
         template <typename Task>
-        void invoke_on_main_or_run(Task&& task) {
+        void invoke_on_main_or_run(Task&& task, job_priority priority = job_priority::GENERATION) {
             if (is_main_thread()) {
                 std::invoke(task);
             } else {
-                invoke_on_main_with_future(fwd(task)).wait();
+                invoke_on_main_and_await(fwd(task), priority);
             }
         }
 
+
+        // Executes a single queued job on the calling thread, if there is one. Returns true if a job was executed.
+        bool try_run_one(void);
+
+
+        // Executes queued jobs on the calling thread until the predicate returns true.
+        // The thread only sleeps if there are no jobs to execute, and is woken when new jobs are submitted or a job with waiters completes.
+        template <typename Pred> void help_until(Pred pred) {
+            while (!pred()) {
+                if (try_run_one()) continue;
+
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                const u32 current_epoch = epoch.load(std::memory_order_seq_cst);
+
+                if (!pred() && num_queued.load(std::memory_order_seq_cst) == 0) epoch.wait(current_epoch, std::memory_order_seq_cst);
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+
         bool is_main_thread(void) const {
             return std::this_thread::get_id() == main_thread_id;
         }
+
+        std::size_t get_num_workers(void) const {
+            return workers.size();
+        }
+
+        // Number of jobs waiting to be picked up by a worker. Jobs that are currently running are not included.
+        std::size_t get_num_queued(void) const {
+            return num_queued.load(std::memory_order_relaxed);
+        }
+
+
+        // Maximum time spent executing main thread tasks per tick. Tasks that don't fit within the budget are carried over to the next tick.
+        void set_main_thread_budget(nanoseconds budget) {
+            main_thread_budget.store(budget, std::memory_order_relaxed);
+        }
+
+        nanoseconds get_main_thread_budget(void) const {
+            return main_thread_budget.load(std::memory_order_relaxed);
+        }
+
+        main_thread_executor::statistics get_main_thread_statistics(void) const {
+            return main_executor.get_statistics();
+        }
     private:
+        template <typename T> friend class job_handle;
+        friend struct detail::job_state_base;
+
+
+        // Queues are locked separately for every worker, so workers only contend with each other when stealing.
+        // Sizes are tracked atomically, so empty lanes can be skipped without locking them.
+        struct alignas(64) job_queue {
+            std::mutex mtx;
+            std::array<std::deque<detail::job_ptr>, num_job_priorities> jobs;
+            std::array<std::atomic<std::size_t>, num_job_priorities> sizes { };
+        };
+
+
         const static inline auto main_thread_id = std::this_thread::get_id();
-        
-        boost::asio::thread_pool pool;
-        boost::asio::io_context main_thread_ctx;
-        
-        
-        explicit thread_pool(std::size_t num_workers = std::max(32u, std::thread::hardware_concurrency()))
-            : pool(num_workers) {}
-        
-        
+        static inline thread_local std::size_t worker_index = max_value<std::size_t>;
+
+        std::vector<unique<job_queue>> worker_queues;
+        // Jobs submitted from outside the pool are queued here, since the submitting thread has no queue of its own.
+        job_queue injection_queue;
+        std::vector<std::thread> workers;
+
+        std::atomic<std::size_t> num_queued = 0, num_running = 0;
+        std::atomic<u32> epoch = 0, sleepers = 0;
+        std::atomic_bool exiting = false;
+
+        main_thread_executor main_executor;
+        std::atomic<nanoseconds> main_thread_budget = nanoseconds { 4ms };
+
+
+        explicit thread_pool(std::size_t num_workers = std::max<i64>(1, i64(std::thread::hardware_concurrency()) - 1));
+
+
+        void push_job(detail::job_ptr job, job_priority priority);
+        detail::job_ptr take_job(void);
+        void worker_main(std::size_t index);
+        void run_job(detail::job_ptr job);
+
+
+        // Wakes sleeping workers and threads waiting for a job.
+        void wake(bool all) {
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+
+            if (sleepers.load(std::memory_order_seq_cst) > 0) {
+                if (all) epoch.notify_all();
+                else epoch.notify_one();
+            }
+        }
+
+
         friend class engine;
         void execute_main_thread_tasks(void) {
-            main_thread_ctx.run();
+            main_executor.execute(get_main_thread_budget());
         }
     };
+
+
+    namespace detail {
+        inline void job_state_base::complete(std::exception_ptr error) {
+            std::vector<job_ptr> ready_callbacks;
+
+            {
+                std::lock_guard lock { mtx };
+
+                exception = std::move(error);
+                done.store(true, std::memory_order_seq_cst);
+                ready_callbacks = std::move(callbacks);
+            }
+
+            for (auto& callback : ready_callbacks) callback->run();
+            if (waiters.load(std::memory_order_seq_cst) > 0) thread_pool::instance().wake(true);
+        }
+    }
+
+
+    template <typename T> inline void job_handle<T>::wait(void) const {
+        if (is_done()) return;
+
+        state->waiters.fetch_add(1, std::memory_order_seq_cst);
+        thread_pool::instance().help_until([&] { return is_done(); });
+        state->waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+
+    template <typename T> template <typename F> inline auto job_handle<T>::then(F&& fn, job_priority priority) const {
+        using result_t = typename detail::continuation_result<T, std::decay_t<F>>::type;
+        auto next = make_shared<detail::job_state<result_t>>(priority);
+
+        auto continuation = [prev = state, next, fn = fwd(fn)] () mutable {
+            if (prev->exception) return next->complete(prev->exception);
+
+            if constexpr (std::is_void_v<T>) next->run(fn);
+            else next->run([&] { return std::invoke(fn, *prev->value); });
+        };
+
+        state->add_callback(detail::make_job([continuation = std::move(continuation), priority] () mutable {
+            thread_pool::instance().push_job(detail::make_job(std::move(continuation)), priority);
+        }));
+
+        return job_handle<result_t> { std::move(next) };
+    }
+
+
+    // Returns a handle to a job that completes once all the given jobs have completed.
+    // Exceptions are not propagated: use get on the individual handles to get their results or exceptions.
+    template <typename... Ts> inline job_handle<void> when_all(const job_handle<Ts>&... handles) {
+        auto state     = make_shared<detail::job_state<void>>(job_priority::GENERATION);
+        // One extra count prevents the job from completing before all callbacks have been added.
+        auto remaining = make_shared<std::atomic<std::size_t>>(sizeof...(Ts) + 1);
+
+        auto on_done = [state, remaining] {
+            if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) state->complete();
+        };
+
+        (handles.state->add_callback(detail::make_job(on_done)), ...);
+        on_done();
+
+        return job_handle<void> { std::move(state) };
+    }
+
+
+    template <typename T> inline job_handle<void> when_all(const std::vector<job_handle<T>>& handles) {
+        auto state     = make_shared<detail::job_state<void>>(job_priority::GENERATION);
+        auto remaining = make_shared<std::atomic<std::size_t>>(handles.size() + 1);
+
+        auto on_done = [state, remaining] {
+            if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) state->complete();
+        };
+
+        for (const auto& handle : handles) handle.state->add_callback(detail::make_job(on_done));
+        on_done();
+
+        return job_handle<void> { std::move(state) };
+    }
 }
\ No newline at end of file
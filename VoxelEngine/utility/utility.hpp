@@ -11,6 +11,7 @@
 #include <VoxelEngine/utility/bimap.hpp>
 #include <VoxelEngine/utility/bind_return.hpp>
 #include <VoxelEngine/utility/bit.hpp>
+#include <VoxelEngine/utility/buffer_pool.hpp>
 #include <VoxelEngine/utility/cache.hpp>
 #include <VoxelEngine/utility/color.hpp>
 #include <VoxelEngine/utility/compression.hpp>
@@ -28,13 +29,17 @@
 #include <VoxelEngine/utility/io/image.hpp>
 #include <VoxelEngine/utility/io/paths.hpp>
 #include <VoxelEngine/utility/io/serialize/binary_serializable.hpp>
+#include <VoxelEngine/utility/io/serialize/byte_stream.hpp>
 #include <VoxelEngine/utility/io/serialize/container_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/decomposable_serializer.hpp>
+#include <VoxelEngine/utility/io/serialize/delta_serializer.hpp>
+#include <VoxelEngine/utility/io/serialize/fixed_layout_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/overloadable_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/push_serializer.hpp>
 #include <VoxelEngine/utility/io/serialize/variable_length_encoder.hpp>
 #include <VoxelEngine/utility/logger.hpp>
 #include <VoxelEngine/utility/math.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
 #include <VoxelEngine/utility/noise.hpp>
 #include <VoxelEngine/utility/performance_timer.hpp>
 #include <VoxelEngine/utility/priority.hpp>
@@ -48,6 +53,8 @@
 #include <VoxelEngine/utility/then.hpp>
 #include <VoxelEngine/utility/thread/assert_main_thread.hpp>
 #include <VoxelEngine/utility/thread/dummy_mutex.hpp>
+#include <VoxelEngine/utility/thread/spsc_queue.hpp>
+#include <VoxelEngine/utility/thread/task.hpp>
 #include <VoxelEngine/utility/thread/thread_id.hpp>
 #include <VoxelEngine/utility/thread/thread_pool.hpp>
 #include <VoxelEngine/utility/thread/threadsafe_counter.hpp>
@@ -4,6 +4,7 @@
 #include <VoxelEngine/voxel/chunk/generator/generator.hpp>
 #include <VoxelEngine/voxel/chunk/chunk_mesher.hpp>
 #include <VoxelEngine/utility/functional.hpp>
+#include <VoxelEngine/utility/metrics/metrics.hpp>
 #include <VoxelEngine/utility/thread/thread_pool.hpp>
 #include <VoxelEngine/voxel/tile/tiles.hpp>
 
@@ -50,40 +51,31 @@ namespace ve::voxel {
     }
 
 
-    void voxel_space::update_meshes(void) {
-        VE_PROFILE_FN("Dispatching Mesh Update Tasks");
+    void voxel_space::toggle_meshing(bool enabled) {
+        if (std::exchange(do_meshing, enabled) == enabled) return;
 
 
-        // TODO: Convert to coroutine and allow task to be cancelled if a newer mesh task is launched.
-        // (E.g. co_yield after every n tiles or something similar.)
-        struct mesh_task {
-            std::optional<chunk_locker> locker;
-            chunk_neighbourhood neighbourhood;
-            tilepos chunkpos;
-            u64 task_id;
+        if (enabled) {
+            vertex_buffer = detail::buffer_t::create();
 
-            void operator()(void) {
-                VE_PROFILE_WORKER_THREAD("Updating Mesh");
-                auto mesh = mesh_chunk(neighbourhood, chunkpos);
+            for (auto& [pos, chunk_data] : chunks) {
+                create_chunk_buffer(pos, chunk_data);
+                chunk_data.mesh_status = per_chunk_data::NEEDS_MESHING;
+            }
+        } else {
+            // Mesh tasks that have already started will discard their result, since the chunk no longer has a buffer.
+            for (auto& [pos, chunk_data] : chunks) {
+                chunk_data.mesh_cancellation.cancel();
+                chunk_data.subbuffer = nullptr;
+            }
 
-                thread_pool::instance().invoke_on_main_and_await([&] {
-                    VE_PROFILE_FN("Synchronizing Mesh");
-                    auto& chunk_data = locker->get_space()->chunks[chunkpos];
+            vertex_buffer = nullptr;
+        }
+    }
 
-                    // If there was a new mesh task launched after this one we need to discard the result.
-                    // TODO: This wouldn't be necessary if we could cancel the task.
-                    if (chunk_data.most_recent_mesh_task == task_id) {
-                        chunk_data.subbuffer->store_mesh(std::move(mesh));
-                        chunk_data.mesh_status = per_chunk_data::MESHED;
 
-                        locker->get_space()->dispatch_event(chunk_remeshed_event { locker->get_space().get(), chunkpos });
-                    }
-
-                    --(*locker->get_space()->ongoing_mesh_tasks);
-                    locker = std::nullopt;
-                });
-            }
-        };
+    void voxel_space::update_meshes(void) {
+        VE_PROFILE_FN("Dispatching Mesh Update Tasks");
 
 
         // TODO: Account for loading priority when first meshing chunks.
@@ -108,17 +100,74 @@ namespace ve::voxel {
                 }
 
 
-                thread_pool::instance().invoke_on_thread(mesh_task {
-                    .locker        = chunk_locker { shared_from_this(), std::move(positions) },
-                    .neighbourhood = chunk_neighbourhood { chunk_data.chunk.get(), neighbours },
-                    .chunkpos      = pos,
-                    .task_id       = ++chunk_data.most_recent_mesh_task
-                });
+                // A newer mesh task makes the result of any older ones obsolete, so they can be cancelled if they haven't started yet.
+                chunk_data.mesh_cancellation.cancel();
+                chunk_data.mesh_cancellation = cancellation_token { };
+
+                ++(*ongoing_mesh_tasks);
+
+                auto mesh_task = mesh_chunk_async(
+                    chunk_locker { shared_from_this(), std::move(positions) },
+                    chunk_neighbourhood { chunk_data.chunk.get(), neighbours },
+                    pos,
+                    ++chunk_data.most_recent_mesh_task
+                );
+
+                spawn(std::move(mesh_task).with_cancellation(chunk_data.mesh_cancellation));
             }
         }
     }
 
 
+    // Meshes the chunk on a worker, then stores the mesh and releases the chunks on the main thread.
+    // The worker is not blocked while waiting for the main thread, since the task is simply resumed there.
+    task<> voxel_space::mesh_chunk_async(chunk_locker locker, chunk_neighbourhood neighbourhood, tilepos chunkpos, u32 task_id) {
+        co_await resume_on_worker(job_priority::MESH);
+
+        std::optional<tile_mesh> mesh = std::nullopt;
+
+        try {
+            co_await yield_if_cancelled();
+
+            VE_PROFILE_WORKER_THREAD("Updating Mesh");
+            VE_METRIC_TIMER("ve_chunk_mesh_seconds", "Time taken to mesh a chunk.");
+            mesh = mesh_chunk(neighbourhood, chunkpos);
+        } catch (const task_cancelled&) {}
+
+
+        // The locker must be released on the main thread as well, so this is done even if the task was cancelled.
+        co_await resume_on_main(job_priority::MESH);
+        VE_PROFILE_FN("Synchronizing Mesh");
+
+        auto space = locker.get_space();
+        auto& chunk_data = space->chunks[chunkpos];
+
+        // If there was a new mesh task launched after this one we need to discard the result.
+        if (mesh && chunk_data.subbuffer && chunk_data.most_recent_mesh_task == task_id) {
+            chunk_data.subbuffer->store_mesh(std::move(*mesh));
+            chunk_data.mesh_status = per_chunk_data::MESHED;
+
+            VE_METRIC_COUNTER("ve_chunks_meshed_total", "Number of chunk meshes stored.").add();
+
+            space->dispatch_event(chunk_remeshed_event { space.get(), chunkpos });
+        }
+
+        --(*space->ongoing_mesh_tasks);
+    }
+
+
+    void voxel_space::create_chunk_buffer(const tilepos& where, per_chunk_data& chunk_data) {
+        chunk_data.subbuffer = detail::subbuffer_t::create();
+        chunk_data.handle    = vertex_buffer->insert(chunk_data.subbuffer);
+
+        chunk_data.subbuffer->set_uniform_value<mat4f>(
+            "transform",
+            glm::translate(glm::identity<mat4f>(), vec3f { where * tilepos { voxel_settings::chunk_size } }),
+            gfx::combine_functions::multiply
+        );
+    }
+
+
     const tile_data& voxel_space::get_data(const tilepos& where) const {
         if (auto it = chunks.find(to_chunkpos(where)); it != chunks.end()) {
             return it->second.chunk->get_data(to_localpos(where));
@@ -130,6 +179,36 @@ namespace ve::voxel {
 
 
     tile_data voxel_space::set_data(const tilepos& where, const tile_data& td) {
+        if (auto old_data = store_data(where, td); old_data) {
+            dispatch_event(voxel_changed_event { this, where, *old_data, td });
+            return *old_data;
+        } else {
+            const static auto td_unknown = voxel_settings::get_tile_registry().get_default_state(tiles::TILE_UNKNOWN);
+            return td_unknown;
+        }
+    }
+
+
+    void voxel_space::set_data_batch(std::span<const std::pair<tilepos, tile_data>> changes) {
+        // Only collect events if anyone is listening, so bulk edits don't allocate otherwise.
+        const bool has_listeners = has_handlers_for<voxel_changed_event>();
+
+        std::vector<voxel_changed_event> events;
+        if (has_listeners) events.reserve(changes.size());
+
+
+        for (const auto& [where, td] : changes) {
+            if (auto old_data = store_data(where, td); old_data && has_listeners) {
+                events.push_back(voxel_changed_event { this, where, *old_data, td });
+            }
+        }
+
+
+        dispatch_events(std::span<const voxel_changed_event> { events });
+    }
+
+
+    std::optional<tile_data> voxel_space::store_data(const tilepos& where, const tile_data& td) {
         auto chunkpos = to_chunkpos(where);
 
 
@@ -151,13 +230,10 @@ namespace ve::voxel {
             }
 
 
-            dispatch_event(voxel_changed_event { this, where, old_data, td });
             return old_data;
         } else {
             VE_LOG_WARN("Attempt to set tile in unloaded chunk. Operation will be ignored.");
-
-            const static auto td_unknown = voxel_settings::get_tile_registry().get_default_state(tiles::TILE_UNKNOWN);
-            return td_unknown;
+            return std::nullopt;
         }
     }
 
@@ -192,28 +268,24 @@ namespace ve::voxel {
             it->second.load_count++;
             it->second.load_priority = std::max(it->second.load_priority, priority);
         } else {
-            // Note: actual meshing is performed during the next tick, so if we load multiple chunks at once,
-            // we don't need to mesh them twice.
-            auto buffer = detail::subbuffer_t::create();
-            auto handle = vertex_buffer->insert(buffer);
+            auto generated = [&] {
+                VE_METRIC_TIMER("ve_chunk_generate_seconds", "Time taken to generate a chunk.");
+                return generator->generate(this, where);
+            }();
 
             std::tie(it, std::ignore) = chunks.emplace(
                 where,
                 per_chunk_data {
-                    .chunk                 = generator->generate(this, where),
-                    .subbuffer             = buffer,
-                    .handle                = handle,
+                    .chunk                 = std::move(generated),
                     .mesh_status           = per_chunk_data::NEEDS_MESHING,
                     .load_count            = 1,
                     .load_priority         = priority
                 }
             );
 
-            buffer->set_uniform_value<mat4f>(
-                "transform",
-                glm::translate(glm::identity<mat4f>(), vec3f { where * tilepos { voxel_settings::chunk_size } }),
-                gfx::combine_functions::multiply
-            );
+            // Note: actual meshing is performed during the next tick, so if we load multiple chunks at once,
+            // we don't need to mesh them twice.
+            if (do_meshing) create_chunk_buffer(where, it->second);
 
 
             // Also re-mesh neighbours since we probably don't have to render most of the shared face with this chunk anymore.
@@ -237,7 +309,7 @@ namespace ve::voxel {
             it->second.load_count--;
 
             if (it->second.load_count == 0) {
-                vertex_buffer->erase(it->second.handle);
+                if (it->second.subbuffer) vertex_buffer->erase(it->second.handle);
                 chunks.erase(it);
 
                 // Re-mesh neighbours since we need to start rendering the shared face with this chunk again.
@@ -7,6 +7,7 @@
 #include <VoxelEngine/event/simple_event_dispatcher.hpp>
 #include <VoxelEngine/event/subscribe_only_view.hpp>
 #include <VoxelEngine/utility/priority.hpp>
+#include <VoxelEngine/utility/thread/task.hpp>
 #include <VoxelEngine/utility/traits/evaluate_if_valid.hpp>
 #include <VoxelEngine/utility/traits/null_type.hpp>
 
@@ -62,8 +63,10 @@ namespace ve::voxel {
         };
 
 
-        ve_shared_only(voxel_space, shared<chunk_generator> generator) :
-            vertex_buffer(detail::buffer_t::create())
+        // If meshing is disabled (e.g. on a server), no GPU-side buffers are created, so the space can be used without a graphics context.
+        ve_shared_only(voxel_space, shared<chunk_generator> generator, bool meshing = true) :
+            vertex_buffer(meshing ? detail::buffer_t::create() : nullptr),
+            do_meshing(meshing)
         {
             // chunk_generator is incomplete here, so this must be done in the CPP file.
             init(std::move(generator));
@@ -77,6 +80,8 @@ namespace ve::voxel {
 
         const tile_data& get_data(const tilepos& where) const;
         tile_data set_data(const tilepos& where, const tile_data& td);
+        // Equivalent to calling set_data for every change, but voxel_changed_events are dispatched as a single batch.
+        void set_data_batch(std::span<const std::pair<tilepos, tile_data>> changes);
 
         const chunk* get_chunk(const tilepos& where) const;
         bool is_loaded(const tilepos& chunkpos) const;
@@ -85,8 +90,11 @@ namespace ve::voxel {
         void remove_chunk_loader(const shared<chunk_loader>& loader);
 
 
-        void toggle_meshing(bool enabled) { do_meshing = enabled; }
+        // Disabling meshing releases all GPU-side buffers. They are recreated and all chunks are remeshed if it is enabled again.
+        void toggle_meshing(bool enabled);
+        bool is_meshing_enabled(void) const { return do_meshing; }
 
+        // Null if meshing is disabled.
         VE_GET_CREF(vertex_buffer);
         VE_GET_CREF(chunks);
     private:
@@ -97,6 +105,7 @@ namespace ve::voxel {
             detail::buffer_t::buffer_handle handle;
             enum { NEEDS_MESHING, MESHING, MESHED } mesh_status;
             u32 most_recent_mesh_task = 0;
+            cancellation_token mesh_cancellation;
 
             std::size_t load_count;
             u16 load_priority;
@@ -114,6 +123,9 @@ namespace ve::voxel {
 
         void init(shared<chunk_generator>&& generator);
         void update_meshes(void);
+        void create_chunk_buffer(const tilepos& where, per_chunk_data& chunk_data);
+        std::optional<tile_data> store_data(const tilepos& where, const tile_data& td);
+        static task<> mesh_chunk_async(chunk_locker locker, chunk_neighbourhood neighbourhood, tilepos chunkpos, u32 task_id);
 
         // TODO: Use access facade?
         friend class chunk_loader;
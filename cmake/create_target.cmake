@@ -3,6 +3,7 @@
 function(create_target name type major minor patch)
     file(GLOB_RECURSE sources CONFIGURE DEPENDS LIST_DIRECTORIES false "*.cpp" "*.hpp")
     list(FILTER sources EXCLUDE REGEX "${CMAKE_CURRENT_SOURCE_DIR}\\/tests\\/.*") # Test sources are not part of the target itself.
+    list(FILTER sources EXCLUDE REGEX "${CMAKE_CURRENT_SOURCE_DIR}\\/benchmarks\\/.*") # Neither are benchmark sources.
 
     create_target_from_sources(${name} ${type} ${major} ${minor} ${patch} "${sources}" ${ARGN})
 endfunction()
@@ -47,6 +48,13 @@ function(create_target_from_sources name type major minor patch sources)
     endif()
 
 
+    # A target may also contain a benchmark folder, which is turned into a single benchmark executable.
+    # (But only if ENABLE_BENCHMARKS is set.)
+    if (${ENABLE_BENCHMARKS})
+        create_benchmarks(${name})
+    endif()
+
+
     # On Windows, filter what symbols are exported if this is a shared library and we have a filter file.
     get_platform_name(os)
 
@@ -87,6 +95,37 @@ function (create_tests parent_target)
 endfunction()
 
 
+function (create_benchmarks parent_target)
+    if (NOT ${parent_target} MATCHES "(test|benchmark)_.+" AND EXISTS "${CMAKE_CURRENT_SOURCE_DIR}/benchmarks")
+        file(GLOB_RECURSE benchmarks CONFIGURE_DEPENDS LIST_DIRECTORIES false "${CMAKE_CURRENT_SOURCE_DIR}/benchmarks/*.cpp")
+        message(STATUS "Creating benchmarks for ${parent_target}.")
+
+        # Create executable
+        add_executable(benchmark_${parent_target} ${benchmarks})
+        target_link_libraries(benchmark_${parent_target} PUBLIC ${parent_target})
+        target_link_libraries_system(benchmark_${parent_target} PRIVATE CONAN_PKG::benchmark)
+
+        # Prevent linker language errors on header only libraries.
+        set_target_properties(benchmark_${parent_target} PROPERTIES LINKER_LANGUAGE CXX)
+
+
+        # Running the benchmarks through this target stores the results as JSON, so they can be compared between runs.
+        set(results_dir "${CMAKE_SOURCE_DIR}/out/benchmarks")
+
+        add_custom_target(
+            run_benchmark_${parent_target}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${results_dir}
+            COMMAND benchmark_${parent_target}
+                --benchmark_out=${results_dir}/${parent_target}.json
+                --benchmark_out_format=json
+            DEPENDS benchmark_${parent_target}
+            WORKING_DIRECTORY ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}
+            VERBATIM
+        )
+    endif()
+endfunction()
+
+
 # Creates a filter for what symbols will be added to the symbol table of the target DLL.
 # Symbol filtering is performed using the SymbolGenerator program (https://github.com/ClawmanCat/SymbolGenerator),
 # and used to create a .def file. "argument_file" should be the path of a file containing the command line arguments for SymbolGenerator.